@@ -0,0 +1,98 @@
+#ifndef SDL_UTILS_BENCH_H
+#define SDL_UTILS_BENCH_H
+
+/*
+    Helpers shared by the benchmarks run with meson benchmark.
+
+    Every benchmark prints its results to stdout as lines of JSON, one per
+    measurement, so runs can be compared between builds. Benchmarks that
+    draw use the dummy video driver and the software renderer, which lets
+    them run on a machine without a display or GPU.
+*/
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+    Gets the current time of the performance counter in milliseconds.
+*/
+static inline double bench_now(void) {
+    return (double)SDL_GetPerformanceCounter() * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+/**
+    Gets a positive integer argument of the benchmark, or a default value if it wasn't passed.
+*/
+static inline int bench_arg(int argc, char** argv, int index, int fallback) {
+    if(index >= argc)
+        return fallback;
+
+    int value = atoi(argv[index]);
+    return value > 0 ? value : fallback;
+}
+
+/**
+    Prints the result of a measurement as a line of JSON.
+
+    \param benchmark The name of the benchmark.
+    \param name The name of the measurement.
+    \param operations The number of operations that were timed.
+    \param ms The time the operations took, in milliseconds.
+*/
+static inline void bench_report(const char* benchmark, const char* name, Uint64 operations, double ms) {
+    double ns = operations > 0 ? ms * 1000000.0 / (double)operations : 0;
+    double per_second = ms > 0 ? (double)operations * 1000.0 / ms : 0;
+
+    printf("{\"benchmark\":\"%s\",\"name\":\"%s\",\"operations\":%llu,\"ms\":%.3f,\"ns_per_op\":%.3f,\"ops_per_s\":%.1f}\n",
+           benchmark,
+           name,
+           (unsigned long long)operations,
+           ms,
+           ns,
+           per_second);
+    fflush(stdout);
+}
+
+/**
+    Initializes SDL video with the dummy driver and creates a window with a software
+    renderer. Drivers set through the environment take precedence.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+static inline SDL_bool bench_init_video(int width, int height, SDL_Window** window, SDL_Renderer** renderer) {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+
+    if(SDL_Init(SDL_INIT_VIDEO) != 0)
+        return SDL_FALSE;
+
+    *window = SDL_CreateWindow("SDL_utils benchmark", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height, 0);
+    if(*window == NULL)
+        goto error;
+
+    *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_SOFTWARE | SDL_RENDERER_TARGETTEXTURE);
+    if(*renderer == NULL) {
+        SDL_DestroyWindow(*window);
+        goto error;
+    }
+
+    return SDL_TRUE;
+
+    error:
+        SDL_Quit();
+        return SDL_FALSE;
+}
+
+/**
+    Destroys the window and renderer created by bench_init_video and shuts down SDL.
+*/
+static inline void bench_quit_video(SDL_Window* window, SDL_Renderer* renderer) {
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
+
+#endif
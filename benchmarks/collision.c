@@ -0,0 +1,139 @@
+/*
+    Measures the broad phase of the collision world with many moving bodies,
+    compared with checking every pair of boxes.
+
+    usage: bench_collision [bodies] [frames]
+
+    The bodies bounce around a square world sized so that there is about
+    one overlapping pair for every four bodies.
+*/
+
+#include "bench.h"
+
+#include <math.h>
+
+#include <su_collision.h>
+#include <su_random.h>
+
+#define MIN_SIZE 8
+#define MAX_SIZE 24
+#define MAX_SPEED 4
+#define BRUTE_FORCE_FRAMES 5
+
+static volatile int sink;
+
+// Counts the overlapping pairs by checking every pair of bodies.
+static int brute_force_pairs(CollisionWorld* world, int count) {
+    int pairs = 0;
+    for(int a = 0; a < count; a++) {
+        SDL_FRect box = collision_world_get_box(world, a);
+        for(int b = a + 1; b < count; b++) {
+            SDL_FRect other = collision_world_get_box(world, b);
+            if(collision_overlaps(&box, &other))
+                pairs++;
+        }
+    }
+    return pairs;
+}
+
+static void move_bodies(CollisionWorld* world, Vector2* velocities, int count, float size) {
+    for(int i = 0; i < count; i++) {
+        SDL_FRect box = collision_world_get_box(world, i);
+        if(box.x + velocities[i].x < 0 || box.x + box.w + velocities[i].x > size)
+            velocities[i].x = -velocities[i].x;
+        if(box.y + velocities[i].y < 0 || box.y + box.h + velocities[i].y > size)
+            velocities[i].y = -velocities[i].y;
+
+        collision_world_move(world, i, velocities[i]);
+    }
+}
+
+int main(int argc, char** argv) {
+    int count = bench_arg(argc, argv, 1, 10000);
+    int frames = bench_arg(argc, argv, 2, 600);
+
+    // Eight times the area of an average body per body.
+    float size = sqrtf((float)count * 4 * 16 * 16 * 2);
+
+    Vector2* velocities = malloc(sizeof(Vector2) * count);
+    if(velocities == NULL) {
+        fprintf(stderr, "bench_collision: not enough memory\n");
+        return 1;
+    }
+
+    CollisionWorld world;
+    collision_world_init(&world);
+
+    Random random;
+    random_seed(&random, 39);
+    for(int i = 0; i < count; i++) {
+        float width = random_range_float(&random, MIN_SIZE, MAX_SIZE);
+        float height = random_range_float(&random, MIN_SIZE, MAX_SIZE);
+        SDL_FRect box = {
+            random_range_float(&random, 0, size - width),
+            random_range_float(&random, 0, size - height),
+            width,
+            height
+        };
+
+        if(collision_world_add(&world, &box, 1, NULL) < 0) {
+            fprintf(stderr, "bench_collision: %s\n", SDL_GetError());
+            return 1;
+        }
+
+        velocities[i] = (Vector2){
+            random_range_float(&random, -MAX_SPEED, MAX_SPEED),
+            random_range_float(&random, -MAX_SPEED, MAX_SPEED)
+        };
+    }
+
+    // The first update sorts the bodies from scratch.
+    double start = bench_now();
+    int pairs = collision_world_update(&world);
+    bench_report("collision", "first_update", 1, bench_now() - start);
+
+    int expected = brute_force_pairs(&world, count);
+    if(pairs != expected) {
+        fprintf(stderr, "bench_collision: found %d pairs, expected %d\n", pairs, expected);
+        return 1;
+    }
+
+    Uint64 total_pairs = 0;
+    double update_ms = 0;
+    double move_ms = 0;
+    for(int frame = 0; frame < frames; frame++) {
+        start = bench_now();
+        move_bodies(&world, velocities, count, size);
+        double moved = bench_now();
+        pairs = collision_world_update(&world);
+        update_ms += bench_now() - moved;
+        move_ms += moved - start;
+
+        if(pairs < 0) {
+            fprintf(stderr, "bench_collision: %s\n", SDL_GetError());
+            return 1;
+        }
+        total_pairs += pairs;
+    }
+    bench_report("collision", "move", frames, move_ms);
+    bench_report("collision", "update", frames, update_ms);
+    bench_report("collision", "pairs", total_pairs, 0);
+
+    start = bench_now();
+    for(int frame = 0; frame < BRUTE_FORCE_FRAMES; frame++)
+        sink += brute_force_pairs(&world, count);
+    bench_report("collision", "brute_force_update", BRUTE_FORCE_FRAMES, bench_now() - start);
+
+    // Screen sized queries, like finding the bodies to draw.
+    int results[1024];
+    start = bench_now();
+    for(int i = 0; i < frames; i++) {
+        SDL_FRect area = { random_range_float(&random, 0, size - 640), random_range_float(&random, 0, size - 360), 640, 360 };
+        sink += collision_world_query(&world, &area, results, 1024);
+    }
+    bench_report("collision", "query", frames, bench_now() - start);
+
+    collision_world_free_resources(&world);
+    free(velocities);
+    return 0;
+}
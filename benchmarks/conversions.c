@@ -0,0 +1,74 @@
+/*
+    Compares the float to int conversions of su_math.h with fast_floor and libm.
+
+    usage: bench_conversions [values] [iterations]
+*/
+
+#include "bench.h"
+
+#include <math.h>
+
+#include <su_math.h>
+#include <su_random.h>
+
+static volatile int sink;
+
+#define BENCH_SCALAR(name, expression) \
+    do { \
+        double start = bench_now(); \
+        for(int n = 0; n < iterations; n++) { \
+            for(int i = 0; i < count; i++) { \
+                float value = values[i]; \
+                result[i] = (expression); \
+            } \
+        } \
+        bench_report("conversions", name, (Uint64)count * iterations, bench_now() - start); \
+        sink += result[count - 1]; \
+    } while(0)
+
+#define BENCH_BATCH(name, function) \
+    do { \
+        double start = bench_now(); \
+        for(int n = 0; n < iterations; n++) \
+            function(values, result, count); \
+        bench_report("conversions", name, (Uint64)count * iterations, bench_now() - start); \
+        sink += result[count - 1]; \
+    } while(0)
+
+int main(int argc, char** argv) {
+    int count = bench_arg(argc, argv, 1, 1000000);
+    int iterations = bench_arg(argc, argv, 2, 50);
+
+    float* values = malloc(sizeof(float) * count);
+    int* result = malloc(sizeof(int) * count);
+    if(values == NULL || result == NULL) {
+        fprintf(stderr, "bench_conversions: not enough memory\n");
+        return 1;
+    }
+
+    // World coordinates on a large map, where fast_floor is no longer valid.
+    Random random;
+    random_seed(&random, 32);
+    for(int i = 0; i < count; i++)
+        values[i] = random_range_float(&random, -1000000, 1000000);
+
+    BENCH_SCALAR("libm_floorf", (int)floorf(value));
+    BENCH_SCALAR("fast_floor", fast_floor(value));
+    BENCH_SCALAR("floor_to_int", floor_to_int(value));
+    BENCH_BATCH("floor_to_int_batch", floor_to_int_batch);
+
+    BENCH_SCALAR("libm_ceilf", (int)ceilf(value));
+    BENCH_SCALAR("ceil_to_int", ceil_to_int(value));
+    BENCH_BATCH("ceil_to_int_batch", ceil_to_int_batch);
+
+    BENCH_SCALAR("libm_roundf", (int)roundf(value));
+    BENCH_SCALAR("round_to_int", round_to_int(value));
+    BENCH_BATCH("round_to_int_batch", round_to_int_batch);
+
+    BENCH_SCALAR("trunc_to_int", trunc_to_int(value));
+    BENCH_BATCH("trunc_to_int_batch", trunc_to_int_batch);
+
+    free(values);
+    free(result);
+    return 0;
+}
@@ -0,0 +1,99 @@
+/*
+    Compares the throughput of Q16.16 fixed-point math with float math, both for
+    single operations over arrays and for a body update that combines them.
+
+    usage: bench_fixed [values] [iterations]
+*/
+
+#include "bench.h"
+
+#include <math.h>
+
+#include <su_math.h>
+#include <su_random.h>
+
+static volatile Sint64 sink;
+
+#define BENCH_LOOP(name, body) \
+    do { \
+        double start = bench_now(); \
+        for(int n = 0; n < iterations; n++) { \
+            for(int i = 0; i < count; i++) { \
+                body; \
+            } \
+        } \
+        bench_report("fixed", name, (Uint64)count * iterations, bench_now() - start); \
+    } while(0)
+
+int main(int argc, char** argv) {
+    int count = bench_arg(argc, argv, 1, 100000);
+    int iterations = bench_arg(argc, argv, 2, 100);
+
+    Fixed* fixed_values = malloc(sizeof(Fixed) * count);
+    Fixed* fixed_result = malloc(sizeof(Fixed) * count);
+    float* float_values = malloc(sizeof(float) * count);
+    float* float_result = malloc(sizeof(float) * count);
+    FixedVector2* fixed_positions = malloc(sizeof(FixedVector2) * count);
+    FixedVector2* fixed_velocities = malloc(sizeof(FixedVector2) * count);
+    Vector2* float_positions = malloc(sizeof(Vector2) * count);
+    Vector2* float_velocities = malloc(sizeof(Vector2) * count);
+
+    if(fixed_values == NULL || fixed_result == NULL || float_values == NULL || float_result == NULL
+        || fixed_positions == NULL || fixed_velocities == NULL || float_positions == NULL || float_velocities == NULL)
+    {
+        fprintf(stderr, "bench_fixed: not enough memory\n");
+        return 1;
+    }
+
+    Random random;
+    random_seed(&random, 33);
+
+    for(int i = 0; i < count; i++) {
+        float_values[i] = random_range_float(&random, 0, 100);
+        fixed_values[i] = fixed_from_float(float_values[i]);
+        float_positions[i] = (Vector2){ random_range_float(&random, 0, 1000), random_range_float(&random, 0, 1000) };
+        float_velocities[i] = (Vector2){ random_range_float(&random, -50, 50), random_range_float(&random, -50, 50) };
+        fixed_positions[i] = fixed_vector2_from_vector2(float_positions[i]);
+        fixed_velocities[i] = fixed_vector2_from_vector2(float_velocities[i]);
+    }
+
+    Fixed fixed_scale = fixed_from_float(1.0001f);
+    BENCH_LOOP("fixed_multiply_add", fixed_result[i] = fixed_add(fixed_multiply(fixed_values[i], fixed_scale), FIXED_ONE));
+    BENCH_LOOP("float_multiply_add", float_result[i] = float_values[i] * 1.0001f + 1);
+
+    BENCH_LOOP("fixed_divide", fixed_result[i] = fixed_divide(FIXED_ONE, fixed_values[i] | 1));
+    BENCH_LOOP("float_divide", float_result[i] = 1 / (float_values[i] + 1e-6f));
+
+    BENCH_LOOP("fixed_sqrt", fixed_result[i] = fixed_sqrt(fixed_values[i]));
+    BENCH_LOOP("float_sqrt", float_result[i] = sqrtf(float_values[i]));
+
+    BENCH_LOOP("fixed_sin", fixed_result[i] = fixed_sin(fixed_values[i]));
+    BENCH_LOOP("float_sin", float_result[i] = sinf(float_values[i]));
+
+    BENCH_LOOP("fixed_atan2", fixed_result[i] = fixed_atan2(fixed_values[i], FIXED_ONE));
+    BENCH_LOOP("float_atan2", float_result[i] = atan2f(float_values[i], 1));
+
+    Fixed fixed_delta = fixed_divide(FIXED_ONE, fixed_from_int(60));
+    Fixed fixed_turn = fixed_divide(FIXED_PI, fixed_from_int(180));
+    BENCH_LOOP("fixed_body_update",
+        fixed_velocities[i] = fixed_vector2_rotate(fixed_velocities[i], fixed_turn);
+        fixed_positions[i] = fixed_vector2_add(fixed_positions[i], fixed_vector2_scale(fixed_velocities[i], fixed_delta)));
+
+    float float_turn = 3.14159265f / 180;
+    BENCH_LOOP("float_body_update",
+        float_velocities[i] = vector2_rotate(float_velocities[i], float_turn);
+        float_positions[i] = vector2_add(float_positions[i], vector2_scale(float_velocities[i], 1 / 60.0f)));
+
+    sink = fixed_result[count - 1] + (Sint64)float_result[count - 1]
+        + fixed_positions[count - 1].x + (Sint64)float_positions[count - 1].x;
+
+    free(fixed_values);
+    free(fixed_result);
+    free(float_values);
+    free(float_result);
+    free(fixed_positions);
+    free(fixed_velocities);
+    free(float_positions);
+    free(float_velocities);
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+    Measures the cost of a single input query, like the ones gameplay code
+    makes many times every frame, inlined from su_input.h and called out of
+    line through the wrappers in input_calls.c. The difference between each
+    "inline" and "call" pair is the per-query call overhead inlining removes.
+
+    usage: bench_input [queries] [actions]
+
+    Each action is bound to two keys and a mouse button. No keys are held
+    down, so action_check has to look at every binding before it fails,
+    which is its slowest path.
+*/
+
+#include "bench.h"
+
+#include "input_calls.h"
+
+static volatile int sink;
+
+int main(int argc, char** argv) {
+    int queries = bench_arg(argc, argv, 1, 100000000);
+    int actions = bench_arg(argc, argv, 2, 32);
+
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    if(SDL_Init(SDL_INIT_VIDEO) != 0 || !input_manager_init(actions)) {
+        fprintf(stderr, "bench_input: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    for(int i = 0; i < actions; i++) {
+        action_set_key(i, SDL_SCANCODE_A + i % 26, 0);
+        action_set_key(i, SDL_SCANCODE_F1 + i % 12, 1);
+        action_set_mouse(i, SDL_BUTTON(SDL_BUTTON_LEFT + i % 3));
+    }
+
+    input_manager_update();
+
+    // mouse_moved doesn't depend on its arguments, so the compiler hoists the
+    // inlined query out of a timing loop. It's only checked against the call.
+    if(mouse_moved() != call_mouse_moved()) {
+        fprintf(stderr, "bench_input: mouse_moved differs from its out of line call\n");
+        return 1;
+    }
+
+    int count = 0;
+    double start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += key_check(SDL_SCANCODE_A + i % 26);
+    bench_report("input", "key_check_inline", queries, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += call_key_check(SDL_SCANCODE_A + i % 26);
+    bench_report("input", "key_check_call", queries, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += key_check_pressed(SDL_SCANCODE_A + i % 26);
+    bench_report("input", "key_check_pressed_inline", queries, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += call_key_check_pressed(SDL_SCANCODE_A + i % 26);
+    bench_report("input", "key_check_pressed_call", queries, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += mouse_check(SDL_BUTTON(SDL_BUTTON_LEFT + i % 3));
+    bench_report("input", "mouse_check_inline", queries, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += call_mouse_check(SDL_BUTTON(SDL_BUTTON_LEFT + i % 3));
+    bench_report("input", "mouse_check_call", queries, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += action_check(i % actions);
+    bench_report("input", "action_check_inline", queries, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += call_action_check(i % actions);
+    bench_report("input", "action_check_call", queries, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += action_check_pressed(i % actions);
+    bench_report("input", "action_check_pressed_inline", queries, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < queries; i++)
+        count += call_action_check_pressed(i % actions);
+    bench_report("input", "action_check_pressed_call", queries, bench_now() - start);
+
+    sink = count;
+
+    input_manager_free();
+    SDL_Quit();
+    return 0;
+}
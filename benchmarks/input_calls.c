@@ -0,0 +1,33 @@
+/*
+    Out of line wrappers around the input queries, used by bench_input as the
+    baseline for the inlined ones. They're in their own translation unit so
+    every query is a real call, the way it was when the queries were exported
+    functions of the library. Don't build the benchmarks with LTO, it would
+    inline these again.
+*/
+
+#include "input_calls.h"
+
+SDL_bool call_key_check(SDL_Scancode key) {
+    return key_check(key);
+}
+
+SDL_bool call_key_check_pressed(SDL_Scancode key) {
+    return key_check_pressed(key);
+}
+
+SDL_bool call_mouse_check(MouseButton button) {
+    return mouse_check(button);
+}
+
+SDL_bool call_mouse_moved(void) {
+    return mouse_moved();
+}
+
+SDL_bool call_action_check(Uint32 action) {
+    return action_check(action);
+}
+
+SDL_bool call_action_check_pressed(Uint32 action) {
+    return action_check_pressed(action);
+}
@@ -0,0 +1,13 @@
+#ifndef SDL_UTILS_BENCH_INPUT_CALLS_H
+#define SDL_UTILS_BENCH_INPUT_CALLS_H
+
+#include <su_input.h>
+
+SDL_bool call_key_check(SDL_Scancode key);
+SDL_bool call_key_check_pressed(SDL_Scancode key);
+SDL_bool call_mouse_check(MouseButton button);
+SDL_bool call_mouse_moved(void);
+SDL_bool call_action_check(Uint32 action);
+SDL_bool call_action_check_pressed(Uint32 action);
+
+#endif
@@ -0,0 +1,107 @@
+/*
+    Measures how job_parallel_for scales from one core up to every core.
+
+    usage: bench_jobs [items] [frames] [max_cores]
+
+    Each core count runs two workloads. The compute bound one does a little
+    trigonometry per item, like steering many agents. The memory bound one
+    only integrates positions, so it mostly measures memory bandwidth.
+    One core means a job system without workers, where the main thread runs
+    every batch itself.
+*/
+
+#include "bench.h"
+
+#include <math.h>
+
+#include <su_jobs.h>
+#include <su_math.h>
+#include <su_random.h>
+
+#define BATCH_SIZE 1024
+
+typedef struct Agents {
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* heading;
+} Agents;
+
+static void steer_range(int start, int end, void* data) {
+    Agents* agents = data;
+    for(int i = start; i < end; i++) {
+        float heading = agents->heading[i] + 0.01f * sinf(agents->x[i] * 0.01f + agents->y[i] * 0.02f);
+        agents->heading[i] = heading;
+        agents->vx[i] = cosf(heading);
+        agents->vy[i] = sinf(heading);
+    }
+}
+
+static void integrate_range(int start, int end, void* data) {
+    Agents* agents = data;
+    vector2_batch_add_scaled(agents->x + start, agents->y + start, agents->vx + start, agents->vy + start, 1 / 60.0f, end - start);
+}
+
+static void run(Agents* agents, int count, int frames, int cores) {
+    JobSystem jobs;
+    if(!job_system_init(&jobs, cores - 1)) {
+        fprintf(stderr, "bench_jobs: %s\n", SDL_GetError());
+        exit(1);
+    }
+
+    char name[64];
+
+    double start = bench_now();
+    for(int frame = 0; frame < frames; frame++)
+        job_parallel_for(&jobs, count, BATCH_SIZE, steer_range, agents);
+    SDL_snprintf(name, sizeof(name), "steer_%d_cores", cores);
+    bench_report("jobs", name, (Uint64)count * frames, bench_now() - start);
+
+    start = bench_now();
+    for(int frame = 0; frame < frames; frame++)
+        job_parallel_for(&jobs, count, BATCH_SIZE, integrate_range, agents);
+    SDL_snprintf(name, sizeof(name), "integrate_%d_cores", cores);
+    bench_report("jobs", name, (Uint64)count * frames, bench_now() - start);
+
+    job_system_free_resources(&jobs);
+}
+
+int main(int argc, char** argv) {
+    int count = bench_arg(argc, argv, 1, 1000000);
+    int frames = bench_arg(argc, argv, 2, 60);
+    int max_cores = bench_arg(argc, argv, 3, SDL_GetCPUCount());
+    if(max_cores > JOB_MAX_WORKERS + 1)
+        max_cores = JOB_MAX_WORKERS + 1;
+
+    Agents agents;
+    agents.x = malloc(sizeof(float) * count);
+    agents.y = malloc(sizeof(float) * count);
+    agents.vx = malloc(sizeof(float) * count);
+    agents.vy = malloc(sizeof(float) * count);
+    agents.heading = malloc(sizeof(float) * count);
+    if(agents.x == NULL || agents.y == NULL || agents.vx == NULL || agents.vy == NULL || agents.heading == NULL) {
+        fprintf(stderr, "bench_jobs: not enough memory\n");
+        return 1;
+    }
+
+    Random random;
+    random_seed(&random, 44);
+    for(int i = 0; i < count; i++) {
+        agents.x[i] = random_range_float(&random, 0, 1000);
+        agents.y[i] = random_range_float(&random, 0, 1000);
+        agents.heading[i] = random_range_float(&random, 0, 6.2831853f);
+        agents.vx[i] = 0;
+        agents.vy[i] = 0;
+    }
+
+    for(int cores = 1; cores <= max_cores; cores++)
+        run(&agents, count, frames, cores);
+
+    free(agents.x);
+    free(agents.y);
+    free(agents.vx);
+    free(agents.vy);
+    free(agents.heading);
+    return 0;
+}
@@ -0,0 +1,130 @@
+/*
+    Compares the SoA batch kernels of su_math.h with a loop over the scalar
+    Vector2 functions on the same data.
+
+    usage: bench_math [vectors] [iterations]
+*/
+
+#include "bench.h"
+
+#include <su_math.h>
+#include <su_random.h>
+
+typedef struct VectorData {
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* result;
+    Vector2* vectors;
+    Vector2* velocities;
+    int count;
+} VectorData;
+
+static volatile float sink;
+
+static void run_integrate(VectorData* data, int iterations) {
+    double start = bench_now();
+    for(int n = 0; n < iterations; n++)
+        vector2_batch_add_scaled(data->x, data->y, data->vx, data->vy, 1 / 60.0f, data->count);
+    bench_report("math", "batch_add_scaled", (Uint64)data->count * iterations, bench_now() - start);
+
+    start = bench_now();
+    for(int n = 0; n < iterations; n++) {
+        for(int i = 0; i < data->count; i++)
+            data->vectors[i] = vector2_add(data->vectors[i], vector2_scale(data->velocities[i], 1 / 60.0f));
+    }
+    bench_report("math", "scalar_add_scaled", (Uint64)data->count * iterations, bench_now() - start);
+}
+
+static void run_normalize(VectorData* data, int iterations) {
+    double start = bench_now();
+    for(int n = 0; n < iterations; n++)
+        vector2_batch_normalize(data->vx, data->vy, data->count);
+    bench_report("math", "batch_normalize", (Uint64)data->count * iterations, bench_now() - start);
+
+    start = bench_now();
+    for(int n = 0; n < iterations; n++) {
+        for(int i = 0; i < data->count; i++)
+            data->velocities[i] = vector2_normalize(data->velocities[i]);
+    }
+    bench_report("math", "scalar_normalize", (Uint64)data->count * iterations, bench_now() - start);
+}
+
+static void run_length(VectorData* data, int iterations) {
+    double start = bench_now();
+    for(int n = 0; n < iterations; n++)
+        vector2_batch_length(data->x, data->y, data->result, data->count);
+    bench_report("math", "batch_length", (Uint64)data->count * iterations, bench_now() - start);
+
+    start = bench_now();
+    for(int n = 0; n < iterations; n++) {
+        for(int i = 0; i < data->count; i++)
+            data->result[i] = vector2_length(data->vectors[i]);
+    }
+    bench_report("math", "scalar_length", (Uint64)data->count * iterations, bench_now() - start);
+}
+
+static void run_rotate(VectorData* data, int iterations) {
+    double start = bench_now();
+    for(int n = 0; n < iterations; n++)
+        vector2_batch_rotate(data->vx, data->vy, 0.01f, data->count);
+    bench_report("math", "batch_rotate", (Uint64)data->count * iterations, bench_now() - start);
+
+    start = bench_now();
+    for(int n = 0; n < iterations; n++) {
+        for(int i = 0; i < data->count; i++)
+            data->velocities[i] = vector2_rotate(data->velocities[i], 0.01f);
+    }
+    bench_report("math", "scalar_rotate", (Uint64)data->count * iterations, bench_now() - start);
+}
+
+int main(int argc, char** argv) {
+    int count = bench_arg(argc, argv, 1, 100000);
+    int iterations = bench_arg(argc, argv, 2, 200);
+
+    VectorData data;
+    data.count = count;
+    data.x = malloc(sizeof(float) * count);
+    data.y = malloc(sizeof(float) * count);
+    data.vx = malloc(sizeof(float) * count);
+    data.vy = malloc(sizeof(float) * count);
+    data.result = malloc(sizeof(float) * count);
+    data.vectors = malloc(sizeof(Vector2) * count);
+    data.velocities = malloc(sizeof(Vector2) * count);
+
+    if(data.x == NULL || data.y == NULL || data.vx == NULL || data.vy == NULL
+        || data.result == NULL || data.vectors == NULL || data.velocities == NULL)
+    {
+        fprintf(stderr, "bench_math: not enough memory\n");
+        return 1;
+    }
+
+    Random random;
+    random_seed(&random, 31);
+
+    for(int i = 0; i < count; i++) {
+        data.vectors[i] = (Vector2){ random_range_float(&random, -1000, 1000), random_range_float(&random, -1000, 1000) };
+        data.velocities[i] = (Vector2){ random_range_float(&random, -10, 10), random_range_float(&random, -10, 10) };
+        data.x[i] = data.vectors[i].x;
+        data.y[i] = data.vectors[i].y;
+        data.vx[i] = data.velocities[i].x;
+        data.vy[i] = data.velocities[i].y;
+    }
+
+    run_integrate(&data, iterations);
+    run_normalize(&data, iterations);
+    run_length(&data, iterations);
+    run_rotate(&data, iterations);
+
+    sink = data.x[count - 1] + data.vectors[count - 1].x + data.result[count - 1] + data.velocities[count - 1].y;
+
+    free(data.x);
+    free(data.y);
+    free(data.vx);
+    free(data.vy);
+    free(data.result);
+    free(data.vectors);
+    free(data.velocities);
+    return 0;
+}
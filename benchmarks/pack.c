@@ -0,0 +1,172 @@
+/*
+    Compares loading the files of a game at startup from a pack against
+    opening each one as a loose file.
+
+    usage: bench_pack [files] [file_size] [iterations]
+
+    The files are written to the current directory and removed afterwards.
+    They stay in the page cache between iterations, so the results show the
+    cost of opening and finding files rather than of reading the disk.
+*/
+
+#include "bench.h"
+
+#include <stdio.h>
+
+#include <su_pack.h>
+#include <su_random.h>
+
+#define PACK_FILE "bench_pack.pak"
+#define PACK_COMPRESSED_FILE "bench_pack_lz4.pak"
+
+static void file_name(char* name, size_t size, int index) {
+    SDL_snprintf(name, size, "bench_pack_%04d.bin", index);
+}
+
+// Fills a file with runs of repeated bytes broken up by noise, so compression has something to work with.
+static void fill_data(Random* random, Uint8* data, int size) {
+    int i = 0;
+    while(i < size) {
+        int run = random_range(random, 1, 32);
+        Uint8 value = (Uint8)random_next_u32(random);
+        for(int j = 0; j < run && i < size; j++)
+            data[i++] = random_range(random, 0, 7) == 0 ? (Uint8)random_next_u32(random) : value;
+    }
+}
+
+static SDL_bool write_files(int count, int size) {
+    Uint8* data = malloc(size);
+    if(data == NULL) {
+        SDL_SetError("not enough memory");
+        return SDL_FALSE;
+    }
+
+    PackWriter writer;
+    PackWriter compressed;
+    pack_writer_init(&writer);
+    pack_writer_init(&compressed);
+
+    Random random;
+    random_seed(&random, 42);
+
+    char name[64];
+    SDL_bool result = SDL_FALSE;
+    for(int i = 0; i < count; i++) {
+        fill_data(&random, data, size);
+        file_name(name, sizeof(name), i);
+
+        SDL_RWops* file = SDL_RWFromFile(name, "wb");
+        if(file == NULL)
+            goto done;
+
+        size_t written = SDL_RWwrite(file, data, size, 1);
+        SDL_RWclose(file);
+        if(written != 1)
+            goto done;
+
+        if(!pack_writer_add(&writer, name, data, size, SDL_FALSE) || !pack_writer_add(&compressed, name, data, size, SDL_TRUE))
+            goto done;
+    }
+
+    SDL_RWops* output = SDL_RWFromFile(PACK_FILE, "wb");
+    if(output == NULL)
+        goto done;
+    SDL_bool saved = pack_writer_save(&writer, output, PACK_DEFAULT_ALIGNMENT);
+    SDL_RWclose(output);
+    if(!saved)
+        goto done;
+
+    output = SDL_RWFromFile(PACK_COMPRESSED_FILE, "wb");
+    if(output == NULL)
+        goto done;
+    saved = pack_writer_save(&compressed, output, PACK_DEFAULT_ALIGNMENT);
+    SDL_RWclose(output);
+    result = saved;
+
+    done:
+        pack_writer_free_resources(&writer);
+        pack_writer_free_resources(&compressed);
+        free(data);
+        return result;
+}
+
+static void remove_files(int count) {
+    char name[64];
+    for(int i = 0; i < count; i++) {
+        file_name(name, sizeof(name), i);
+        remove(name);
+    }
+    remove(PACK_FILE);
+    remove(PACK_COMPRESSED_FILE);
+}
+
+static SDL_bool load_loose(int count, Uint8* buffer) {
+    char name[64];
+    for(int i = 0; i < count; i++) {
+        file_name(name, sizeof(name), i);
+        SDL_RWops* file = SDL_RWFromFile(name, "rb");
+        if(file == NULL)
+            return SDL_FALSE;
+
+        Sint64 size = SDL_RWsize(file);
+        size_t read = SDL_RWread(file, buffer, (size_t)size, 1);
+        SDL_RWclose(file);
+        if(read != 1)
+            return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static SDL_bool load_pack(const char* path, int count, Uint8* buffer) {
+    Pack pack;
+    if(!pack_open(&pack, path))
+        return SDL_FALSE;
+
+    char name[64];
+    SDL_bool result = SDL_TRUE;
+    for(int i = 0; i < count && result; i++) {
+        file_name(name, sizeof(name), i);
+        int index = pack_find(&pack, name);
+        result = index >= 0 && pack_read(&pack, index, buffer);
+    }
+
+    pack_close(&pack);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    int count = bench_arg(argc, argv, 1, 1000);
+    int size = bench_arg(argc, argv, 2, 16384);
+    int iterations = bench_arg(argc, argv, 3, 10);
+
+    Uint8* buffer = malloc(size);
+    if(buffer == NULL || !write_files(count, size)) {
+        fprintf(stderr, "bench_pack: could not write the files: %s\n", SDL_GetError());
+        remove_files(count);
+        return 1;
+    }
+
+    SDL_bool loaded = SDL_TRUE;
+
+    double start = bench_now();
+    for(int n = 0; n < iterations && loaded; n++)
+        loaded = load_loose(count, buffer);
+    bench_report("pack", "loose_files", (Uint64)count * iterations, bench_now() - start);
+
+    start = bench_now();
+    for(int n = 0; n < iterations && loaded; n++)
+        loaded = load_pack(PACK_FILE, count, buffer);
+    bench_report("pack", "pack", (Uint64)count * iterations, bench_now() - start);
+
+    start = bench_now();
+    for(int n = 0; n < iterations && loaded; n++)
+        loaded = load_pack(PACK_COMPRESSED_FILE, count, buffer);
+    bench_report("pack", "pack_lz4", (Uint64)count * iterations, bench_now() - start);
+
+    if(!loaded)
+        fprintf(stderr, "bench_pack: could not load the files: %s\n", SDL_GetError());
+
+    remove_files(count);
+    free(buffer);
+    return loaded ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/*
+    Measures how many headless scene updates a SceneBatch runs per second,
+    stepping the scenes one after the other and on every core.
+
+    usage: bench_scene_batch [scenes] [animations] [timers] [runs]
+
+    Each scene plays a number of looping animations and runs a number of
+    repeating timers, which are the parts of a scene that scene_update_fixed
+    advances without an update system. Every run steps each scene through one
+    second of 16 ms ticks.
+*/
+
+#include "bench.h"
+
+#include <su_random.h>
+#include <su_scene.h>
+
+#define STEP_MS 16
+#define STEPS_PER_RUN 60
+#define FRAME_COUNT 4
+
+typedef struct BatchScene {
+    Scene scene;
+    Animator animator;
+    Uint64 fired;
+} BatchScene;
+
+static void on_timer(Scheduler* scheduler, ScheduleHandle handle, void* data) {
+    BatchScene* batch_scene = data;
+    batch_scene->fired += random_next(&batch_scene->scene.random) & 1;
+}
+
+static SDL_bool batch_scene_init(BatchScene* batch_scene, int animations, int timers, Uint64 seed) {
+    scene_init(&batch_scene->scene, (EcsWorld){ 0 }, NULL, NULL, NULL, NULL, SDL_FALSE, SDL_FALSE);
+    batch_scene->scene.free_world = SDL_FALSE;
+    scene_seed_random(&batch_scene->scene, seed);
+    batch_scene->fired = 0;
+
+    // Headless animators only track frames, so the regions don't have to exist.
+    animator_init(&batch_scene->animator, NULL);
+    AtlasRegionId frames[FRAME_COUNT] = { 0, 1, 2, 3 };
+    AnimationClipId clip = animator_add_clip(&batch_scene->animator, frames, FRAME_COUNT, 0.1f, ANIMATION_LOOP);
+    if(clip == ANIMATION_CLIP_INVALID)
+        return SDL_FALSE;
+
+    Random* random = scene_get_random(&batch_scene->scene);
+    for(int i = 0; i < animations; i++) {
+        if(animator_play(&batch_scene->animator, clip, random_range_float(random, 0.5f, 2), NULL) == ANIMATION_ID_INVALID)
+            return SDL_FALSE;
+    }
+    scene_set_animator(&batch_scene->scene, &batch_scene->animator);
+
+    Scheduler* scheduler = scene_get_scheduler(&batch_scene->scene);
+    for(int i = 0; i < timers; i++) {
+        Uint32 period = (Uint32)random_range(random, STEP_MS, 1000);
+        if(scheduler_add(scheduler, period, period, on_timer, batch_scene) == SCHEDULE_HANDLE_INVALID)
+            return SDL_FALSE;
+    }
+
+    return SDL_TRUE;
+}
+
+static void batch_scene_free_resources(BatchScene* batch_scene) {
+    scene_free_resources(&batch_scene->scene);
+    animator_free_resources(&batch_scene->animator);
+}
+
+static void run(const char* name, BatchScene* scenes, int count, JobSystem* jobs, int runs) {
+    SceneBatch batch;
+    scene_batch_init(&batch, jobs);
+
+    for(int i = 0; i < count; i++) {
+        if(!scene_batch_add(&batch, &scenes[i].scene)) {
+            fprintf(stderr, "bench_scene_batch: %s\n", SDL_GetError());
+            exit(1);
+        }
+    }
+
+    for(int i = 0; i < runs; i++)
+        scene_batch_run(&batch, STEP_MS / 1000.0f, STEP_MS, STEPS_PER_RUN);
+
+    bench_report("scene_batch", name, batch.ticks, batch.seconds * 1000);
+    scene_batch_free_resources(&batch);
+}
+
+int main(int argc, char** argv) {
+    int count = bench_arg(argc, argv, 1, 256);
+    int animations = bench_arg(argc, argv, 2, 256);
+    int timers = bench_arg(argc, argv, 3, 64);
+    int runs = bench_arg(argc, argv, 4, 10);
+
+    BatchScene* scenes = malloc(sizeof(BatchScene) * count);
+    if(scenes == NULL) {
+        fprintf(stderr, "bench_scene_batch: not enough memory\n");
+        return 1;
+    }
+
+    for(int i = 0; i < count; i++) {
+        if(!batch_scene_init(&scenes[i], animations, timers, (Uint64)i + 46)) {
+            fprintf(stderr, "bench_scene_batch: could not create scene %d: %s\n", i, SDL_GetError());
+            return 1;
+        }
+    }
+
+    JobSystem jobs;
+    if(!job_system_init(&jobs, -1)) {
+        fprintf(stderr, "bench_scene_batch: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    printf("{\"benchmark\":\"scene_batch\",\"scenes\":%d,\"animations\":%d,\"timers\":%d,\"workers\":%d}\n",
+           count,
+           animations,
+           timers,
+           job_system_get_worker_count(&jobs));
+
+    run("ticks_serial", scenes, count, NULL, runs);
+    run("ticks_parallel", scenes, count, &jobs, runs);
+
+    job_system_free_resources(&jobs);
+    for(int i = 0; i < count; i++)
+        batch_scene_free_resources(&scenes[i]);
+    free(scenes);
+    return 0;
+}
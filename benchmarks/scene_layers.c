@@ -0,0 +1,246 @@
+/*
+    Measures the throughput of scene_update and scene_draw with the software
+    renderer for a scene drawn through parallax layers.
+
+    usage: bench_scene_layers [sprites] [layers] [frames]
+
+    The bottom layer draws a tilemap four screens wide that the camera scrolls
+    across, so visible chunks are copied from their cache and new ones are baked
+    as they come into view. The scene plays an animation for every sprite, which
+    is advanced by scene_update. The sprites are split between the other layers,
+    which are invalidated every frame, so each one clears its full screen target,
+    draws its share of the sprites and is copied to the camera.
+
+    The scene has no ECS sprite_layers, so the cost of dispatching MystEcs sprite_layers
+    isn't part of the measurement. The stage timings of the scene are written
+    with scene_write_stats.
+*/
+
+#include "bench.h"
+
+#include <su_scene.h>
+#include <su_tilemap.h>
+
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+#define SPRITE_SIZE 16
+#define FRAME_COUNT 4
+#define TILE_SIZE 16
+#define TILE_KINDS 4
+#define CHUNK_SIZE 16
+#define MAP_SCREENS 4
+#define SCROLL_SPEED 4
+
+typedef struct SpriteLayer {
+    Animator* animator;
+    AnimationId* sprites;
+    Point* positions;
+    Point* velocities;
+    int first;
+    int count;
+    int* frame;
+} SpriteLayer;
+
+static void sprite_layer_draw(SDL_Renderer* renderer, ParallaxLayer* layer, void* data) {
+    SpriteLayer* sprite_layer = data;
+    int frame = *sprite_layer->frame;
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    for(int i = sprite_layer->first; i < sprite_layer->first + sprite_layer->count; i++) {
+        Point position = sprite_layer->positions[i];
+        Point velocity = sprite_layer->velocities[i];
+        Rectangle dst = {
+            (position.x + velocity.x * frame) % (SCREEN_WIDTH - SPRITE_SIZE),
+            (position.y + velocity.y * frame) % (SCREEN_HEIGHT - SPRITE_SIZE),
+            SPRITE_SIZE,
+            SPRITE_SIZE
+        };
+
+        animator_draw(sprite_layer->animator, sprite_layer->sprites[i], &dst);
+    }
+}
+
+typedef struct TilemapLayer {
+    Tilemap* tilemap;
+    Camera* camera;
+} TilemapLayer;
+
+static void tilemap_layer_draw(SDL_Renderer* renderer, ParallaxLayer* layer, void* data) {
+    TilemapLayer* tilemap_layer = data;
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    tilemap_draw(tilemap_layer->tilemap, tilemap_layer->camera);
+}
+
+static Tilemap* create_tilemap(SDL_Renderer* renderer, Texture** tileset) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, TILE_SIZE * TILE_KINDS, TILE_SIZE, 32, TILEMAP_CHUNK_FORMAT);
+    if(surface == NULL)
+        return NULL;
+
+    for(int i = 0; i < TILE_KINDS; i++) {
+        Rectangle tile = { i * TILE_SIZE, 0, TILE_SIZE, TILE_SIZE };
+        SDL_FillRect(surface, &tile, SDL_MapRGBA(surface->format, 32 + 48 * i, 96, 160 - 32 * i, 255));
+    }
+
+    *tileset = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if(*tileset == NULL)
+        return NULL;
+
+    int width = SCREEN_WIDTH * MAP_SCREENS / TILE_SIZE;
+    int height = SCREEN_HEIGHT / TILE_SIZE;
+    Tilemap* tilemap = tilemap_create(*tileset, TILE_SIZE, TILE_SIZE, width, height, 1, CHUNK_SIZE);
+    if(tilemap == NULL)
+        return NULL;
+
+    for(int y = 0; y < height; y++) {
+        for(int x = 0; x < width; x++) {
+            if(!tilemap_set_tile(tilemap, 0, x, y, 1 + (x * 7 + y * 3) % TILE_KINDS)) {
+                tilemap_free(tilemap);
+                return NULL;
+            }
+        }
+    }
+
+    return tilemap;
+}
+
+static AnimationClipId create_clip(Animator* animator, TextureAtlas* atlas) {
+    AtlasRegionId frames[FRAME_COUNT];
+
+    for(int i = 0; i < FRAME_COUNT; i++) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, SPRITE_SIZE, SPRITE_SIZE, 32, ATLAS_PIXEL_FORMAT);
+        if(surface == NULL)
+            return ANIMATION_CLIP_INVALID;
+
+        SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 64 * i, 255 - 64 * i, 128, 255));
+        frames[i] = atlas_add(atlas, surface);
+        SDL_FreeSurface(surface);
+
+        if(frames[i] == ATLAS_REGION_INVALID)
+            return ANIMATION_CLIP_INVALID;
+    }
+
+    return animator_add_clip(animator, frames, FRAME_COUNT, 0.1f, ANIMATION_LOOP);
+}
+
+int main(int argc, char** argv) {
+    int sprite_count = bench_arg(argc, argv, 1, 10000);
+    int layer_count = bench_arg(argc, argv, 2, 8);
+    int frame_count = bench_arg(argc, argv, 3, 300);
+
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    if(!bench_init_video(SCREEN_WIDTH, SCREEN_HEIGHT, &window, &renderer)) {
+        fprintf(stderr, "bench_scene_layers: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    Rectangle viewport = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    Camera* camera = camera_create(renderer, SCREEN_WIDTH, SCREEN_HEIGHT, &viewport, SDL_PIXELFORMAT_RGBA8888);
+    TextureAtlas* atlas = atlas_create(renderer, 256, 1024, 1);
+    Animator* animator = animator_create(atlas);
+    Parallax* parallax = parallax_create();
+    AnimationId* sprites = malloc(sizeof(*sprites) * sprite_count);
+    Point* positions = malloc(sizeof(*positions) * sprite_count);
+    Point* velocities = malloc(sizeof(*velocities) * sprite_count);
+    SpriteLayer* sprite_layers = malloc(sizeof(*sprite_layers) * layer_count);
+    Texture* tileset = NULL;
+    Tilemap* tilemap = create_tilemap(renderer, &tileset);
+
+    if(camera == NULL || atlas == NULL || animator == NULL || parallax == NULL || tilemap == NULL
+        || sprites == NULL || positions == NULL || velocities == NULL || sprite_layers == NULL)
+    {
+        fprintf(stderr, "bench_scene_layers: could not create the scene: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    AnimationClipId clip = create_clip(animator, atlas);
+    if(clip == ANIMATION_CLIP_INVALID) {
+        fprintf(stderr, "bench_scene_layers: could not create the animation: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    Random random;
+    random_seed(&random, 1);
+
+    for(int i = 0; i < sprite_count; i++) {
+        sprites[i] = animator_play(animator, clip, random_range_float(&random, 0.5f, 2), NULL);
+        positions[i] = (Point){ random_range(&random, 0, SCREEN_WIDTH), random_range(&random, 0, SCREEN_HEIGHT) };
+        velocities[i] = (Point){ random_range(&random, 1, 4), random_range(&random, 1, 4) };
+    }
+
+    TilemapLayer tilemap_layer = { tilemap, camera };
+    if(parallax_add_layer(parallax, SCREEN_WIDTH, SCREEN_HEIGHT, (Vector2){ 0, 0 }, SDL_FALSE, SDL_FALSE, tilemap_layer_draw, &tilemap_layer) == -1) {
+        fprintf(stderr, "bench_scene_layers: could not create the tilemap layer: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    int frame = 0;
+    for(int i = 0; i < layer_count; i++) {
+        int first = (int)((Sint64)sprite_count * i / layer_count);
+        int last = (int)((Sint64)sprite_count * (i + 1) / layer_count);
+        sprite_layers[i] = (SpriteLayer){ animator, sprites, positions, velocities, first, last - first, &frame };
+
+        if(parallax_add_layer(parallax, SCREEN_WIDTH, SCREEN_HEIGHT, (Vector2){ 0, 0 }, SDL_FALSE, SDL_FALSE, sprite_layer_draw, sprite_layers + i) == -1) {
+            fprintf(stderr, "bench_scene_layers: could not create the sprite layers: %s\n", SDL_GetError());
+            return 1;
+        }
+    }
+
+    // The scene doesn't use a world, so an empty one is passed and never freed.
+    Scene scene;
+    scene_init(&scene, (EcsWorld){ 0 }, camera, NULL, NULL, NULL, SDL_FALSE, SDL_TRUE);
+    scene.free_world = SDL_FALSE;
+    scene_set_parallax(&scene, parallax);
+    scene_set_animator(&scene, animator);
+
+    // Warm up so the layer targets and atlas pages are created outside of the measurement.
+    scene_update(&scene, 1 / 60.0f);
+    scene_draw(&scene, 1 / 60.0f);
+    scene_reset_stats(&scene);
+
+    int scroll_range = SCREEN_WIDTH * (MAP_SCREENS - 1);
+    for(frame = 0; frame < frame_count; frame++) {
+        camera_set_position(camera, (Point){ frame * SCROLL_SPEED % scroll_range, 0 });
+        for(int i = 0; i <= layer_count; i++)
+            parallax_invalidate(parallax, i);
+
+        scene_update(&scene, 1 / 60.0f);
+        scene_draw(&scene, 1 / 60.0f);
+    }
+
+    printf("{\"benchmark\":\"scene_layers\",\"sprites\":%d,\"tiles\":%d,\"layers\":%d,\"frames\":%d}\n",
+           sprite_count,
+           tilemap->width * tilemap->height,
+           layer_count + 1,
+           frame_count);
+    fflush(stdout);
+
+    SDL_RWops* output = SDL_RWFromFP(stdout, SDL_FALSE);
+    SDL_bool written = output != NULL && scene_write_stats(&scene, output);
+    if(output != NULL)
+        SDL_RWclose(output);
+
+    scene_free_resources(&scene);
+    parallax_free(parallax);
+    tilemap_free(tilemap);
+    SDL_DestroyTexture(tileset);
+    animator_free(animator);
+    atlas_free(atlas);
+    free(sprites);
+    free(positions);
+    free(velocities);
+    free(sprite_layers);
+    bench_quit_video(window, renderer);
+
+    if(!written) {
+        fprintf(stderr, "bench_scene_layers: could not write the stats: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+/*
+    Compares running many gameplay timers with the Scheduler against polling
+    a TimerUtil for each one every frame.
+
+    usage: bench_scheduler [timers] [frames]
+
+    Every timer repeats with a random period between 100 ms and 5 s. The
+    scheduler is advanced by 16 ms per frame, while the polled timers follow
+    the real clock, so the polling loop fires fewer timers than the scheduler
+    and its results are a lower bound on its cost.
+*/
+
+#include "bench.h"
+
+#include <su_random.h>
+#include <su_scheduler.h>
+
+#define FRAME_MS 16
+#define MIN_PERIOD 100
+#define MAX_PERIOD 5000
+
+static Uint64 fired = 0;
+
+static void count_fire(Scheduler* scheduler, ScheduleHandle handle, void* data) {
+    fired++;
+}
+
+static void run_scheduler(Uint32* periods, int count, int frames) {
+    Scheduler scheduler;
+    scheduler_init(&scheduler);
+
+    double start = bench_now();
+    for(int i = 0; i < count; i++) {
+        if(scheduler_add(&scheduler, periods[i], periods[i], count_fire, NULL) == SCHEDULE_HANDLE_INVALID) {
+            fprintf(stderr, "bench_scheduler: %s\n", SDL_GetError());
+            exit(1);
+        }
+    }
+    bench_report("scheduler", "scheduler_add", count, bench_now() - start);
+
+    fired = 0;
+    start = bench_now();
+    for(int frame = 0; frame < frames; frame++)
+        scheduler_advance(&scheduler, FRAME_MS);
+    bench_report("scheduler", "scheduler_frame", frames, bench_now() - start);
+    bench_report("scheduler", "scheduler_fired", fired, 0);
+
+    scheduler_free_resources(&scheduler);
+}
+
+static void run_churn(Uint32* periods, int count) {
+    Scheduler scheduler;
+    scheduler_init(&scheduler);
+
+    ScheduleHandle* handles = malloc(sizeof(ScheduleHandle) * count);
+    if(handles == NULL) {
+        fprintf(stderr, "bench_scheduler: not enough memory\n");
+        exit(1);
+    }
+
+    // Timers that are cancelled before they fire, like a cooldown that gets reset.
+    double start = bench_now();
+    for(int n = 0; n < 10; n++) {
+        for(int i = 0; i < count; i++)
+            handles[i] = scheduler_add(&scheduler, periods[i], 0, count_fire, NULL);
+        for(int i = 0; i < count; i++)
+            scheduler_cancel(&scheduler, handles[i]);
+    }
+    bench_report("scheduler", "scheduler_add_cancel", (Uint64)count * 10, bench_now() - start);
+
+    free(handles);
+    scheduler_free_resources(&scheduler);
+}
+
+static void run_polling(Uint32* periods, int count, int frames) {
+    TimerUtil* timers = malloc(sizeof(TimerUtil) * count);
+    if(timers == NULL) {
+        fprintf(stderr, "bench_scheduler: not enough memory\n");
+        exit(1);
+    }
+
+    for(int i = 0; i < count; i++) {
+        timer_init(&timers[i]);
+        timer_start(&timers[i]);
+    }
+
+    fired = 0;
+    double start = bench_now();
+    for(int frame = 0; frame < frames; frame++) {
+        for(int i = 0; i < count; i++) {
+            if(timer_ticks(&timers[i]) >= periods[i]) {
+                fired++;
+                timer_start(&timers[i]);
+            }
+        }
+    }
+    bench_report("scheduler", "polling_frame", frames, bench_now() - start);
+    bench_report("scheduler", "polling_fired", fired, 0);
+
+    free(timers);
+}
+
+int main(int argc, char** argv) {
+    int count = bench_arg(argc, argv, 1, 100000);
+    int frames = bench_arg(argc, argv, 2, 600);
+
+    if(SDL_Init(SDL_INIT_TIMER) != 0) {
+        fprintf(stderr, "bench_scheduler: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    Uint32* periods = malloc(sizeof(Uint32) * count);
+    if(periods == NULL) {
+        fprintf(stderr, "bench_scheduler: not enough memory\n");
+        return 1;
+    }
+
+    Random random;
+    random_seed(&random, 36);
+    for(int i = 0; i < count; i++)
+        periods[i] = (Uint32)random_range(&random, MIN_PERIOD, MAX_PERIOD);
+
+    run_scheduler(periods, count, frames);
+    run_churn(periods, count);
+    run_polling(periods, count, frames);
+
+    free(periods);
+    SDL_Quit();
+    return 0;
+}
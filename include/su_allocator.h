@@ -0,0 +1,199 @@
+#ifndef SDL_UTILS_ALLOCATOR_H
+#define SDL_UTILS_ALLOCATOR_H
+
+#include <SDL.h>
+#include "su_utils.h"
+
+/**
+    The alignment of every pointer returned by the allocators in this file.
+*/
+#define ALLOCATOR_ALIGNMENT 16
+
+/**
+    Counts the memory traffic that goes through an allocator.
+*/
+typedef struct AllocatorStats {
+    /**
+        The number of successful allocations, including reallocations.
+    */
+    Uint64 allocations;
+
+    /**
+        The number of times memory was freed.
+    */
+    Uint64 frees;
+
+    /**
+        The number of allocations that failed.
+    */
+    Uint64 failures;
+
+    /**
+        The total number of bytes that were requested.
+    */
+    Uint64 bytes_allocated;
+
+    /**
+        The number of bytes that are currently allocated.
+    */
+    size_t bytes_in_use;
+
+    /**
+        The largest value bytes_in_use has reached.
+    */
+    size_t high_water;
+} AllocatorStats;
+
+/**
+    A bump-pointer allocator for memory that only lives for a single frame.
+    Allocating is just an aligned pointer increment, freeing does nothing
+    (except for the most recent allocation), and frame_arena_reset releases
+    everything at once.
+
+    Pass &arena->allocator to anything that takes an Allocator.
+
+    \remark An arena is not thread-safe, so only use it from one thread at a time.
+             Give a scene an arena with scene_set_frame_arena to have it reset
+             at the end of every scene_draw, otherwise call frame_arena_reset yourself.
+*/
+typedef struct FrameArena {
+    Allocator allocator;
+    Allocator* backing;
+    Uint8* buffer;
+    size_t capacity;
+    size_t offset;
+    size_t last_offset;
+    AllocatorStats stats;
+} FrameArena;
+
+/**
+    Hands out fixed-size blocks from a preallocated buffer in O(1) using a free list.
+    Allocations larger than the block size fail.
+
+    Pass &pool->allocator to anything that takes an Allocator.
+
+    \remark A pool is not thread-safe, so only use it from one thread at a time.
+*/
+typedef struct PoolAllocator {
+    Allocator allocator;
+    Allocator* backing;
+    Uint8* buffer;
+    void* free_list;
+    size_t block_size;
+    size_t block_count;
+    AllocatorStats stats;
+} PoolAllocator;
+
+/**
+    Wraps another allocator and counts everything that goes through it.
+    Each allocation gets a small header to remember its size.
+
+    To measure the library itself, install it before anything is allocated:
+    su_set_allocator(tracking_allocator_init(&tracker, su_get_allocator())).
+
+    The stats are guarded by a lock, so a tracker can be installed as the
+    library allocator while the job system and asset loader are running,
+    as long as its backing allocator is thread-safe too.
+    Read the stats with tracking_allocator_get_stats.
+*/
+typedef struct TrackingAllocator {
+    Allocator allocator;
+    Allocator* backing;
+    AllocatorStats stats;
+    SDL_SpinLock lock;
+} TrackingAllocator;
+
+/**
+    Initializes a FrameArena allocated by the caller.
+
+    \param arena The arena to initialize.
+    \param backing The allocator used to allocate the arena memory, or NULL
+                   to use the current library allocator.
+    \param capacity The number of bytes the arena can hand out each frame.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool frame_arena_init(FrameArena* arena, Allocator* backing, size_t capacity);
+
+/**
+    Frees the memory of the arena. Everything allocated from it becomes invalid.
+*/
+void frame_arena_free_resources(FrameArena* arena);
+
+/**
+    Releases every allocation made from the arena. Call once per frame.
+*/
+static inline void frame_arena_reset(FrameArena* arena);
+
+/**
+    Allocates memory from the arena. Returns NULL when the arena is full.
+*/
+static inline void* frame_arena_alloc(FrameArena* arena, size_t size);
+
+/**
+    Initializes a PoolAllocator allocated by the caller.
+
+    \param pool The pool to initialize.
+    \param backing The allocator used to allocate the pool memory, or NULL
+                   to use the current library allocator.
+    \param block_size The size of every block. Rounded up to ALLOCATOR_ALIGNMENT.
+    \param block_count The number of blocks in the pool.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool pool_allocator_init(PoolAllocator* pool, Allocator* backing, size_t block_size, size_t block_count);
+
+/**
+    Frees the memory of the pool. Every block becomes invalid.
+*/
+void pool_allocator_free_resources(PoolAllocator* pool);
+
+/**
+    Initializes a TrackingAllocator that forwards to another allocator.
+
+    \param tracker The tracker to initialize.
+    \param backing The allocator to forward to, or NULL to use the current
+                   library allocator.
+    \return The allocator interface of the tracker.
+*/
+Allocator* tracking_allocator_init(TrackingAllocator* tracker, Allocator* backing);
+
+/**
+    Gets a copy of the stats of a tracker that is safe to take while other
+    threads allocate through it.
+*/
+AllocatorStats tracking_allocator_get_stats(TrackingAllocator* tracker);
+
+/**
+    Resets the allocation counters of a tracker while other threads may be
+    allocating through it.
+
+    \see allocator_stats_reset
+*/
+void tracking_allocator_reset_stats(TrackingAllocator* tracker);
+
+/**
+    Resets the allocation counters of a stats object, keeping bytes_in_use.
+    The high water mark is reset to the current usage.
+*/
+static inline void allocator_stats_reset(AllocatorStats* stats);
+
+static inline void frame_arena_reset(FrameArena* arena) {
+    if(arena->offset > 0)
+        arena->stats.frees++;
+    arena->offset = 0;
+    arena->last_offset = 0;
+    arena->stats.bytes_in_use = 0;
+}
+
+static inline void* frame_arena_alloc(FrameArena* arena, size_t size) {
+    return arena->allocator.malloc(arena, size);
+}
+
+static inline void allocator_stats_reset(AllocatorStats* stats) {
+    stats->allocations = 0;
+    stats->frees = 0;
+    stats->failures = 0;
+    stats->bytes_allocated = 0;
+    stats->high_water = stats->bytes_in_use;
+}
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef SDL_UTILS_ANIMATION_H
+#define SDL_UTILS_ANIMATION_H
+
+#include <SDL.h>
+
+#include "su_atlas.h"
+#include "su_utils.h"
+
+/**
+    Identifies a playing animation. Handles of stopped animations
+    are never reused, so they are always safe to stop.
+*/
+typedef Uint64 AnimationId;
+
+#define ANIMATION_ID_INVALID ((AnimationId)0)
+
+/**
+    Identifies a clip added to an Animator.
+*/
+typedef int AnimationClipId;
+
+#define ANIMATION_CLIP_INVALID -1
+
+/**
+    The event sent when an animation that doesn't loop reaches its last frame.
+    Events set on frames with animator_set_frame_event should be positive.
+*/
+#define ANIMATION_EVENT_FINISHED -1
+
+typedef struct Animator Animator;
+
+/**
+    A function called when an animation reaches a frame that has an event, or
+    when it finishes. It's safe to play, change and stop animations from inside it.
+*/
+typedef void (*AnimationEventFn)(Animator* animator, AnimationId id, int event, void* data);
+
+typedef enum AnimationMode {
+    /**
+        Stops on the last frame, or the first one when playing backwards.
+    */
+    ANIMATION_ONCE,
+
+    /**
+        Starts over after the last frame.
+    */
+    ANIMATION_LOOP
+} AnimationMode;
+
+/**
+    A sequence of atlas regions shown one after the other.
+*/
+typedef struct AnimationClip {
+    /**
+        The index of the first frame in the frames of the animator.
+    */
+    int first;
+    int count;
+    float frame_duration;
+    AnimationMode mode;
+    SDL_bool has_events;
+} AnimationClip;
+
+/**
+    Plays a large number of sprite animations. The playback state is stored
+    as parallel arrays indexed by slot, so every animation is advanced in
+    batches with a single pass, and the current atlas region of each one is
+    ready for the draw system to read.
+*/
+struct Animator {
+    TextureAtlas* atlas;
+
+    AnimationClip* clips;
+    int clip_count;
+    int clip_capacity;
+
+    /**
+        The atlas regions of every clip, one after the other.
+    */
+    AtlasRegionId* frames;
+
+    /**
+        The event of each frame in frames, or 0 if it doesn't have one.
+    */
+    int* frame_events;
+    int frame_count;
+    int frame_capacity;
+
+    /**
+        The position of each animation in its clip, measured in frames.
+    */
+    float* position;
+
+    /**
+        The number of frames each animation advances by per unit of time,
+        with its speed applied. 0 for paused and unused slots.
+    */
+    float* rate;
+
+    /**
+        The number of frames in the clip of each animation, and its inverse.
+    */
+    float* length;
+    float* inv_length;
+
+    /**
+        1 for animations that loop, 0 otherwise.
+    */
+    float* loop;
+
+    float* speed;
+    int* frame;
+    int* previous;
+    AtlasRegionId* region;
+    AnimationClipId* clip;
+    Uint32* generation;
+    Uint8* flags;
+    void** data;
+    int slot_count;
+    int slot_capacity;
+    int free_list;
+    int active;
+
+    AnimationEventFn on_event;
+};
+
+/**
+    Initializes an animator.
+
+    \param animator The animator to initialize.
+    \param atlas The atlas that contains the frames of every clip.
+*/
+void animator_init(Animator* animator, TextureAtlas* atlas);
+
+/**
+    Allocates and initializes an animator. Returns NULL on failure.
+*/
+Animator* animator_create(TextureAtlas* atlas);
+
+/**
+    Stops every animation, removes every clip, and frees the resources
+    used by the animator without freeing the animator itself.
+*/
+void animator_free_resources(Animator* animator);
+
+/**
+    Frees the resources used by the animator, then frees the animator itself.
+    Only use if the animator was allocated with animator_create.
+*/
+void animator_free(Animator* animator);
+
+/**
+    Adds a clip to the animator.
+
+    \param animator The animator to add the clip to.
+    \param frames The atlas regions of the frames, in order. Copied into the animator.
+    \param count The number of frames.
+    \param frame_duration How long each frame is shown, in the same units passed to animator_update.
+    \param mode Determines what happens after the last frame.
+    \return The id of the clip, or ANIMATION_CLIP_INVALID on failure.
+            Get the error using SDL_GetError.
+*/
+AnimationClipId animator_add_clip(Animator* animator, const AtlasRegionId* frames, int count, float frame_duration, AnimationMode mode);
+
+/**
+    Marks a frame of a clip to send an event when an animation reaches it.
+
+    \param event The event to send, or 0 to remove it.
+    \return SDL_TRUE on success, SDL_FALSE if the clip or frame doesn't exist.
+*/
+SDL_bool animator_set_frame_event(Animator* animator, AnimationClipId clip, int frame, int event);
+
+/**
+    Sets the function called for the events of every animation. Can be NULL.
+*/
+static inline void animator_set_event_callback(Animator* animator, AnimationEventFn on_event);
+
+/**
+    Starts playing a clip from its first frame, or its last when the speed is negative.
+
+    \param animator The animator that plays the animation.
+    \param clip The clip to play.
+    \param speed Multiplies the rate of the clip. Negative values play it backwards.
+    \param data User data passed to the event callback.
+    \return The id of the animation, or ANIMATION_ID_INVALID on failure.
+            Get the error using SDL_GetError.
+*/
+AnimationId animator_play(Animator* animator, AnimationClipId clip, float speed, void* data);
+
+/**
+    Switches a playing animation to another clip, starting from its first
+    frame, while keeping its speed and user data.
+
+    \return SDL_TRUE on success, SDL_FALSE if the animation or clip doesn't exist.
+*/
+SDL_bool animator_set_clip(Animator* animator, AnimationId id, AnimationClipId clip);
+
+/**
+    Stops an animation. Returns SDL_FALSE if it had already been stopped.
+*/
+SDL_bool animator_stop(Animator* animator, AnimationId id);
+
+/**
+    Determines if an animation is still playing, even if it has finished.
+*/
+SDL_bool animator_is_playing(Animator* animator, AnimationId id);
+
+/**
+    Sets the speed of an animation. A speed of 0 pauses it.
+*/
+SDL_bool animator_set_speed(Animator* animator, AnimationId id, float speed);
+
+/**
+    Gets the index of the current frame of an animation in its clip, or -1 if it was stopped.
+*/
+int animator_get_frame(Animator* animator, AnimationId id);
+
+/**
+    Determines if an animation that doesn't loop has reached its end.
+*/
+SDL_bool animator_finished(Animator* animator, AnimationId id);
+
+/**
+    Gets the atlas region of the current frame of an animation, to use as the
+    source rect when drawing it. The texture is NULL if the animation was stopped.
+*/
+AtlasRegion animator_get_region(Animator* animator, AnimationId id);
+
+/**
+    Draws the current frame of an animation.
+
+    \return 0 on success, or a negative error code on failure. Get the error using SDL_GetError.
+*/
+int animator_draw(Animator* animator, AnimationId id, const Rectangle* dst);
+
+/**
+    Advances every animation and updates their current frames, then sends the
+    events of the frames that were reached. When an animation passes through
+    several frames in one update, the events of each of them are sent in order.
+*/
+void animator_update(Animator* animator, float delta);
+
+/**
+    Gets the number of playing animations.
+*/
+static inline int animator_get_count(Animator* animator);
+
+static inline void animator_set_event_callback(Animator* animator, AnimationEventFn on_event) {
+    animator->on_event = on_event;
+}
+
+static inline int animator_get_count(Animator* animator) {
+    return animator->active;
+}
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef SDL_UTILS_ASSETS_H
+#define SDL_UTILS_ASSETS_H
+
+#include <SDL.h>
+
+#include "su_data_types.h"
+#include "su_utils.h"
+
+#define ASSET_CACHE_MAX_WORKERS 8
+
+/**
+    Decodes the image at a path. Called from a worker thread, so it must not
+    use the renderer. Returns NULL on failure.
+*/
+typedef SDL_Surface* (*AssetDecodeFn)(const char* path, void* data);
+
+typedef enum AssetState {
+    /**
+        The image is waiting to be decoded, or is being decoded.
+    */
+    ASSET_LOADING,
+
+    /**
+        The image has been decoded and uploaded.
+    */
+    ASSET_READY,
+
+    /**
+        The image could not be decoded.
+    */
+    ASSET_FAILED
+} AssetState;
+
+/**
+    A cached image. Get one with asset_cache_load and give it
+    back with asset_cache_release.
+*/
+typedef struct Asset {
+    char* path;
+    Uint32 hash;
+    AssetState state;
+    int references;
+
+    /**
+        The uploaded image. NULL while loading, or when the texture was evicted
+        while nothing referenced the asset.
+    */
+    Texture* texture;
+
+    /**
+        The decoded pixels, kept after uploading while the RAM budget allows
+        so an evicted texture can be restored without decoding again.
+    */
+    SDL_Surface* surface;
+
+    int width;
+    int height;
+    size_t vram_size;
+    size_t ram_size;
+
+    struct Asset* hash_next;
+    struct Asset* lru_prev;
+    struct Asset* lru_next;
+    struct Asset* queue_next;
+} Asset;
+
+/**
+    Loads images by path, shares them between their users, and keeps
+    unused ones around until the memory budget runs out.
+
+    Decoding happens on a pool of worker threads, while textures are created
+    on the thread that calls asset_cache_update, which must be the thread that
+    owns the renderer. Every other function must be called from that thread as well.
+
+    \remark To keep shared assets alive across scene_change, load the assets
+            of the next scene before the previous scene releases its own.
+*/
+typedef struct AssetCache {
+    SDL_Renderer* renderer;
+    AssetDecodeFn decode;
+    void* decode_data;
+
+    Asset** buckets;
+    int bucket_count;
+    int asset_count;
+
+    /**
+        Every asset, from the most recently used to the least recently used.
+    */
+    Asset* lru_head;
+    Asset* lru_tail;
+
+    size_t vram_used;
+    size_t vram_budget;
+    size_t ram_used;
+    size_t ram_budget;
+    int loading;
+
+    SDL_Thread* workers[ASSET_CACHE_MAX_WORKERS];
+    int worker_count;
+    SDL_mutex* mutex;
+    SDL_cond* cond;
+    Asset* jobs_head;
+    Asset* jobs_tail;
+    Asset* decoded;
+    SDL_bool quit;
+} AssetCache;
+
+/**
+    Initializes an asset cache.
+
+    \param cache The cache to initialize.
+    \param renderer The renderer used to create textures.
+    \param worker_count The number of threads that decode images, up to
+                        ASSET_CACHE_MAX_WORKERS. With 0, images are decoded
+                        by asset_cache_update instead.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool asset_cache_init(AssetCache* cache, SDL_Renderer* renderer, int worker_count);
+
+/**
+    Allocates and initializes an asset cache. Returns NULL on failure.
+
+    \see asset_cache_init
+*/
+AssetCache* asset_cache_create(SDL_Renderer* renderer, int worker_count);
+
+/**
+    Stops the workers and frees every asset, whether it's still referenced or
+    not, without freeing the cache itself.
+*/
+void asset_cache_free_resources(AssetCache* cache);
+
+/**
+    Frees the resources used by the cache, then frees the cache itself.
+    Only use if the cache was allocated with asset_cache_create.
+*/
+void asset_cache_free(AssetCache* cache);
+
+/**
+    Sets the function used to decode images. Defaults to SDL_LoadBMP.
+    Must be called before any asset is loaded.
+*/
+void asset_cache_set_decoder(AssetCache* cache, AssetDecodeFn decode, void* data);
+
+/**
+    Sets how much memory the cache tries to stay under. Only assets that
+    nothing references have their textures evicted, but the decoded copy of any
+    uploaded asset can be dropped. Defaults to an unlimited VRAM budget
+    and a RAM budget of 0, which drops every decoded copy once it's uploaded.
+
+    \param cache The cache to change.
+    \param vram_budget The number of bytes the textures can use.
+    \param ram_budget The number of bytes the decoded copies of the images can use.
+*/
+void asset_cache_set_budget(AssetCache* cache, size_t vram_budget, size_t ram_budget);
+
+/**
+    Gets an asset, adding a reference to it. If the image isn't cached
+    yet, it starts decoding in the background and the asset stays in
+    the ASSET_LOADING state until an asset_cache_update after it's done.
+
+    \return The asset, or NULL if there wasn't enough memory.
+            Get the error using SDL_GetError.
+*/
+Asset* asset_cache_load(AssetCache* cache, const char* path);
+
+/**
+    Removes a reference from an asset. Unreferenced assets stay
+    cached until they're evicted to meet the memory budget.
+*/
+void asset_cache_release(AssetCache* cache, Asset* asset);
+
+/**
+    Uploads the images that finished decoding, then evicts
+    assets until the cache is within its budget. Call once per frame.
+*/
+void asset_cache_update(AssetCache* cache);
+
+/**
+    Blocks until every asset that is loading is ready or failed.
+    Useful for loading screens.
+*/
+void asset_cache_finish(AssetCache* cache);
+
+/**
+    Gets the texture of an asset, or NULL if it isn't ready.
+*/
+static inline Texture* asset_get_texture(Asset* asset);
+
+/**
+    Gets the current state of an asset.
+*/
+static inline AssetState asset_get_state(Asset* asset);
+
+static inline Texture* asset_get_texture(Asset* asset) {
+    return asset->texture;
+}
+
+static inline AssetState asset_get_state(Asset* asset) {
+    return asset->state;
+}
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef SDL_UTILS_ATLAS_H
+#define SDL_UTILS_ATLAS_H
+
+#include <SDL.h>
+#include "su_data_types.h"
+#include "su_utils.h"
+
+/**
+    The pixel format used by the atlas pages.
+*/
+#define ATLAS_PIXEL_FORMAT SDL_PIXELFORMAT_ARGB8888
+
+/**
+    A handle to an image stored in a TextureAtlas. Returned when the image
+    is added, and stays valid until the atlas is freed, even when the atlas
+    is rebuilt.
+*/
+typedef int AtlasRegionId;
+
+#define ATLAS_REGION_INVALID -1
+
+/**
+    The location of an image inside of a TextureAtlas.
+
+    \remark The texture and rect of a region change when the atlas is
+            rebuilt, so get the region from its id each time you draw
+            instead of storing it.
+*/
+typedef struct AtlasRegion {
+    /**
+        The page texture that contains the image.
+    */
+    Texture* texture;
+
+    /**
+        The bounds of the image inside of the texture.
+    */
+    Rectangle rect;
+} AtlasRegion;
+
+/**
+    A segment of the skyline used to pack images into an atlas page.
+*/
+typedef struct AtlasSkylineNode {
+    int x;
+    int y;
+    int width;
+} AtlasSkylineNode;
+
+/**
+    A single texture of an atlas, along with the data needed to pack more
+    images into it.
+*/
+typedef struct AtlasPage {
+    /**
+        The texture that is drawn from.
+    */
+    Texture* texture;
+
+    /**
+        A copy of the page pixels, used to rebuild and save the atlas.
+    */
+    SDL_Surface* surface;
+
+    /**
+        The top edge of the packed images, from left to right.
+    */
+    AtlasSkylineNode* skyline;
+    int skyline_count;
+    int skyline_capacity;
+} AtlasPage;
+
+/**
+    Packs many small images into a few large textures so they can be drawn
+    without switching textures.
+
+    You should never alter the fields of the atlas directly, instead
+    use the provided functions to do so.
+*/
+typedef struct TextureAtlas {
+    /**
+        The renderer used to create the page textures.
+    */
+    SDL_Renderer* renderer;
+
+    /**
+        The textures that make up the atlas.
+    */
+    AtlasPage* pages;
+    int page_count;
+    int page_capacity;
+
+    /**
+        The current size of every page. Grows up to max_page_size when the atlas overflows.
+    */
+    int page_size;
+
+    /**
+        The largest size a page can grow to before new pages are added instead.
+    */
+    int max_page_size;
+
+    /**
+        The number of empty pixels between packed images.
+    */
+    int padding;
+
+    /**
+        The location of every image in the atlas, indexed by AtlasRegionId.
+    */
+    AtlasRegion* regions;
+
+    /**
+        The page index of every image in the atlas, indexed by AtlasRegionId.
+    */
+    int* region_pages;
+    int region_count;
+    int region_capacity;
+
+    /**
+        Incremented every time the atlas is rebuilt, which moves the existing
+        regions. Lets caches of texture coordinates tell when they're stale.
+    */
+    int generation;
+} TextureAtlas;
+
+/**
+    Initializes a TextureAtlas allocated by the caller.
+
+    \param atlas The atlas to initialize.
+    \param renderer The renderer used to create the page textures.
+    \param page_size The starting width and height of each page.
+    \param max_page_size The size that pages can grow to when the atlas overflows.
+                         Should be no larger than the max texture size of the renderer.
+    \param padding The number of empty pixels between packed images, to avoid
+                   bleeding when the images are scaled.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool atlas_init(TextureAtlas* atlas, SDL_Renderer* renderer, int page_size, int max_page_size, int padding);
+
+/**
+    Allocates and initializes a new TextureAtlas.
+
+    \param renderer The renderer used to create the page textures.
+    \param page_size The starting width and height of each page.
+    \param max_page_size The size that pages can grow to when the atlas overflows.
+                         Should be no larger than the max texture size of the renderer.
+    \param padding The number of empty pixels between packed images, to avoid
+                   bleeding when the images are scaled.
+    \return Allocated atlas on success, NULL otherwise. Get the error using SDL_GetError.
+*/
+TextureAtlas* atlas_create(SDL_Renderer* renderer, int page_size, int max_page_size, int padding);
+
+/**
+    Frees the resources used by the atlas, without freeing the atlas itself.
+*/
+void atlas_free_resources(TextureAtlas* atlas);
+
+/**
+    Frees the resources used by the atlas, then frees the atlas.
+*/
+void atlas_free(TextureAtlas* atlas);
+
+/**
+    Copies an image into the atlas. If the image doesn't fit, the atlas is
+    rebuilt with larger pages, or a new page is added once the pages can't
+    grow anymore.
+
+    \param atlas The atlas to add the image to.
+    \param surface The image to add. It's copied, so it can be freed afterwards.
+    \return The id of the image in the atlas, or ATLAS_REGION_INVALID on failure.
+            Get the error using SDL_GetError.
+*/
+AtlasRegionId atlas_add(TextureAtlas* atlas, SDL_Surface* surface);
+
+/**
+    Repacks every image in the atlas into pages of the specified size,
+    tallest images first. Region ids stay the same.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. On failure the atlas
+            is left unchanged.
+*/
+SDL_bool atlas_rebuild(TextureAtlas* atlas, int page_size);
+
+/**
+    Gets the location of an image in the atlas.
+*/
+static inline AtlasRegion atlas_get_region(TextureAtlas* atlas, AtlasRegionId id);
+
+/**
+    Gets the number of images in the atlas.
+*/
+static inline int atlas_get_region_count(TextureAtlas* atlas);
+
+/**
+    Gets the number of textures used by the atlas.
+*/
+static inline int atlas_get_page_count(TextureAtlas* atlas);
+
+/**
+    Gets the number of times the atlas has been rebuilt.
+*/
+static inline int atlas_get_generation(TextureAtlas* atlas);
+
+/**
+    Draws an image from the atlas to the current render target.
+*/
+static inline int atlas_draw(TextureAtlas* atlas, AtlasRegionId id, const Rectangle* dst);
+
+/**
+    Writes the packed pages and regions to a file, so the atlas can be
+    loaded without packing the images again.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool atlas_save(TextureAtlas* atlas, const char* file);
+
+/**
+    Initializes an atlas from a file written by atlas_save.
+    Images can still be added to the atlas afterwards.
+
+    \param atlas The atlas to initialize.
+    \param renderer The renderer used to create the page textures.
+    \param file The file to read.
+    \param max_page_size The size that pages can grow to when the atlas overflows.
+    \param padding The number of empty pixels between images added afterwards.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool atlas_load(TextureAtlas* atlas, SDL_Renderer* renderer, const char* file, int max_page_size, int padding);
+
+static inline AtlasRegion atlas_get_region(TextureAtlas* atlas, AtlasRegionId id) {
+    return atlas->regions[id];
+}
+
+static inline int atlas_get_region_count(TextureAtlas* atlas) {
+    return atlas->region_count;
+}
+
+static inline int atlas_get_page_count(TextureAtlas* atlas) {
+    return atlas->page_count;
+}
+
+static inline int atlas_get_generation(TextureAtlas* atlas) {
+    return atlas->generation;
+}
+
+static inline int atlas_draw(TextureAtlas* atlas, AtlasRegionId id, const Rectangle* dst) {
+    AtlasRegion region = atlas->regions[id];
+    return SDL_RenderCopy(atlas->renderer, region.texture, &region.rect, dst);
+}
+
+#endif
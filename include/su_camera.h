@@ -5,6 +5,11 @@
 #include "su_data_types.h"
 #include "su_utils.h"
 
+/**
+    The smallest fraction of the render target a camera can draw to.
+*/
+#define CAMERA_MIN_RENDER_SCALE 0.25f
+
 /**
     Defines a 2D camera that controls the view into the game world.
 
@@ -41,6 +46,13 @@ typedef struct Camera {
         The pixel format used by this camera and its render_target.
     */
     Uint32 pixel_format;
+
+    /**
+        The fraction of the render target that is drawn to on each axis.
+        The drawn area is stretched over the whole viewport, so a smaller
+        scale trades sharpness for fill rate without reallocating the target.
+    */
+    float render_scale;
 } Camera;
 
 /**
@@ -134,6 +146,25 @@ SDL_bool camera_set_width(Camera* camera, int width);
 */
 SDL_bool camera_set_height(Camera* camera, int height);
 
+/**
+    Sets the fraction of the render target that scene_draw renders the camera into,
+    between CAMERA_MIN_RENDER_SCALE and 1. Takes effect the next time the scene draws.
+
+    \remark The view into the game world stays the same, so the coordinates
+            used for drawing and camera_screen_to_world are unaffected.
+*/
+static inline void camera_set_render_scale(Camera* camera, float scale);
+
+/**
+    Gets the fraction of the render target that is drawn to.
+*/
+static inline float camera_get_render_scale(Camera* camera);
+
+/**
+    Gets the size in pixels of the area of the render target that is drawn to.
+*/
+static inline Point camera_get_render_size(Camera* camera);
+
 /**
     Sets the cameras rotation in degrees.
 */
@@ -230,6 +261,27 @@ static inline void camera_set_y(Camera* camera, int y) {
     camera->view.y = y;
 }
 
+static inline void camera_set_render_scale(Camera* camera, float scale) {
+    if(scale < CAMERA_MIN_RENDER_SCALE)
+        scale = CAMERA_MIN_RENDER_SCALE;
+    else if(scale > 1)
+        scale = 1;
+
+    camera->render_scale = scale;
+}
+
+static inline float camera_get_render_scale(Camera* camera) {
+    return camera->render_scale;
+}
+
+static inline Point camera_get_render_size(Camera* camera) {
+    // Round up so the edge pixels that are partially drawn to are still shown.
+    return (Point) {
+        (int)((float)camera->view.w * camera->render_scale + 0.999f),
+        (int)((float)camera->view.h * camera->render_scale + 0.999f)
+    };
+}
+
 static inline void camera_set_rotation(Camera* camera, double degrees) {
     camera->rotation = degrees;
 }
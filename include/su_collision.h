@@ -0,0 +1,243 @@
+#ifndef SDL_UTILS_COLLISION_H
+#define SDL_UTILS_COLLISION_H
+
+#include <SDL.h>
+
+#include "su_data_types.h"
+#include "su_tilemap.h"
+#include "su_utils.h"
+
+/**
+    The sides of a box that were blocked when moving it through a tilemap.
+*/
+typedef enum CollisionSide {
+    COLLISION_NONE = 0,
+    COLLISION_LEFT = 1,
+    COLLISION_RIGHT = 2,
+    COLLISION_TOP = 4,
+    COLLISION_BOTTOM = 8
+} CollisionSide;
+
+/**
+    Two bodies whose boxes overlap. a is always less than b.
+*/
+typedef struct CollisionPair {
+    int a;
+    int b;
+} CollisionPair;
+
+/**
+    Determines if a tile blocks movement.
+*/
+typedef SDL_bool (*TileSolidFn)(TileId tile, void* data);
+
+/**
+    Stores axis aligned bounding boxes and finds every overlapping pair
+    using sweep and prune along the x axis.
+
+    The boxes are kept sorted by their left edge. Since bodies only move
+    a little between frames, the order is repaired with an insertion sort,
+    which takes close to linear time.
+*/
+typedef struct CollisionWorld {
+    float* min_x;
+    float* min_y;
+    float* max_x;
+    float* max_y;
+    Uint32* mask;
+    void** data;
+    Uint8* alive;
+    int* free_list;
+    int free_count;
+    int body_count;
+    int body_capacity;
+
+    /**
+        The living bodies, sorted by min_x once the world is sorted.
+    */
+    int* order;
+    int order_count;
+
+    /**
+        The widest box in the world, which limits how far back a query has to look.
+    */
+    float max_width;
+    SDL_bool dirty;
+
+    CollisionPair* pairs;
+    int pair_count;
+    int pair_capacity;
+} CollisionWorld;
+
+/**
+    Initializes a collision world.
+*/
+void collision_world_init(CollisionWorld* world);
+
+/**
+    Allocates and initializes a collision world. Returns NULL on failure.
+*/
+CollisionWorld* collision_world_create(void);
+
+/**
+    Frees the resources used by the world without freeing the world itself.
+*/
+void collision_world_free_resources(CollisionWorld* world);
+
+/**
+    Frees the resources used by the world, then frees the world itself.
+    Only use if the world was allocated with collision_world_create.
+*/
+void collision_world_free(CollisionWorld* world);
+
+/**
+    Adds a body to the world.
+
+    \param world The world to add the body to.
+    \param box The bounds of the body.
+    \param mask Two bodies are only reported as a pair if their masks share a bit.
+    \param data User data associated with the body.
+    \return The id of the body, or -1 on failure. Get the error using SDL_GetError.
+            Ids are reused after a body is removed.
+*/
+int collision_world_add(CollisionWorld* world, const SDL_FRect* box, Uint32 mask, void* data);
+
+/**
+    Removes a body from the world.
+*/
+void collision_world_remove(CollisionWorld* world, int body);
+
+/**
+    Changes the bounds of a body.
+*/
+static inline void collision_world_set_box(CollisionWorld* world, int body, const SDL_FRect* box);
+
+/**
+    Moves a body by an offset.
+*/
+static inline void collision_world_move(CollisionWorld* world, int body, Vector2 offset);
+
+/**
+    Gets the bounds of a body.
+*/
+static inline SDL_FRect collision_world_get_box(CollisionWorld* world, int body);
+
+/**
+    Gets the user data associated with a body.
+*/
+static inline void* collision_world_get_data(CollisionWorld* world, int body);
+
+/**
+    Finds every pair of bodies whose boxes overlap. Boxes that only
+    touch at an edge don't overlap.
+
+    \return The number of pairs found, or -1 if there wasn't enough memory
+            to store them. Get the pairs with collision_world_get_pairs.
+*/
+int collision_world_update(CollisionWorld* world);
+
+/**
+    Gets the pairs found by the last call to collision_world_update.
+*/
+static inline CollisionPair* collision_world_get_pairs(CollisionWorld* world, int* count);
+
+/**
+    Finds every body that overlaps an area.
+
+    \param world The world to search.
+    \param area The area to search.
+    \param results Filled with the ids of the bodies that were found.
+    \param max_results The number of ids results can hold.
+    \return The total number of bodies found, which can be larger than max_results.
+*/
+int collision_world_query(CollisionWorld* world, const SDL_FRect* area, int* results, int max_results);
+
+/**
+    Finds the first body a moving body would hit.
+
+    \param world The world to search.
+    \param body The moving body. It's never reported as hitting itself.
+    \param motion How far the body is moving.
+    \param time Set to the fraction of the motion before the hit.
+    \param normal Set to the surface normal of the hit. Can be NULL.
+    \return The id of the body that was hit, or -1 if nothing was hit.
+*/
+int collision_world_sweep(CollisionWorld* world, int body, Vector2 motion, float* time, Vector2* normal);
+
+/**
+    Determines if two boxes overlap. Boxes that only touch at an edge don't overlap.
+*/
+static inline SDL_bool collision_overlaps(const SDL_FRect* a, const SDL_FRect* b);
+
+/**
+    Finds when a moving box first touches a stationary box.
+
+    \param box The moving box.
+    \param motion How far the box is moving.
+    \param target The stationary box.
+    \param time Set to the fraction of the motion before the boxes touch,
+                or 0 if they already overlap.
+    \param normal Set to the surface normal of the target where it was hit,
+                  or zero if the boxes already overlap. Can be NULL.
+    \return SDL_TRUE if the boxes touch during the motion, SDL_FALSE otherwise.
+*/
+SDL_bool collision_sweep(const SDL_FRect* box, Vector2 motion, const SDL_FRect* target, float* time, Vector2* normal);
+
+/**
+    Moves a box through a tilemap, stopping it against solid tiles.
+    Each axis is resolved separately, x first, so the box slides along walls.
+    Every tile crossed by the motion is checked, so fast boxes can't tunnel
+    through thin walls.
+
+    \param tilemap The tilemap to move through. The box is in world coordinates,
+                   where each tile is tile_width by tile_height pixels.
+    \param layer The layer of the tilemap that contains the solid tiles.
+    \param box The box to move. Updated with the new position.
+    \param motion How far to move the box.
+    \param solid Determines if a tile is solid. If NULL, every tile other than TILE_EMPTY is solid.
+    \param data User data passed to solid.
+    \return The sides of the box that were blocked, as a combination of CollisionSide flags.
+*/
+int collision_move_on_tilemap(Tilemap* tilemap, int layer, SDL_FRect* box, Vector2 motion, TileSolidFn solid, void* data);
+
+static inline void collision_world_set_box(CollisionWorld* world, int body, const SDL_FRect* box) {
+    world->min_x[body] = box->x;
+    world->min_y[body] = box->y;
+    world->max_x[body] = box->x + box->w;
+    world->max_y[body] = box->y + box->h;
+    if(box->w > world->max_width)
+        world->max_width = box->w;
+    world->dirty = SDL_TRUE;
+}
+
+static inline void collision_world_move(CollisionWorld* world, int body, Vector2 offset) {
+    world->min_x[body] += offset.x;
+    world->min_y[body] += offset.y;
+    world->max_x[body] += offset.x;
+    world->max_y[body] += offset.y;
+    world->dirty = SDL_TRUE;
+}
+
+static inline SDL_FRect collision_world_get_box(CollisionWorld* world, int body) {
+    return (SDL_FRect){
+        world->min_x[body],
+        world->min_y[body],
+        world->max_x[body] - world->min_x[body],
+        world->max_y[body] - world->min_y[body]
+    };
+}
+
+static inline void* collision_world_get_data(CollisionWorld* world, int body) {
+    return world->data[body];
+}
+
+static inline CollisionPair* collision_world_get_pairs(CollisionWorld* world, int* count) {
+    *count = world->pair_count;
+    return world->pairs;
+}
+
+static inline SDL_bool collision_overlaps(const SDL_FRect* a, const SDL_FRect* b) {
+    return a->x < b->x + b->w && b->x < a->x + a->w && a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+#endif
@@ -27,42 +27,104 @@ typedef enum SDL_GameControllerButtonExtension {
 */
 typedef Uint32 MouseButton;
 
+#define INPUT_MAX_GAMEPADS 16
+#define INPUT_ACTION_KEY_COUNT 2
+
+#define INPUT_GAMEPAD_BUTTON(x) (1 << (x))
+
+/**
+    The names the macros above had before the input manager state moved into
+    this header. Kept so code using them still compiles, prefer the INPUT_ names.
+*/
+#ifndef MAX_GAMEPADS
+#define MAX_GAMEPADS INPUT_MAX_GAMEPADS
+#endif
+
+#ifndef ACTION_KEY_COUNT
+#define ACTION_KEY_COUNT INPUT_ACTION_KEY_COUNT
+#endif
+
+#ifndef GAMEPAD_BUTTON
+#define GAMEPAD_BUTTON(x) INPUT_GAMEPAD_BUTTON(x)
+#endif
+
+typedef struct Gamepad {
+    SDL_GameController* controller;
+    Uint32 button_current;
+    Uint32 button_previous;
+    SDL_bool active;
+} Gamepad;
+
+typedef struct GamepadAction {
+    Uint32 button;
+    int index;
+} GamepadAction;
+
+typedef struct ActionMap {
+    SDL_Scancode keys[INPUT_ACTION_KEY_COUNT];
+    GamepadAction button[INPUT_ACTION_KEY_COUNT];
+    MouseButton mouse;
+    SDL_bool active;
+} ActionMap;
+
+/**
+    The state of the input manager. It's only visible so the input queries
+    can be inlined into the code that calls them every frame. Don't modify it,
+    use the functions in this file instead.
+*/
+typedef struct InputManager {
+    MouseButton mouse_current;
+    MouseButton mouse_previous;
+    SDL_Point mouse_position_current;
+    SDL_Point mouse_position_previous;
+    const Uint8* keyboard_current;
+    const Uint8* keyboard_previous;
+    Gamepad gamepads[INPUT_MAX_GAMEPADS];
+    int controllers[INPUT_MAX_GAMEPADS];
+    int controller_count;
+    Uint16 deadzone;
+    ActionMap* maps;
+    int action_count;
+} InputManager;
+
+extern InputManager input_manager;
+
 /**
     Checks if the specified key is currently down.
 */
-SDL_bool key_check(SDL_Scancode key);
+static inline SDL_bool key_check(SDL_Scancode key);
 
 /**
     Checks if the specfied key has just been pressed during the last update.
 */
-SDL_bool key_check_pressed(SDL_Scancode key);
+static inline SDL_bool key_check_pressed(SDL_Scancode key);
 
 /**
     Checks if the specified key has just been released during the last update.
 */
-SDL_bool key_check_released(SDL_Scancode key);
+static inline SDL_bool key_check_released(SDL_Scancode key);
 
 /**
     Checks if the specified button is currently down.
 */
-SDL_bool mouse_check(MouseButton button);
+static inline SDL_bool mouse_check(MouseButton button);
 
 /**
     Checks if the specified button has just been pressed during
     the last update.
 */
-SDL_bool mouse_check_pressed(MouseButton button);
+static inline SDL_bool mouse_check_pressed(MouseButton button);
 
 /**
     Checks if the specified button has just been released during
     the last update.
 */
-SDL_bool mouse_check_released(MouseButton button);
+static inline SDL_bool mouse_check_released(MouseButton button);
 
 /**
     Checks if the mouse has moved at all during the last frame.
 */
-SDL_bool mouse_moved(void);
+static inline SDL_bool mouse_moved(void);
 
 /**
     Checks if the specified button is currently down.
@@ -70,7 +132,7 @@ SDL_bool mouse_moved(void);
     \param index The gamepad index retrieved from the SDL_ControllerDeviceEvent,
                  or -1. If it's -1, it will use the first controller plugged in.
 */
-SDL_bool gamepad_check_index(Uint32 button, int index);
+static inline SDL_bool gamepad_check_index(Uint32 button, int index);
 
 /**
     Checks if the specified button has just been pressed during
@@ -79,7 +141,7 @@ SDL_bool gamepad_check_index(Uint32 button, int index);
     \param index The gamepad index retrieved from the SDL_ControllerDeviceEvent,
                  or -1. If it's -1, it will use the first controller plugged in.
 */
-SDL_bool gamepad_check_pressed_index(Uint32 button, int index);
+static inline SDL_bool gamepad_check_pressed_index(Uint32 button, int index);
 
 /**
     Checks if the specified button has just been released during
@@ -88,7 +150,7 @@ SDL_bool gamepad_check_pressed_index(Uint32 button, int index);
     \param index The gamepad index retrieved from the SDL_ControllerDeviceEvent,
                  or -1. If it's -1, it will use the first controller plugged in.
 */
-SDL_bool gamepad_check_released_index(Uint32 button, int index);
+static inline SDL_bool gamepad_check_released_index(Uint32 button, int index);
 
 /**
     Gets the axis value of a controller stick, between
@@ -183,21 +245,21 @@ void action_set_mouse(Uint32 action, MouseButton button);
 
     \param The action id to check.
 */
-SDL_bool action_check(Uint32 action);
+static inline SDL_bool action_check(Uint32 action);
 
 /**
     Checks if any of the inputs bound to the action were just pressed.
 
     \param The action id to check.
 */
-SDL_bool action_check_pressed(Uint32 action);
+static inline SDL_bool action_check_pressed(Uint32 action);
 
 /**
     Checks if any of the inputs bound to the action were just released.
 
     \param The action id to check.
 */
-SDL_bool action_check_released(Uint32 action);
+static inline SDL_bool action_check_released(Uint32 action);
 
 /**
     Initializes the input manager with the specified amount of actions.
@@ -231,4 +293,125 @@ void input_manager_event(SDL_ControllerDeviceEvent* event);
 */
 void input_manager_free(void);
 
+static inline SDL_bool key_check(SDL_Scancode key) {
+    return input_manager.keyboard_current[key] == 1;
+}
+
+static inline SDL_bool key_check_pressed(SDL_Scancode key) {
+    return input_manager.keyboard_current[key] == 1 && input_manager.keyboard_previous[key] == 0;
+}
+
+static inline SDL_bool key_check_released(SDL_Scancode key) {
+    return input_manager.keyboard_current[key] == 0 && input_manager.keyboard_previous[key] == 1;
+}
+
+static inline SDL_bool mouse_check(MouseButton button) {
+    return (input_manager.mouse_current & button) == button;
+}
+
+static inline SDL_bool mouse_check_pressed(MouseButton button) {
+    return ((input_manager.mouse_current & button) == button) && ((input_manager.mouse_previous & button) != button);
+}
+
+static inline SDL_bool mouse_check_released(MouseButton button) {
+    return ((input_manager.mouse_current & button) != button) && ((input_manager.mouse_previous & button) == button);
+}
+
+static inline SDL_bool mouse_moved(void) {
+    return input_manager.mouse_position_current.x != input_manager.mouse_position_previous.x ||
+           input_manager.mouse_position_current.y != input_manager.mouse_position_previous.y;
+}
+
+static inline SDL_bool gamepad_check_index(Uint32 button, int index) {
+    if(index == -1)
+        index = input_manager.controllers[0];
+
+    if(index < 0 || index >= INPUT_MAX_GAMEPADS || !input_manager.gamepads[index].active)
+        return SDL_FALSE;
+
+    return (input_manager.gamepads[index].button_current & INPUT_GAMEPAD_BUTTON(button)) != 0;
+}
+
+static inline SDL_bool gamepad_check_pressed_index(Uint32 button, int index) {
+    if(index == -1)
+        index = input_manager.controllers[0];
+
+    if(index < 0 || index >= INPUT_MAX_GAMEPADS || !input_manager.gamepads[index].active)
+        return SDL_FALSE;
+
+    return (input_manager.gamepads[index].button_current & INPUT_GAMEPAD_BUTTON(button)) != 0 &&
+           (input_manager.gamepads[index].button_previous & INPUT_GAMEPAD_BUTTON(button)) == 0;
+}
+
+static inline SDL_bool gamepad_check_released_index(Uint32 button, int index) {
+    if(index == -1)
+        index = input_manager.controllers[0];
+
+    if(index < 0 || index >= INPUT_MAX_GAMEPADS || !input_manager.gamepads[index].active)
+        return SDL_FALSE;
+
+    return (input_manager.gamepads[index].button_current & INPUT_GAMEPAD_BUTTON(button)) == 0 &&
+           (input_manager.gamepads[index].button_previous & INPUT_GAMEPAD_BUTTON(button)) != 0;
+}
+
+static inline SDL_bool action_check(Uint32 action) {
+    if(action >= (Uint32)input_manager.action_count)
+        return SDL_FALSE;
+
+    const ActionMap* map = input_manager.maps + action;
+
+    for(int i = 0; i < INPUT_ACTION_KEY_COUNT; i++)
+        if(map->keys[i] != SDL_SCANCODE_UNKNOWN && key_check(map->keys[i]))
+            return SDL_TRUE;
+
+    for(int i = 0; i < INPUT_ACTION_KEY_COUNT; i++)
+        if(map->button[i].button != SDL_CONTROLLER_BUTTON_INVALID && gamepad_check_index(map->button[i].button, map->button[i].index))
+            return SDL_TRUE;
+
+    if(map->mouse != 0 && mouse_check(map->mouse))
+        return SDL_TRUE;
+
+    return SDL_FALSE;
+}
+
+static inline SDL_bool action_check_pressed(Uint32 action) {
+    if(action >= (Uint32)input_manager.action_count)
+        return SDL_FALSE;
+
+    const ActionMap* map = input_manager.maps + action;
+
+    for(int i = 0; i < INPUT_ACTION_KEY_COUNT; i++)
+        if(map->keys[i] != SDL_SCANCODE_UNKNOWN && key_check_pressed(map->keys[i]))
+            return SDL_TRUE;
+
+    for(int i = 0; i < INPUT_ACTION_KEY_COUNT; i++)
+        if(map->button[i].button != SDL_CONTROLLER_BUTTON_INVALID && gamepad_check_pressed_index(map->button[i].button, map->button[i].index))
+            return SDL_TRUE;
+
+    if(map->mouse != 0 && mouse_check_pressed(map->mouse))
+        return SDL_TRUE;
+
+    return SDL_FALSE;
+}
+
+static inline SDL_bool action_check_released(Uint32 action) {
+    if(action >= (Uint32)input_manager.action_count)
+        return SDL_FALSE;
+
+    const ActionMap* map = input_manager.maps + action;
+
+    for(int i = 0; i < INPUT_ACTION_KEY_COUNT; i++)
+        if(map->keys[i] != SDL_SCANCODE_UNKNOWN && key_check_released(map->keys[i]))
+            return SDL_TRUE;
+
+    for(int i = 0; i < INPUT_ACTION_KEY_COUNT; i++)
+        if(map->button[i].button != SDL_CONTROLLER_BUTTON_INVALID && gamepad_check_released_index(map->button[i].button, map->button[i].index))
+            return SDL_TRUE;
+
+    if(map->mouse != 0 && mouse_check_released(map->mouse))
+        return SDL_TRUE;
+
+    return SDL_FALSE;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,217 @@
+#ifndef SDL_UTILS_JOBS_H
+#define SDL_UTILS_JOBS_H
+
+#include <SDL.h>
+
+#include "su_utils.h"
+
+#define JOB_MAX_WORKERS 32
+
+/**
+    The number of jobs each queue can hold. Jobs pushed to a full
+    queue are run immediately by the thread that pushed them.
+*/
+#define JOB_QUEUE_CAPACITY 1024
+
+typedef void (*JobFn)(void* data);
+
+/**
+    Processes the items in [start, end) of a parallel for.
+*/
+typedef void (*JobRangeFn)(int start, int end, void* data);
+
+/**
+    Counts the jobs that haven't finished yet. Wait for it to reach
+    zero with job_wait to make one piece of work depend on another.
+*/
+typedef struct JobCounter {
+    SDL_atomic_t pending;
+} JobCounter;
+
+typedef struct Job {
+    JobFn fn;
+    JobRangeFn range_fn;
+    void* data;
+    int start;
+    int end;
+    JobCounter* counter;
+} Job;
+
+/**
+    A double ended queue of jobs. The thread that owns it pushes and pops
+    at the bottom, while other threads steal from the top.
+*/
+typedef struct JobQueue {
+    Job* jobs;
+    Uint32 top;
+    Uint32 bottom;
+    SDL_SpinLock lock;
+    struct JobSystem* system;
+    int index;
+} JobQueue;
+
+/**
+    A pool of worker threads that run jobs. Each worker has its own queue
+    and steals from the others when it runs out of work.
+
+    Jobs that need to call into SDL, like creating textures, can be sent
+    to the main thread with job_run_main.
+*/
+typedef struct JobSystem {
+    SDL_Thread* workers[JOB_MAX_WORKERS];
+    int worker_count;
+
+    /**
+        One queue per worker, after the queue shared by the
+        threads that aren't workers, like the main thread.
+    */
+    JobQueue queues[JOB_MAX_WORKERS + 1];
+    int queue_count;
+
+    /**
+        Identifies which queue belongs to the current thread.
+    */
+    SDL_TLSID queue_id;
+    SDL_threadID main_thread;
+
+    SDL_mutex* mutex;
+    SDL_cond* wake;
+    SDL_atomic_t queued;
+    SDL_atomic_t sleeping;
+    SDL_atomic_t quit;
+
+    /**
+        The number of jobs waiting for the main thread, readable without the mutex.
+    */
+    SDL_atomic_t main_queued;
+
+    /**
+        The jobs waiting for the main thread, and the ones that are being run.
+        Both are protected by the mutex.
+    */
+    Job* main_jobs;
+    int main_count;
+    int main_capacity;
+    Job* main_running;
+    int main_running_capacity;
+    SDL_bool running_main;
+} JobSystem;
+
+/**
+    Initializes a job system and starts its workers. The thread that calls
+    this is considered the main thread.
+
+    \param system The job system to initialize.
+    \param worker_count The number of worker threads, up to JOB_MAX_WORKERS.
+                        With a negative number, one worker is started for every
+                        CPU core except the one used by the main thread. With 0,
+                        jobs run on the main thread while it waits for them.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool job_system_init(JobSystem* system, int worker_count);
+
+/**
+    Allocates and initializes a job system. Returns NULL on failure.
+
+    \see job_system_init
+*/
+JobSystem* job_system_create(int worker_count);
+
+/**
+    Stops the workers and frees the resources used by the job system, without
+    freeing the job system itself. Jobs that are still queued are discarded.
+*/
+void job_system_free_resources(JobSystem* system);
+
+/**
+    Frees the resources used by the job system, then frees the job system itself.
+    Only use if the job system was allocated with job_system_create.
+*/
+void job_system_free(JobSystem* system);
+
+/**
+    Queues a job. Can be called from any thread, including from inside a job.
+
+    \param system The job system to run the job on.
+    \param fn The function to run.
+    \param data User data passed to fn.
+    \param counter Incremented now and decremented once the job is done. Can be NULL.
+*/
+void job_run(JobSystem* system, JobFn fn, void* data, JobCounter* counter);
+
+/**
+    Queues a job that runs on the main thread, the next time it calls
+    job_system_run_main_jobs or waits on a counter.
+
+    \param system The job system to run the job on.
+    \param fn The function to run.
+    \param data User data passed to fn.
+    \param counter Incremented now and decremented once the job is done. Can be NULL.
+    \return SDL_TRUE on success, SDL_FALSE if there wasn't enough memory to queue it.
+*/
+SDL_bool job_run_main(JobSystem* system, JobFn fn, void* data, JobCounter* counter);
+
+/**
+    Runs the jobs that were queued for the main thread. Must be called from
+    the main thread, usually once per frame. Jobs that are queued while this
+    runs are left for the next call.
+*/
+void job_system_run_main_jobs(JobSystem* system);
+
+/**
+    Splits [0, count) into batches and queues a job for each one.
+
+    \param system The job system to run the jobs on.
+    \param count The number of items to process.
+    \param batch_size The smallest number of items given to a job.
+                      Use larger batches when each item is cheap.
+    \param fn Called once for each batch.
+    \param data User data passed to fn.
+    \param counter Incremented for each batch, and decremented as they finish. Can't be NULL.
+*/
+void job_parallel_for_async(JobSystem* system, int count, int batch_size, JobRangeFn fn, void* data, JobCounter* counter);
+
+/**
+    Splits [0, count) into batches, processes them on every thread,
+    then returns once all of them are done. The calling thread
+    processes batches as well instead of sitting idle.
+
+    \see job_parallel_for_async
+*/
+void job_parallel_for(JobSystem* system, int count, int batch_size, JobRangeFn fn, void* data);
+
+/**
+    Waits until a counter reaches zero. The calling thread runs queued jobs while
+    it waits, including the jobs queued for the main thread when it's the main thread,
+    so it's safe to wait from inside a job.
+*/
+void job_wait(JobSystem* system, JobCounter* counter);
+
+/**
+    Gets the number of worker threads.
+*/
+static inline int job_system_get_worker_count(JobSystem* system);
+
+/**
+    Initializes a counter with no pending jobs.
+*/
+static inline void job_counter_init(JobCounter* counter);
+
+/**
+    Determines if every job tracked by a counter is done.
+*/
+static inline SDL_bool job_counter_done(JobCounter* counter);
+
+static inline int job_system_get_worker_count(JobSystem* system) {
+    return system->worker_count;
+}
+
+static inline void job_counter_init(JobCounter* counter) {
+    SDL_AtomicSet(&counter->pending, 0);
+}
+
+static inline SDL_bool job_counter_done(JobCounter* counter) {
+    return SDL_AtomicGet(&counter->pending) == 0;
+}
+
+#endif
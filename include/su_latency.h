@@ -0,0 +1,103 @@
+#ifndef SDL_UTILS_LATENCY_H
+#define SDL_UTILS_LATENCY_H
+
+#include <SDL.h>
+
+#include "su_utils.h"
+
+/**
+    The latency of the inputs whose effects were shown by a single frame.
+    All times are measured from the SDL timestamp of the input event.
+*/
+typedef struct LatencyFrame {
+    /**
+        The number of input events shown by the frame.
+    */
+    int inputs;
+
+    /**
+        The time until the input was sampled by input_manager_update, in milliseconds.
+    */
+    double sample_ms;
+
+    /**
+        The time until the scene_update that consumed the input finished, in milliseconds.
+    */
+    double update_ms;
+
+    /**
+        The time until SDL_RenderPresent returned for the frame showing
+        the oldest input, in milliseconds.
+    */
+    double present_ms;
+
+    /**
+        The time until SDL_RenderPresent returned for the newest input, in milliseconds.
+    */
+    double present_newest_ms;
+} LatencyFrame;
+
+/**
+    Enables or disables latency measurement. Disabled by default.
+
+    While enabled, every input event passed to latency_event is followed through
+    input_manager_update, scene_update and scene_draw. The results are recorded
+    in the latency.* histograms of the metrics registry for each frame.
+*/
+void latency_set_enabled(SDL_bool enabled);
+
+/**
+    Determines if latency is being measured.
+*/
+SDL_bool latency_enabled(void);
+
+/**
+    Starts following an event if it's an input event. Call it for
+    every event returned by SDL_PollEvent.
+*/
+void latency_event(const SDL_Event* event);
+
+/**
+    Marks the inputs received so far as sampled. Called by input_manager_update.
+*/
+void latency_sampled(void);
+
+/**
+    Marks the sampled inputs as consumed by the game. Called by scene_update.
+*/
+void latency_updated(void);
+
+/**
+    Marks the consumed inputs as shown on screen and records their latency.
+    Called by scene_draw after SDL_RenderPresent.
+*/
+void latency_presented(void);
+
+/**
+    Gets the latency of the last frame that showed any input.
+*/
+LatencyFrame latency_get_frame(void);
+
+/**
+    Sets how long to wait after a frame is presented before sampling input
+    for the next one. Sampling later means the inputs that arrive in the
+    meantime show up a frame sooner, but a delay that's too long misses vsync.
+    Defaults to 0.
+
+    \param milliseconds The time to wait, applied by latency_wait_input.
+*/
+void latency_set_input_delay(Uint32 milliseconds);
+
+/**
+    Gets the time to wait after a frame is presented before sampling input.
+*/
+Uint32 latency_get_input_delay(void);
+
+/**
+    Waits until the input delay has passed since the last frame was presented.
+    Call it at the start of the frame, before polling events.
+    Returns immediately if the delay has already passed.
+*/
+void latency_wait_input(void);
+
+#endif
@@ -2,15 +2,68 @@
 #define SDL_UTILS_MATH_H
 
 #include <math.h>
+#include "su_data_types.h"
 
+#if defined(__SSE4_1__) && !defined(SDL_UTILS_NO_SIMD)
+#include <smmintrin.h>
+#endif
+
+/**
+    Floors a float using a biased truncation.
+
+    \remark Only valid for x in [-32768, 2147450879]. Below that range the
+            result is wrong, and because the bias is added in float precision,
+            fractions within 1/512 of the next integer round up (e.g.
+            fast_floor(0.999999f) is 1). Use floor_to_int for world coordinates.
+*/
 static inline int fast_floor(float x) {
     return (int)(x + 32768.0f) - 32768;
 }
 
+/**
+    Ceils a float using a biased truncation.
+
+    \remark Only valid for x in [-2147450880, 32768], with the same precision
+            loss as fast_floor. Use ceil_to_int for world coordinates.
+*/
 static inline int fast_ceil(float x) {
     return 32768 - (int)(32768.f - x);
 }
 
+/**
+    Converts a float to the largest int that is less than or equal to it.
+
+    \remark Exact for every x in [-2147483648, 2147483520], which is every float
+            whose floor fits in an int. NaN and values outside of that range give
+            an unspecified result.
+*/
+static inline int floor_to_int(float x);
+
+/**
+    Converts a float to the smallest int that is greater than or equal to it.
+
+    \remark Exact for every x in [-2147483648, 2147483520]. NaN and values
+            outside of that range give an unspecified result.
+*/
+static inline int ceil_to_int(float x);
+
+/**
+    Converts a float to the nearest int, rounding halfway cases away from
+    zero like lroundf.
+
+    \remark Exact for every x in [-2147483648, 2147483520]. NaN and values
+            outside of that range give an unspecified result.
+*/
+static inline int round_to_int(float x);
+
+/**
+    Converts a float to an int by discarding the fraction (rounding towards zero).
+
+    \remark Exact for every x in [-2147483648, 2147483520]. NaN and values
+            outside of that range give an unspecified result.
+*/
+static inline int trunc_to_int(float x);
+
 static inline float floor_ext(float value, float n) {
     return floorf(value / n) * n;
 }
@@ -23,4 +76,535 @@ static inline float round_ext(float value, float n) {
     return roundf(value / n) * n;
 }
 
+/**
+    Floors every value in an array, storing the results as ints.
+    Has the same valid range as floor_to_int.
+*/
+void floor_to_int_batch(const float* values, int* result, int count);
+
+/**
+    Ceils every value in an array, storing the results as ints.
+    Has the same valid range as ceil_to_int.
+*/
+void ceil_to_int_batch(const float* values, int* result, int count);
+
+/**
+    Rounds every value in an array to the nearest int, halfway cases away from zero.
+    Has the same valid range as round_to_int.
+*/
+void round_to_int_batch(const float* values, int* result, int count);
+
+/**
+    Truncates every value in an array towards zero, storing the results as ints.
+    Has the same valid range as trunc_to_int.
+*/
+void trunc_to_int_batch(const float* values, int* result, int count);
+
+/**
+    Adds two vectors.
+*/
+static inline Vector2 vector2_add(Vector2 left, Vector2 right);
+
+/**
+    Subtracts the right vector from the left vector.
+*/
+static inline Vector2 vector2_subtract(Vector2 left, Vector2 right);
+
+/**
+    Multiplies two vectors component-wise.
+*/
+static inline Vector2 vector2_multiply(Vector2 left, Vector2 right);
+
+/**
+    Multiplies both components of a vector by a scalar.
+*/
+static inline Vector2 vector2_scale(Vector2 vector, float scale);
+
+/**
+    Negates both components of a vector.
+*/
+static inline Vector2 vector2_negate(Vector2 vector);
+
+/**
+    Gets the dot product of two vectors.
+*/
+static inline float vector2_dot(Vector2 left, Vector2 right);
+
+/**
+    Gets the z component of the cross product of two vectors. Positive if
+    right is counter-clockwise from left.
+*/
+static inline float vector2_cross(Vector2 left, Vector2 right);
+
+/**
+    Gets the squared length of a vector. Cheaper than vector2_length when
+    only comparing lengths.
+*/
+static inline float vector2_length_squared(Vector2 vector);
+
+/**
+    Gets the length of a vector.
+*/
+static inline float vector2_length(Vector2 vector);
+
+/**
+    Gets the squared distance between two points.
+*/
+static inline float vector2_distance_squared(Vector2 left, Vector2 right);
+
+/**
+    Gets the distance between two points.
+*/
+static inline float vector2_distance(Vector2 left, Vector2 right);
+
+/**
+    Gets a vector with the same direction and a length of 1.
+    A zero vector stays a zero vector.
+*/
+static inline Vector2 vector2_normalize(Vector2 vector);
+
+/**
+    Linearly interpolates between two vectors.
+
+    \param amount The interpolation amount. 0 returns from, 1 returns to.
+*/
+static inline Vector2 vector2_lerp(Vector2 from, Vector2 to, float amount);
+
+/**
+    Rotates a vector counter-clockwise around the origin.
+
+    \param radians The angle to rotate by in radians.
+*/
+static inline Vector2 vector2_rotate(Vector2 vector, float radians);
+
+/**
+    Converts a Point into a Vector2.
+*/
+static inline Vector2 vector2_from_point(Point point);
+
+/**
+    Converts a Vector2 into a Point, truncating the components.
+*/
+static inline Point vector2_to_point(Vector2 vector);
+
+/**
+    Adds a vector to every vector in a structure of arrays.
+    x[i] += dx[i], y[i] += dy[i].
+*/
+void vector2_batch_add(float* x, float* y, const float* dx, const float* dy, int count);
+
+/**
+    Adds a scaled vector to every vector in a structure of arrays. Useful to
+    integrate positions: x[i] += vx[i] * scale, y[i] += vy[i] * scale.
+*/
+void vector2_batch_add_scaled(float* x, float* y, const float* vx, const float* vy, float scale, int count);
+
+/**
+    Multiplies every vector in a structure of arrays by a scalar.
+*/
+void vector2_batch_scale(float* x, float* y, float scale, int count);
+
+/**
+    Gets the dot product of every pair of vectors in two structures of arrays.
+*/
+void vector2_batch_dot(const float* ax, const float* ay, const float* bx, const float* by, float* result, int count);
+
+/**
+    Gets the length of every vector in a structure of arrays.
+*/
+void vector2_batch_length(const float* x, const float* y, float* result, int count);
+
+/**
+    Normalizes every vector in a structure of arrays in place.
+    Zero vectors stay zero vectors.
+*/
+void vector2_batch_normalize(float* x, float* y, int count);
+
+/**
+    Shortens any vector in a structure of arrays that is longer than max_length
+    to max_length, keeping its direction.
+*/
+void vector2_batch_clamp_length(float* x, float* y, float max_length, int count);
+
+/**
+    Linearly interpolates every vector in a structure of arrays towards a
+    target in place.
+*/
+void vector2_batch_lerp(float* x, float* y, const float* to_x, const float* to_y, float amount, int count);
+
+/**
+    Rotates every vector in a structure of arrays counter-clockwise around
+    the origin by the same angle.
+*/
+void vector2_batch_rotate(float* x, float* y, float radians, int count);
+
+// The scalar versions are branchless: the truncated value is corrected by
+// the result of a comparison. Converting the truncated value back to float is
+// exact, since any float large enough to lose precision is already an integer.
+
+static inline int floor_to_int(float x) {
+#if defined(__SSE4_1__) && !defined(SDL_UTILS_NO_SIMD)
+    __m128 v = _mm_set_ss(x);
+    return _mm_cvttss_si32(_mm_round_ss(v, v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+#else
+    int i = (int)x;
+    return i - (x < (float)i);
+#endif
+}
+
+static inline int ceil_to_int(float x) {
+#if defined(__SSE4_1__) && !defined(SDL_UTILS_NO_SIMD)
+    __m128 v = _mm_set_ss(x);
+    return _mm_cvttss_si32(_mm_round_ss(v, v, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+#else
+    int i = (int)x;
+    return i + (x > (float)i);
+#endif
+}
+
+static inline int round_to_int(float x) {
+    int i = (int)x;
+    float fraction = x - (float)i;
+    return i + (fraction >= 0.5f) - (fraction <= -0.5f);
+}
+
+static inline int trunc_to_int(float x) {
+    return (int)x;
+}
+
+static inline Vector2 vector2_add(Vector2 left, Vector2 right) {
+    return (Vector2){ left.x + right.x, left.y + right.y };
+}
+
+static inline Vector2 vector2_subtract(Vector2 left, Vector2 right) {
+    return (Vector2){ left.x - right.x, left.y - right.y };
+}
+
+static inline Vector2 vector2_multiply(Vector2 left, Vector2 right) {
+    return (Vector2){ left.x * right.x, left.y * right.y };
+}
+
+static inline Vector2 vector2_scale(Vector2 vector, float scale) {
+    return (Vector2){ vector.x * scale, vector.y * scale };
+}
+
+static inline Vector2 vector2_negate(Vector2 vector) {
+    return (Vector2){ -vector.x, -vector.y };
+}
+
+static inline float vector2_dot(Vector2 left, Vector2 right) {
+    return left.x * right.x + left.y * right.y;
+}
+
+static inline float vector2_cross(Vector2 left, Vector2 right) {
+    return left.x * right.y - left.y * right.x;
+}
+
+static inline float vector2_length_squared(Vector2 vector) {
+    return vector.x * vector.x + vector.y * vector.y;
+}
+
+static inline float vector2_length(Vector2 vector) {
+    return sqrtf(vector.x * vector.x + vector.y * vector.y);
+}
+
+static inline float vector2_distance_squared(Vector2 left, Vector2 right) {
+    return vector2_length_squared(vector2_subtract(left, right));
+}
+
+static inline float vector2_distance(Vector2 left, Vector2 right) {
+    return vector2_length(vector2_subtract(left, right));
+}
+
+static inline Vector2 vector2_normalize(Vector2 vector) {
+    float length = vector2_length(vector);
+    if(length == 0)
+        return vector;
+    return vector2_scale(vector, 1.0f / length);
+}
+
+static inline Vector2 vector2_lerp(Vector2 from, Vector2 to, float amount) {
+    return (Vector2){ from.x + (to.x - from.x) * amount, from.y + (to.y - from.y) * amount };
+}
+
+static inline Vector2 vector2_rotate(Vector2 vector, float radians) {
+    float c = cosf(radians);
+    float s = sinf(radians);
+    return (Vector2){ vector.x * c - vector.y * s, vector.x * s + vector.y * c };
+}
+
+static inline Vector2 vector2_from_point(Point point) {
+    return (Vector2){ (float)point.x, (float)point.y };
+}
+
+static inline Point vector2_to_point(Vector2 vector) {
+    return (Point){ (int)vector.x, (int)vector.y };
+}
+
+/**
+    A signed Q16.16 fixed-point number: 16 integer bits and 16 fraction bits.
+
+    Every fixed-point operation is done with integer math, so it gives
+    bit-identical results on every compiler and CPU. Use it for simulation
+    state that has to stay in sync for lockstep multiplayer and replays, and
+    only convert to float for rendering.
+
+    \remark Arithmetic saturates at FIXED_MIN and FIXED_MAX instead of wrapping.
+*/
+typedef Sint32 Fixed;
+
+/**
+    A 2D vector of fixed-point numbers.
+*/
+typedef struct FixedVector2 {
+    Fixed x;
+    Fixed y;
+} FixedVector2;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define FIXED_HALF (1 << (FIXED_SHIFT - 1))
+#define FIXED_MAX ((Fixed)0x7FFFFFFF)
+#define FIXED_MIN ((Fixed)(-0x7FFFFFFF - 1))
+#define FIXED_PI ((Fixed)205887)
+#define FIXED_TWO_PI ((Fixed)411775)
+#define FIXED_HALF_PI ((Fixed)102944)
+
+/**
+    Converts an int to a fixed-point number, saturating if it's outside of [-32768, 32767].
+*/
+static inline Fixed fixed_from_int(int value);
+
+/**
+    Converts a fixed-point number to an int, rounding towards negative infinity.
+*/
+static inline int fixed_to_int(Fixed value);
+
+/**
+    Converts a float to the nearest fixed-point number, saturating if it's out of range.
+
+    \remark Float conversions are not guaranteed to be identical across platforms,
+            so only use this for constants and for data that isn't simulated.
+*/
+static inline Fixed fixed_from_float(float value);
+
+/**
+    Converts a fixed-point number to a float.
+*/
+static inline float fixed_to_float(Fixed value);
+
+/**
+    Adds two fixed-point numbers, saturating on overflow.
+*/
+static inline Fixed fixed_add(Fixed left, Fixed right);
+
+/**
+    Subtracts the right fixed-point number from the left one, saturating on overflow.
+*/
+static inline Fixed fixed_subtract(Fixed left, Fixed right);
+
+/**
+    Multiplies two fixed-point numbers, rounding towards negative infinity
+    and saturating on overflow.
+*/
+static inline Fixed fixed_multiply(Fixed left, Fixed right);
+
+/**
+    Divides the left fixed-point number by the right one, rounding towards zero
+    and saturating on overflow. Dividing by zero saturates towards the sign of
+    the numerator.
+*/
+static inline Fixed fixed_divide(Fixed left, Fixed right);
+
+/**
+    Negates a fixed-point number, saturating FIXED_MIN to FIXED_MAX.
+*/
+static inline Fixed fixed_negate(Fixed value);
+
+/**
+    Gets the absolute value of a fixed-point number, saturating FIXED_MIN to FIXED_MAX.
+*/
+static inline Fixed fixed_abs(Fixed value);
+
+/**
+    Linearly interpolates between two fixed-point numbers.
+*/
+static inline Fixed fixed_lerp(Fixed from, Fixed to, Fixed amount);
+
+/**
+    Gets the square root of a fixed-point number. Negative values return 0.
+    The result is rounded towards zero.
+*/
+Fixed fixed_sqrt(Fixed value);
+
+/**
+    Gets the sine of an angle in radians using a lookup table.
+    Accurate to about 1/20000.
+*/
+Fixed fixed_sin(Fixed radians);
+
+/**
+    Gets the cosine of an angle in radians using a lookup table.
+    Accurate to about 1/20000.
+*/
+Fixed fixed_cos(Fixed radians);
+
+/**
+    Gets the angle in radians between the positive x axis and the point (x, y),
+    in the range [-FIXED_PI, FIXED_PI], using a lookup table. Returns 0 for (0, 0).
+*/
+Fixed fixed_atan2(Fixed y, Fixed x);
+
+/**
+    Adds two fixed-point vectors, saturating on overflow.
+*/
+static inline FixedVector2 fixed_vector2_add(FixedVector2 left, FixedVector2 right);
+
+/**
+    Subtracts the right fixed-point vector from the left one, saturating on overflow.
+*/
+static inline FixedVector2 fixed_vector2_subtract(FixedVector2 left, FixedVector2 right);
+
+/**
+    Multiplies both components of a fixed-point vector by a scalar.
+*/
+static inline FixedVector2 fixed_vector2_scale(FixedVector2 vector, Fixed scale);
+
+/**
+    Gets the dot product of two fixed-point vectors, saturating on overflow.
+*/
+static inline Fixed fixed_vector2_dot(FixedVector2 left, FixedVector2 right);
+
+/**
+    Gets the length of a fixed-point vector, saturating on overflow.
+*/
+Fixed fixed_vector2_length(FixedVector2 vector);
+
+/**
+    Gets a fixed-point vector with the same direction and a length of 1.
+    A zero vector stays a zero vector.
+*/
+FixedVector2 fixed_vector2_normalize(FixedVector2 vector);
+
+/**
+    Rotates a fixed-point vector counter-clockwise around the origin.
+*/
+FixedVector2 fixed_vector2_rotate(FixedVector2 vector, Fixed radians);
+
+/**
+    Converts a fixed-point vector to a Vector2 for rendering.
+*/
+static inline Vector2 fixed_vector2_to_vector2(FixedVector2 vector);
+
+/**
+    Converts a Vector2 to the nearest fixed-point vector.
+*/
+static inline FixedVector2 fixed_vector2_from_vector2(Vector2 vector);
+
+/**
+    Converts a fixed-point vector to a Point, rounding towards negative infinity.
+*/
+static inline Point fixed_vector2_to_point(FixedVector2 vector);
+
+/**
+    Converts a Point to a fixed-point vector, saturating if it's out of range.
+*/
+static inline FixedVector2 fixed_vector2_from_point(Point point);
+
+static inline Fixed fixed_saturate(Sint64 value) {
+    if(value > FIXED_MAX)
+        return FIXED_MAX;
+    if(value < FIXED_MIN)
+        return FIXED_MIN;
+    return (Fixed)value;
+}
+
+static inline Fixed fixed_from_int(int value) {
+    return fixed_saturate((Sint64)value * FIXED_ONE);
+}
+
+static inline int fixed_to_int(Fixed value) {
+    // Right shifting a negative number is implementation defined in C,
+    // so divide with an explicit floor correction instead.
+    return value >= 0 ? value / FIXED_ONE : -(int)((FIXED_ONE - 1 - (Sint64)value) / FIXED_ONE);
+}
+
+static inline Fixed fixed_from_float(float value) {
+    double scaled = (double)value * FIXED_ONE;
+    if(scaled >= (double)FIXED_MAX)
+        return FIXED_MAX;
+    if(scaled <= (double)FIXED_MIN)
+        return FIXED_MIN;
+    return (Fixed)(scaled >= 0 ? scaled + 0.5 : scaled - 0.5);
+}
+
+static inline float fixed_to_float(Fixed value) {
+    return (float)value / FIXED_ONE;
+}
+
+static inline Fixed fixed_add(Fixed left, Fixed right) {
+    return fixed_saturate((Sint64)left + right);
+}
+
+static inline Fixed fixed_subtract(Fixed left, Fixed right) {
+    return fixed_saturate((Sint64)left - right);
+}
+
+static inline Fixed fixed_multiply(Fixed left, Fixed right) {
+    Sint64 product = (Sint64)left * right;
+    // Floor division by 2^16 without relying on arithmetic right shifts.
+    Sint64 quotient = product >= 0 ? product / FIXED_ONE : -((FIXED_ONE - 1 - product) / FIXED_ONE);
+    return fixed_saturate(quotient);
+}
+
+static inline Fixed fixed_divide(Fixed left, Fixed right) {
+    if(right == 0)
+        return left >= 0 ? FIXED_MAX : FIXED_MIN;
+    return fixed_saturate(((Sint64)left * FIXED_ONE) / right);
+}
+
+static inline Fixed fixed_negate(Fixed value) {
+    return value == FIXED_MIN ? FIXED_MAX : -value;
+}
+
+static inline Fixed fixed_abs(Fixed value) {
+    return value < 0 ? fixed_negate(value) : value;
+}
+
+static inline Fixed fixed_lerp(Fixed from, Fixed to, Fixed amount) {
+    return fixed_add(from, fixed_multiply(fixed_subtract(to, from), amount));
+}
+
+static inline FixedVector2 fixed_vector2_add(FixedVector2 left, FixedVector2 right) {
+    return (FixedVector2){ fixed_add(left.x, right.x), fixed_add(left.y, right.y) };
+}
+
+static inline FixedVector2 fixed_vector2_subtract(FixedVector2 left, FixedVector2 right) {
+    return (FixedVector2){ fixed_subtract(left.x, right.x), fixed_subtract(left.y, right.y) };
+}
+
+static inline FixedVector2 fixed_vector2_scale(FixedVector2 vector, Fixed scale) {
+    return (FixedVector2){ fixed_multiply(vector.x, scale), fixed_multiply(vector.y, scale) };
+}
+
+static inline Fixed fixed_vector2_dot(FixedVector2 left, FixedVector2 right) {
+    return fixed_add(fixed_multiply(left.x, right.x), fixed_multiply(left.y, right.y));
+}
+
+static inline Vector2 fixed_vector2_to_vector2(FixedVector2 vector) {
+    return (Vector2){ fixed_to_float(vector.x), fixed_to_float(vector.y) };
+}
+
+static inline FixedVector2 fixed_vector2_from_vector2(Vector2 vector) {
+    return (FixedVector2){ fixed_from_float(vector.x), fixed_from_float(vector.y) };
+}
+
+static inline Point fixed_vector2_to_point(FixedVector2 vector) {
+    return (Point){ fixed_to_int(vector.x), fixed_to_int(vector.y) };
+}
+
+static inline FixedVector2 fixed_vector2_from_point(Point point) {
+    return (FixedVector2){ fixed_from_int(point.x), fixed_from_int(point.y) };
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,279 @@
+#ifndef SDL_UTILS_METRICS_H
+#define SDL_UTILS_METRICS_H
+
+#include <SDL.h>
+
+#include "su_utils.h"
+
+/**
+    The number of buckets in a histogram. Each bucket covers
+    twice the range of the one before it.
+*/
+#define METRIC_HISTOGRAM_BUCKETS 20
+
+/**
+    A handle to a metric in the registry.
+*/
+typedef int MetricId;
+
+#define METRIC_INVALID -1
+
+typedef enum MetricType {
+    /**
+        A total that only goes up, like the number of draw calls.
+    */
+    METRIC_COUNTER,
+
+    /**
+        A value that is replaced every time it's set, like the number of live entities.
+    */
+    METRIC_GAUGE,
+
+    /**
+        A distribution of samples, like the time spent in a function.
+    */
+    METRIC_HISTOGRAM
+} MetricType;
+
+typedef enum MetricsFormat {
+    METRICS_FORMAT_CSV,
+
+    /**
+        One JSON object per line.
+    */
+    METRICS_FORMAT_JSON
+} MetricsFormat;
+
+/**
+    The metrics recorded by the library itself. They're always registered.
+*/
+typedef enum MetricBuiltin {
+    /**
+        The number of times a camera recreated its render target because its size changed.
+    */
+    METRIC_CAMERA_RENDER_TARGETS,
+
+    /**
+        The render scale picked by the resolution controller.
+    */
+    METRIC_CAMERA_RENDER_SCALE,
+
+    /**
+        The number of SDL_RenderClear calls made by scene_draw.
+    */
+    METRIC_SCENE_RENDER_CLEARS,
+
+    /**
+        The number of SDL_RenderCopyEx calls made by scene_draw.
+    */
+    METRIC_SCENE_RENDER_COPIES,
+
+    /**
+        The time scene_draw took, in milliseconds.
+    */
+    METRIC_SCENE_DRAW_MS,
+
+    /**
+        The time scene_update took, in milliseconds.
+    */
+    METRIC_SCENE_UPDATE_MS,
+
+    METRIC_SCENE_PUSHES,
+    METRIC_SCENE_POPS,
+
+    /**
+        The number of scenes on the stack.
+    */
+    METRIC_SCENE_DEPTH,
+
+    /**
+        The time input_manager_update took, in milliseconds.
+    */
+    METRIC_INPUT_UPDATE_MS,
+
+    /**
+        The time from an input event to input_manager_update sampling it,
+        for the oldest input of each frame. Only recorded while latency is measured.
+    */
+    METRIC_LATENCY_SAMPLE_MS,
+
+    /**
+        The time from an input event to the end of the scene_update that consumed it.
+    */
+    METRIC_LATENCY_UPDATE_MS,
+
+    /**
+        The time from an input event to the frame showing it being presented.
+    */
+    METRIC_LATENCY_PRESENT_MS,
+
+    METRIC_BUILTIN_COUNT
+} MetricBuiltin;
+
+typedef struct Metric {
+    const char* name;
+    MetricType type;
+
+    /**
+        The total of a counter, or the number of samples in a histogram.
+    */
+    Uint64 count;
+
+    /**
+        The current value of a gauge, or the sum of the samples in a histogram.
+    */
+    double value;
+
+    double min;
+    double max;
+
+    /**
+        The upper bound of the first histogram bucket. Bucket i holds samples
+        below first_bound * 2^i, and the last bucket holds everything else.
+    */
+    double first_bound;
+    Uint64 buckets[METRIC_HISTOGRAM_BUCKETS];
+} Metric;
+
+/**
+    Adds a metric to the registry. If a metric with the same name and
+    type already exists, its id is returned instead.
+
+    \param name The name of the metric. Copied into the registry.
+                Use dots to group related metrics, like "physics.contacts".
+    \param type The type of the metric.
+    \return The id of the metric, or METRIC_INVALID on failure. Get the error using SDL_GetError.
+
+    \remark The registry itself isn't thread-safe. Register, read, write and
+            free the metrics from the main thread, while no job system is running
+            jobs that update them (job_parallel_for and scene_batch_run return
+            once their jobs are done). Only metrics_add, metrics_set,
+            metrics_record, metrics_time_end and metrics_reset can be called
+            from any thread.
+*/
+MetricId metrics_register(const char* name, MetricType type);
+
+/**
+    Adds a histogram to the registry with a custom first bucket.
+
+    \param name The name of the metric.
+    \param first_bound The upper bound of the first bucket. Pick a value a bit
+                       below the smallest sample you care about telling apart.
+    \return The id of the metric, or METRIC_INVALID on failure. Get the error using SDL_GetError.
+
+    \see metrics_register
+*/
+MetricId metrics_register_histogram(const char* name, double first_bound);
+
+/**
+    Finds a metric by name.
+
+    \return The id of the metric, or METRIC_INVALID if it isn't registered.
+*/
+MetricId metrics_find(const char* name);
+
+/**
+    Gets a metric. The pointer is invalidated when a metric is registered.
+*/
+const Metric* metrics_get(MetricId id);
+
+/**
+    Gets the number of registered metrics, including the built in ones.
+*/
+int metrics_get_count(void);
+
+/**
+    Adds to a counter. Safe to call from any thread.
+*/
+void metrics_add(MetricId id, Uint64 amount);
+
+/**
+    Sets the value of a gauge. Safe to call from any thread.
+*/
+void metrics_set(MetricId id, double value);
+
+/**
+    Adds a sample to a histogram. Safe to call from any thread.
+*/
+void metrics_record(MetricId id, double value);
+
+/**
+    Starts timing something to record with metrics_time_end.
+*/
+static inline Uint64 metrics_time_begin(void);
+
+/**
+    Records the milliseconds since metrics_time_begin in a histogram.
+    Safe to call from any thread.
+*/
+void metrics_time_end(MetricId id, Uint64 start);
+
+/**
+    Estimates a percentile of a histogram from its buckets.
+
+    \param id The histogram.
+    \param percentile The percentile to estimate, from 0 to 1.
+    \return The upper bound of the bucket containing the percentile,
+            limited to the largest sample. 0 if there are no samples.
+*/
+double metrics_percentile(MetricId id, double percentile);
+
+/**
+    Enables or disables recording. While disabled, updating a metric does nothing.
+    Recording is enabled by default.
+*/
+void metrics_set_enabled(SDL_bool enabled);
+
+/**
+    Determines if metrics are being recorded.
+*/
+SDL_bool metrics_enabled(void);
+
+/**
+    Clears the values of every metric. Registered metrics stay registered.
+    Safe to call from any thread.
+*/
+void metrics_reset(void);
+
+/**
+    Removes every metric registered by the user and frees the registry.
+    The built in metrics stay available.
+*/
+void metrics_quit(void);
+
+/**
+    Writes every metric as CSV, with a header line.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool metrics_write_csv(SDL_RWops* output);
+
+/**
+    Writes every metric as a single line of JSON.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool metrics_write_json(SDL_RWops* output);
+
+/**
+    Periodically writes the metrics to a stream from metrics_update.
+
+    \param output The stream to write to, or NULL to stop. It's not closed by the registry.
+    \param format The format to write.
+    \param interval The number of milliseconds between writes.
+    \param reset Determines if the metrics are reset after each write, so each
+                 write only covers the time since the previous one.
+*/
+void metrics_set_dump(SDL_RWops* output, MetricsFormat format, Uint32 interval, SDL_bool reset);
+
+/**
+    Writes the metrics if a dump is due. Called by scene_draw,
+    otherwise call it once per frame.
+*/
+void metrics_update(void);
+
+static inline Uint64 metrics_time_begin(void) {
+    return SDL_GetPerformanceCounter();
+}
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef SDL_UTILS_PACK_H
+#define SDL_UTILS_PACK_H
+
+#include <SDL.h>
+
+#include "su_utils.h"
+
+#define PACK_FILE_MAGIC 0x4b505553
+#define PACK_FILE_VERSION 1
+
+/**
+    The default alignment of the data of every file in a pack.
+*/
+#define PACK_DEFAULT_ALIGNMENT 16
+
+typedef enum PackCompression {
+    PACK_COMPRESSION_NONE,
+
+    /**
+        The file is stored as a single LZ4 block.
+    */
+    PACK_COMPRESSION_LZ4
+} PackCompression;
+
+/**
+    The header at the start of a pack file. Every field is little endian.
+*/
+typedef struct PackHeader {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 entry_count;
+    Uint32 alignment;
+    Uint64 index_offset;
+    Uint64 names_offset;
+    Uint64 names_size;
+} PackHeader;
+
+/**
+    Describes a file stored in a pack. The index is an array of entries
+    sorted by hash, then by name, so a file is found with a binary search.
+    Every field is little endian.
+*/
+typedef struct PackEntry {
+    Uint64 hash;
+    Uint64 offset;
+    Uint64 size;
+    Uint64 original_size;
+    Uint32 name_offset;
+    Uint32 name_length;
+    Uint32 compression;
+    Uint32 reserved;
+} PackEntry;
+
+/**
+    A read only view of a pack file.
+
+    The file is memory mapped where the platform allows it, so opening a pack
+    costs a single open call no matter how many files it contains, and the
+    data of a file is only read from disk when it's first touched.
+    On other platforms the whole pack is read into memory.
+*/
+typedef struct Pack {
+    const Uint8* data;
+    size_t size;
+    const PackHeader* header;
+    const PackEntry* entries;
+    const char* names;
+    Uint32 entry_count;
+
+    /**
+        SDL_TRUE if data is a memory mapping, SDL_FALSE if it was allocated.
+    */
+    SDL_bool mapped;
+
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#endif
+} Pack;
+
+typedef struct PackWriterEntry {
+    char* name;
+    Uint64 hash;
+    Uint8* data;
+    size_t size;
+    SDL_bool compress;
+} PackWriterEntry;
+
+/**
+    Collects files in memory and writes them out as a pack.
+*/
+typedef struct PackWriter {
+    PackWriterEntry* entries;
+    int count;
+    int capacity;
+} PackWriter;
+
+/**
+    Opens a pack file.
+
+    \param pack The pack to initialize.
+    \param file The path of the pack file.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool pack_open(Pack* pack, const char* file);
+
+/**
+    Closes a pack. Any SDL_RWops or pointer into the pack that is still in use
+    becomes invalid.
+*/
+void pack_close(Pack* pack);
+
+/**
+    Finds a file in a pack.
+
+    \return The index of the file, or -1 if the pack doesn't contain it.
+*/
+int pack_find(Pack* pack, const char* name);
+
+/**
+    Gets the stored data of a file, pointing directly into the pack.
+
+    \param pack The pack that contains the file.
+    \param index The index of the file returned by pack_find.
+    \param size Set to the number of stored bytes. Can be NULL.
+    \return The data of the file, or NULL if the file is compressed.
+*/
+const void* pack_get_data(Pack* pack, int index, size_t* size);
+
+/**
+    Gets the size of a file once it's decompressed.
+*/
+static inline size_t pack_get_size(Pack* pack, int index);
+
+/**
+    Gets the name of a file. The name is not null terminated.
+
+    \param pack The pack that contains the file.
+    \param index The index of the file.
+    \param length Set to the length of the name.
+*/
+static inline const char* pack_get_name(Pack* pack, int index, int* length);
+
+/**
+    Gets the number of files in a pack.
+*/
+static inline int pack_get_count(Pack* pack);
+
+/**
+    Decompresses a file into a buffer.
+
+    \param pack The pack that contains the file.
+    \param index The index of the file.
+    \param buffer The buffer to fill. Must hold at least pack_get_size bytes.
+    \return SDL_TRUE on success, SDL_FALSE if the data was corrupt.
+*/
+SDL_bool pack_read(Pack* pack, int index, void* buffer);
+
+/**
+    Opens a file in a pack as a read only stream.
+
+    Uncompressed files are read directly from the pack without being copied.
+    Compressed files are decompressed into a buffer that is freed when
+    the stream is closed.
+
+    \return The stream, or NULL if the file doesn't exist or couldn't be decompressed.
+            Get the error using SDL_GetError.
+*/
+SDL_RWops* pack_open_rw(Pack* pack, const char* name);
+
+/**
+    Initializes a pack writer.
+*/
+void pack_writer_init(PackWriter* writer);
+
+/**
+    Frees the files collected by a pack writer without freeing the writer itself.
+*/
+void pack_writer_free_resources(PackWriter* writer);
+
+/**
+    Adds a file to a pack writer. The data is copied.
+
+    \param writer The writer to add the file to.
+    \param name The name used to find the file in the pack.
+    \param data The contents of the file.
+    \param size The number of bytes in data.
+    \param compress Whether to compress the file. Files that don't get
+                    smaller when compressed are stored as is.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool pack_writer_add(PackWriter* writer, const char* name, const void* data, size_t size, SDL_bool compress);
+
+/**
+    Reads a file from disk and adds it to a pack writer.
+
+    \see pack_writer_add
+*/
+SDL_bool pack_writer_add_file(PackWriter* writer, const char* name, const char* path, SDL_bool compress);
+
+/**
+    Writes the collected files as a pack.
+
+    \param writer The writer containing the files.
+    \param output The stream to write the pack to. Must be at position 0.
+    \param alignment The alignment of the data of each file. Must be a power of two.
+                     Use PACK_DEFAULT_ALIGNMENT unless the data needs more.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool pack_writer_save(PackWriter* writer, SDL_RWops* output, Uint32 alignment);
+
+/**
+    Compresses data into a single LZ4 block.
+
+    \param src The data to compress.
+    \param size The number of bytes in src.
+    \param dst The buffer to fill. Must hold at least pack_compress_bound(size) bytes.
+    \return The number of bytes written to dst.
+*/
+size_t pack_compress(const void* src, size_t size, void* dst);
+
+/**
+    Gets the largest number of bytes pack_compress can write for an input size.
+*/
+static inline size_t pack_compress_bound(size_t size);
+
+/**
+    Decompresses a single LZ4 block.
+
+    \param src The compressed data.
+    \param size The number of bytes in src.
+    \param dst The buffer to fill.
+    \param dst_size The exact size of the decompressed data.
+    \return SDL_TRUE on success, SDL_FALSE if the data was corrupt.
+*/
+SDL_bool pack_decompress(const void* src, size_t size, void* dst, size_t dst_size);
+
+/**
+    Hashes the name of a file in a pack using 64 bit FNV-1a.
+*/
+Uint64 pack_hash(const char* name, size_t length);
+
+static inline size_t pack_get_size(Pack* pack, int index) {
+    return (size_t)SDL_SwapLE64(pack->entries[index].original_size);
+}
+
+static inline const char* pack_get_name(Pack* pack, int index, int* length) {
+    *length = (int)SDL_SwapLE32(pack->entries[index].name_length);
+    return pack->names + SDL_SwapLE32(pack->entries[index].name_offset);
+}
+
+static inline int pack_get_count(Pack* pack) {
+    return (int)pack->entry_count;
+}
+
+static inline size_t pack_compress_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+#endif
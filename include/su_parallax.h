@@ -0,0 +1,174 @@
+#ifndef SDL_UTILS_PARALLAX_H
+#define SDL_UTILS_PARALLAX_H
+
+#include <SDL.h>
+#include "su_camera.h"
+#include "su_data_types.h"
+#include "su_utils.h"
+
+/**
+    The pixel format used by the cached layer textures.
+*/
+#define PARALLAX_LAYER_FORMAT SDL_PIXELFORMAT_ARGB8888
+
+struct ParallaxLayer;
+
+/**
+    Draws the contents of a parallax layer. The render target is set to the
+    cached texture of the layer and cleared to transparent before it's called.
+
+    \param renderer The renderer to draw with.
+    \param layer The layer being drawn.
+    \param data The user data that was passed when the layer was added.
+*/
+typedef void (*ParallaxDrawFn)(SDL_Renderer* renderer, struct ParallaxLayer* layer, void* data);
+
+/**
+    A single background layer that is cached in its own texture.
+*/
+typedef struct ParallaxLayer {
+    /**
+        The cached contents of the layer. NULL until the layer is first drawn.
+    */
+    Texture* target;
+
+    /**
+        The function used to draw the contents of the layer.
+    */
+    ParallaxDrawFn draw;
+
+    /**
+        The user data passed to the draw function.
+    */
+    void* data;
+
+    /**
+        How fast the layer moves compared to the camera. 0 keeps the layer
+        fixed to the screen, 1 moves it with the game world.
+    */
+    Vector2 scroll;
+
+    /**
+        The position of the layer when the camera is at (0, 0).
+    */
+    Vector2 offset;
+
+    /**
+        The size of the cached texture.
+    */
+    int width;
+    int height;
+
+    /**
+        Determines if the layer repeats along each axis to fill the view.
+    */
+    SDL_bool repeat_x;
+    SDL_bool repeat_y;
+
+    /**
+        Determines if the contents of the layer need to be drawn again.
+    */
+    SDL_bool dirty;
+} ParallaxLayer;
+
+/**
+    A stack of background layers that scroll at different speeds relative to
+    a camera. Each layer is drawn once into its own texture and then only
+    copied at an offset each frame, until it's invalidated.
+*/
+typedef struct Parallax {
+    ParallaxLayer* layers;
+    int layer_count;
+    int layer_capacity;
+} Parallax;
+
+/**
+    Initializes a Parallax allocated by the caller.
+*/
+void parallax_init(Parallax* parallax);
+
+/**
+    Allocates and initializes a new Parallax.
+
+    \return Allocated parallax on success, NULL otherwise.
+*/
+Parallax* parallax_create(void);
+
+/**
+    Frees the resources used by the parallax, without freeing the parallax itself.
+*/
+void parallax_free_resources(Parallax* parallax);
+
+/**
+    Frees the resources used by the parallax, then frees the parallax.
+*/
+void parallax_free(Parallax* parallax);
+
+/**
+    Adds a layer on top of the existing layers.
+
+    \param parallax The parallax to add the layer to.
+    \param width The width of the cached layer texture.
+    \param height The height of the cached layer texture.
+    \param scroll How fast the layer moves compared to the camera.
+    \param repeat_x Determines if the layer repeats horizontally.
+    \param repeat_y Determines if the layer repeats vertically.
+    \param draw The function used to draw the contents of the layer.
+    \param data User data passed to the draw function.
+    \return The index of the new layer, or -1 on failure.
+*/
+int parallax_add_layer(Parallax* parallax,
+                       int width,
+                       int height,
+                       Vector2 scroll,
+                       SDL_bool repeat_x,
+                       SDL_bool repeat_y,
+                       ParallaxDrawFn draw,
+                       void* data);
+
+/**
+    Gets a layer of the parallax.
+*/
+static inline ParallaxLayer* parallax_get_layer(Parallax* parallax, int index);
+
+/**
+    Causes a layer to be drawn again the next time the parallax is drawn.
+    Call this whenever the contents of the layer change.
+*/
+static inline void parallax_invalidate(Parallax* parallax, int index);
+
+/**
+    Sets the position of a layer when the camera is at (0, 0).
+*/
+static inline void parallax_set_offset(Parallax* parallax, int index, Vector2 offset);
+
+/**
+    Sets how fast a layer moves compared to the camera.
+*/
+static inline void parallax_set_scroll(Parallax* parallax, int index, Vector2 scroll);
+
+/**
+    Draws every layer to the current render target relative to the camera,
+    redrawing any layers that were invalidated.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool parallax_draw(Parallax* parallax, Camera* camera);
+
+static inline ParallaxLayer* parallax_get_layer(Parallax* parallax, int index) {
+    return parallax->layers + index;
+}
+
+static inline void parallax_invalidate(Parallax* parallax, int index) {
+    parallax->layers[index].dirty = SDL_TRUE;
+}
+
+static inline void parallax_set_offset(Parallax* parallax, int index, Vector2 offset) {
+    parallax->layers[index].offset = offset;
+}
+
+static inline void parallax_set_scroll(Parallax* parallax, int index, Vector2 scroll) {
+    parallax->layers[index].scroll = scroll;
+}
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef SDL_UTILS_PARTICLES_H
+#define SDL_UTILS_PARTICLES_H
+
+#include <SDL.h>
+
+#include "su_camera.h"
+#include "su_data_types.h"
+#include "su_jobs.h"
+#include "su_random.h"
+#include "su_utils.h"
+
+/**
+    Describes how an emitter spawns and draws its particles.
+    Angles are in radians, times are in the same units passed to
+    particle_emitter_update, and speeds are in pixels per time unit.
+*/
+typedef struct ParticleEmitterSettings {
+    /**
+        The texture drawn for each particle, or NULL to draw solid squares.
+    */
+    Texture* texture;
+
+    /**
+        The area of the texture to draw. An empty rectangle uses the whole texture.
+    */
+    Rectangle source;
+
+    /**
+        The world position particles are spawned around.
+    */
+    Vector2 position;
+
+    /**
+        Particles spawn at a random offset up to this distance from the position on each axis.
+    */
+    Vector2 spread;
+
+    /**
+        The number of particles spawned per time unit while emitting.
+    */
+    float rate;
+
+    float lifetime_min;
+    float lifetime_max;
+    float speed_min;
+    float speed_max;
+    float angle_min;
+    float angle_max;
+
+    /**
+        The acceleration applied to every particle.
+    */
+    Vector2 gravity;
+
+    /**
+        The fraction of velocity lost per time unit.
+    */
+    float drag;
+
+    /**
+        The size and color of a particle are interpolated from the start value
+        to the end value over its lifetime.
+    */
+    float start_size;
+    float end_size;
+    SDL_Color start_color;
+    SDL_Color end_color;
+} ParticleEmitterSettings;
+
+/**
+    Spawns, simulates and draws a pool of particles that share a texture.
+
+    \remark The particles are stored as parallel arrays so the simulation
+            can process several particles per instruction.
+*/
+typedef struct ParticleEmitter {
+    ParticleEmitterSettings settings;
+    float* x;
+    float* y;
+    float* velocity_x;
+    float* velocity_y;
+    float* life;
+    float* inv_lifetime;
+    SDL_Vertex* vertices;
+    int* indices;
+    int count;
+    int capacity;
+    float spawn_accumulator;
+    SDL_FPoint uv_min;
+    SDL_FPoint uv_max;
+    Vector2 bounds_min;
+    Vector2 bounds_max;
+    Random random;
+    SDL_bool emitting;
+} ParticleEmitter;
+
+/**
+    Initializes an emitter allocated by the caller.
+
+    \param emitter The emitter to initialize.
+    \param settings How the emitter spawns and draws its particles.
+    \param max_particles The number of particles that can be alive at once.
+    \param seed The seed used to randomize the particles.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool particle_emitter_init(ParticleEmitter* emitter, const ParticleEmitterSettings* settings, int max_particles, Uint64 seed);
+
+/**
+    Allocates and initializes an emitter. Returns NULL on failure.
+
+    \see particle_emitter_init
+*/
+ParticleEmitter* particle_emitter_create(const ParticleEmitterSettings* settings, int max_particles, Uint64 seed);
+
+/**
+    Frees the resources used by the emitter without freeing the emitter itself.
+    The texture isn't freed.
+*/
+void particle_emitter_free_resources(ParticleEmitter* emitter);
+
+/**
+    Frees the resources used by the emitter, then frees the emitter itself.
+    Only use if the emitter was allocated with particle_emitter_create.
+*/
+void particle_emitter_free(ParticleEmitter* emitter);
+
+/**
+    Changes the settings of the emitter. Particles that are already alive keep
+    their lifetime and velocity, but are drawn with the new texture, sizes and colors.
+*/
+void particle_emitter_set_settings(ParticleEmitter* emitter, const ParticleEmitterSettings* settings);
+
+/**
+    Starts or stops continuously spawning particles at the rate of the emitter.
+*/
+static inline void particle_emitter_set_emitting(ParticleEmitter* emitter, SDL_bool emitting);
+
+/**
+    Moves the point particles are spawned around. Existing particles aren't moved.
+*/
+static inline void particle_emitter_set_position(ParticleEmitter* emitter, Vector2 position);
+
+/**
+    Gets the number of particles that are alive.
+*/
+static inline int particle_emitter_get_count(ParticleEmitter* emitter);
+
+/**
+    Spawns a burst of particles immediately.
+
+    \return The number of particles spawned, which is less than count if the emitter is full.
+*/
+int particle_emitter_emit(ParticleEmitter* emitter, int count);
+
+/**
+    Spawns new particles, moves and ages every particle, then removes dead particles.
+*/
+void particle_emitter_update(ParticleEmitter* emitter, float delta);
+
+/**
+    Updates an emitter like particle_emitter_update, but integrates
+    the particles on every thread of a job system.
+
+    \param emitter The emitter to update.
+    \param jobs The job system to integrate the particles on.
+    \param delta The time that passed since the last update.
+*/
+void particle_emitter_update_jobs(ParticleEmitter* emitter, JobSystem* jobs, float delta);
+
+/**
+    Moves and ages a range of particles without adding or removing any.
+
+    This is the parallel update path: split [0, particle_emitter_get_count)
+    into disjoint ranges and integrate them on different threads, then call
+    particle_emitter_compact once every range is done. Spawning with
+    particle_emitter_emit must happen before or after, never during.
+
+    \param emitter The emitter to update.
+    \param delta The time that passed since the last update.
+    \param start The first particle to update.
+    \param end One past the last particle to update.
+*/
+void particle_emitter_integrate(ParticleEmitter* emitter, float delta, int start, int end);
+
+/**
+    Removes dead particles and recalculates the bounds of the emitter.
+*/
+void particle_emitter_compact(ParticleEmitter* emitter);
+
+/**
+    Draws every visible particle with a single SDL_RenderGeometry call.
+    Call this while the render target of the camera is active, such as
+    from the draw system of a scene.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool particle_emitter_draw(ParticleEmitter* emitter, Camera* camera);
+
+static inline void particle_emitter_set_emitting(ParticleEmitter* emitter, SDL_bool emitting) {
+    emitter->emitting = emitting;
+}
+
+static inline void particle_emitter_set_position(ParticleEmitter* emitter, Vector2 position) {
+    emitter->settings.position = position;
+}
+
+static inline int particle_emitter_get_count(ParticleEmitter* emitter) {
+    return emitter->count;
+}
+
+#endif
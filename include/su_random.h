@@ -0,0 +1,180 @@
+#ifndef SDL_UTILS_RANDOM_H
+#define SDL_UTILS_RANDOM_H
+
+#include <SDL.h>
+
+/**
+    A fast, seedable pseudo random number generator (xoshiro256**).
+
+    Unlike rand, every generator has its own state and produces the same
+    sequence on every platform for the same seed. Use random_jump to split
+    a generator into non-overlapping streams, one per thread.
+*/
+typedef struct Random {
+    Uint64 state[4];
+} Random;
+
+/**
+    Seeds a generator. Any seed is valid, including 0.
+*/
+void random_seed(Random* random, Uint64 seed);
+
+/**
+    Advances the generator by 2^128 values. Calling this repeatedly on a copy
+    of a generator creates up to 2^128 streams that never overlap.
+
+    \code
+    Random streams[THREAD_COUNT];
+    for(int i = 0; i < THREAD_COUNT; i++) {
+        streams[i] = *base;
+        random_jump(base);
+    }
+    \endcode
+*/
+void random_jump(Random* random);
+
+/**
+    Advances the generator by 2^192 values. Use this to create a set of
+    streams that each get split further with random_jump.
+*/
+void random_long_jump(Random* random);
+
+/**
+    Gets the next 64 random bits.
+*/
+static inline Uint64 random_next(Random* random);
+
+/**
+    Gets the next 32 random bits.
+*/
+static inline Uint32 random_next_u32(Random* random);
+
+/**
+    Gets a random float in the range [0, 1).
+*/
+static inline float random_float(Random* random);
+
+/**
+    Gets a random double in the range [0, 1).
+*/
+static inline double random_double(Random* random);
+
+/**
+    Gets a random integer in the range [0, bound) without modulo bias.
+    Returns 0 when bound is 0.
+*/
+static inline Uint32 random_bounded(Random* random, Uint32 bound);
+
+/**
+    Gets a random integer in the range [min, max]. Both bounds are inclusive.
+*/
+static inline int random_range(Random* random, int min, int max);
+
+/**
+    Gets a random float in the range [min, max).
+*/
+static inline float random_range_float(Random* random, float min, float max);
+
+/**
+    Gets a random boolean.
+*/
+static inline SDL_bool random_bool(Random* random);
+
+/**
+    Fills an array with random 32 bit values.
+*/
+void random_fill_u32(Random* random, Uint32* output, int count);
+
+/**
+    Fills an array with random floats in the range [min, max).
+*/
+void random_fill_float(Random* random, float* output, int count, float min, float max);
+
+/**
+    Fills an array with random integers in the range [min, max].
+    Both bounds are inclusive.
+*/
+void random_fill_int(Random* random, int* output, int count, int min, int max);
+
+static inline Uint64 random_rotl(Uint64 x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// Gets the largest float below a finite value, used to keep float ranges
+// from reaching their max when the scaled value rounds up.
+static inline float random_float_before(float value) {
+    union { float f; Uint32 u; } bits = { value };
+    if((bits.u & 0x7FFFFFFF) == 0)
+        bits.u = 0x80000001;
+    else if(bits.u & 0x80000000)
+        bits.u++;
+    else
+        bits.u--;
+    return bits.f;
+}
+
+static inline Uint64 random_next(Random* random) {
+    Uint64* s = random->state;
+    Uint64 result = random_rotl(s[1] * 5, 7) * 9;
+    Uint64 t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = random_rotl(s[3], 45);
+
+    return result;
+}
+
+static inline Uint32 random_next_u32(Random* random) {
+    // The upper bits have the best quality.
+    return (Uint32)(random_next(random) >> 32);
+}
+
+static inline float random_float(Random* random) {
+    return (random_next(random) >> 40) * (1.0f / 16777216.0f);
+}
+
+static inline double random_double(Random* random) {
+    return (random_next(random) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline Uint32 random_bounded(Random* random, Uint32 bound) {
+    // Lemire's multiply and reject method. The rejection only happens for
+    // a tiny fraction of values, and never when bound is a power of two.
+    Uint64 m = (Uint64)random_next_u32(random) * bound;
+    Uint32 low = (Uint32)m;
+    if(low < bound) {
+        Uint32 threshold = (Uint32)-bound % bound;
+        while(low < threshold) {
+            m = (Uint64)random_next_u32(random) * bound;
+            low = (Uint32)m;
+        }
+    }
+    return (Uint32)(m >> 32);
+}
+
+static inline int random_range(Random* random, int min, int max) {
+    Uint32 span = (Uint32)max - (Uint32)min + 1;
+
+    // The full integer range wraps around to 0.
+    if(span == 0)
+        return (int)random_next_u32(random);
+
+    return (int)((Uint32)min + random_bounded(random, span));
+}
+
+static inline float random_range_float(Random* random, float min, float max) {
+    float value = min + (max - min) * random_float(random);
+    if(value >= max && max > min)
+        value = random_float_before(max);
+    return value;
+}
+
+static inline SDL_bool random_bool(Random* random) {
+    return (SDL_bool)(random_next(random) >> 63);
+}
+
+#endif
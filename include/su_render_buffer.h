@@ -0,0 +1,186 @@
+#ifndef SDL_UTILS_RENDER_BUFFER_H
+#define SDL_UTILS_RENDER_BUFFER_H
+
+#include <SDL.h>
+#include "su_camera.h"
+#include "su_data_types.h"
+#include "su_utils.h"
+
+/**
+    The kinds of commands that can be recorded into a RenderCommandBuffer.
+*/
+typedef enum RenderCommandType {
+    RENDER_COMMAND_CLEAR,
+    RENDER_COMMAND_COPY,
+    RENDER_COMMAND_GEOMETRY,
+    RENDER_COMMAND_TARGET
+} RenderCommandType;
+
+/**
+    A single recorded draw call. Vertex and index data of geometry commands
+    live in the arena of the buffer that recorded them.
+*/
+typedef struct RenderCommand {
+    Uint64 sort_key;
+    Uint32 sequence;
+    RenderCommandType type;
+    Texture* texture;
+    union {
+        SDL_Color clear;
+        struct {
+            Rectangle src;
+            SDL_FRect dst;
+            double angle;
+            SDL_RendererFlip flip;
+            SDL_bool has_src;
+        } copy;
+        struct {
+            size_t vertex_offset;
+            size_t index_offset;
+            int vertex_count;
+            int index_count;
+        } geometry;
+    } data;
+} RenderCommand;
+
+/**
+    Records draw calls so they can be prepared away from the render thread.
+
+    SDL_Renderer can only be used from the thread that created it, but
+    recording into a buffer doesn't touch the renderer at all. Each worker
+    thread can fill its own buffer, then the render thread replays all of
+    them in sort key order using render_buffer_submit.
+
+    \remark A single buffer must not be used by more than one thread at a time.
+*/
+typedef struct RenderCommandBuffer {
+    RenderCommand* commands;
+    int count;
+    int capacity;
+
+    /**
+        Holds the vertices and indices of geometry commands.
+    */
+    Uint8* arena;
+    size_t arena_size;
+    size_t arena_capacity;
+
+    /**
+        Determines if the commands are already in sort key order.
+    */
+    SDL_bool sorted;
+} RenderCommandBuffer;
+
+/**
+    Initializes a RenderCommandBuffer allocated by the caller.
+*/
+void render_buffer_init(RenderCommandBuffer* buffer);
+
+/**
+    Allocates and initializes a new RenderCommandBuffer.
+
+    \return Allocated buffer on success, NULL otherwise.
+*/
+RenderCommandBuffer* render_buffer_create(void);
+
+/**
+    Frees the resources used by the buffer, without freeing the buffer itself.
+*/
+void render_buffer_free_resources(RenderCommandBuffer* buffer);
+
+/**
+    Frees the resources used by the buffer, then frees the buffer.
+*/
+void render_buffer_free(RenderCommandBuffer* buffer);
+
+/**
+    Removes every command from the buffer while keeping its memory so
+    the next frame can be recorded without allocating.
+*/
+static inline void render_buffer_reset(RenderCommandBuffer* buffer);
+
+/**
+    Creates a sort key from a layer and a depth within that layer.
+    Commands with smaller keys are replayed first.
+*/
+static inline Uint64 render_sort_key(Uint32 layer, Uint32 depth);
+
+/**
+    Records clearing the current render target with the specified color.
+
+    \return SDL_TRUE on success, SDL_FALSE if there wasn't enough memory.
+*/
+SDL_bool render_buffer_clear(RenderCommandBuffer* buffer, Uint64 sort_key, SDL_Color color);
+
+/**
+    Records copying part of a texture to the current render target.
+
+    \param src The part of the texture to copy, or NULL for the entire texture.
+    \param dst Where to draw the texture on the render target.
+    \param angle The rotation of the texture around the center of dst, in degrees.
+    \return SDL_TRUE on success, SDL_FALSE if there wasn't enough memory.
+*/
+SDL_bool render_buffer_copy(RenderCommandBuffer* buffer,
+                            Uint64 sort_key,
+                            Texture* texture,
+                            const Rectangle* src,
+                            const SDL_FRect* dst,
+                            double angle,
+                            SDL_RendererFlip flip);
+
+/**
+    Records drawing triangles to the current render target. The vertices
+    and indices are copied into the buffer.
+
+    \param texture The texture to draw from, or NULL for untextured triangles.
+    \param indices The vertex indices of the triangles, or NULL to use the
+                   vertices in order.
+    \return SDL_TRUE on success, SDL_FALSE if there wasn't enough memory.
+*/
+SDL_bool render_buffer_geometry(RenderCommandBuffer* buffer,
+                                Uint64 sort_key,
+                                Texture* texture,
+                                const SDL_Vertex* vertices,
+                                int vertex_count,
+                                const int* indices,
+                                int index_count);
+
+/**
+    Records changing the render target.
+
+    \param target The texture to draw to, or NULL to go back to the render
+                  target that was active when the buffers were submitted.
+    \return SDL_TRUE on success, SDL_FALSE if there wasn't enough memory.
+*/
+SDL_bool render_buffer_target(RenderCommandBuffer* buffer, Uint64 sort_key, Texture* target);
+
+/**
+    Sorts the commands of a buffer by their sort key. Commands with the
+    same key keep the order they were recorded in. Can be called from the
+    thread that recorded the buffer to take the work off the render thread.
+*/
+void render_buffer_sort(RenderCommandBuffer* buffer);
+
+/**
+    Replays the commands of several buffers using the renderer of a camera,
+    merged by sort key. When commands from different buffers share the same
+    key, the ones from earlier buffers are replayed first.
+
+    Must be called from the render thread. Usually called from a system in the
+    draw pass of a scene, so the commands are drawn to the camera's render target.
+
+    \return SDL_TRUE on success, SDL_FALSE if any command failed. Get the error using SDL_GetError.
+*/
+SDL_bool render_buffer_submit(Camera* camera, RenderCommandBuffer** buffers, int buffer_count);
+
+static inline void render_buffer_reset(RenderCommandBuffer* buffer) {
+    buffer->count = 0;
+    buffer->arena_size = 0;
+    buffer->sorted = SDL_TRUE;
+}
+
+static inline Uint64 render_sort_key(Uint32 layer, Uint32 depth) {
+    return ((Uint64)layer << 32) | depth;
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef SDL_UTILS_RESOLUTION_H
+#define SDL_UTILS_RESOLUTION_H
+
+#include <SDL.h>
+
+#include "su_camera.h"
+#include "su_utils.h"
+
+/**
+    Adjusts the render scale of a camera to hold a target frame rate.
+
+    SDL_Renderer doesn't expose GPU timings, so the controller watches two times:
+    the time the CPU spent on the frame, and the time between frames. The GPU
+    shows up in the latter, since presenting waits for it to catch up.
+*/
+typedef struct ResolutionController {
+    Camera* camera;
+
+    /**
+        The time budget of a frame, in milliseconds.
+    */
+    double target_ms;
+
+    float min_scale;
+    float max_scale;
+
+    /**
+        The amount the scale changes by at a time.
+    */
+    float step;
+
+    /**
+        The fraction of the budget the CPU time has to go over to lower the scale.
+    */
+    double high_watermark;
+
+    /**
+        The fraction of the budget the CPU time has to stay under to raise the scale.
+    */
+    double low_watermark;
+
+    /**
+        The number of frames to wait after a change before making another one,
+        so the averages can catch up with the new scale.
+    */
+    int cooldown_frames;
+
+    double cpu_ms;
+    double frame_ms;
+    int cooldown;
+    Uint64 last_frame;
+
+    /**
+        The lowest scale that missed frames recently. The scale isn't raised back
+        to it until retry reaches zero, to avoid bouncing between two scales.
+    */
+    float failed_scale;
+    int retry;
+} ResolutionController;
+
+/**
+    Initializes a resolution controller.
+
+    \param controller The controller to initialize.
+    \param camera The camera whose render scale is adjusted.
+    \param target_fps The frame rate to hold, usually the refresh rate of the display.
+*/
+void resolution_controller_init(ResolutionController* controller, Camera* camera, double target_fps);
+
+/**
+    Allocates and initializes a resolution controller. Returns NULL on failure.
+
+    \see resolution_controller_init
+*/
+ResolutionController* resolution_controller_create(Camera* camera, double target_fps);
+
+/**
+    Frees a resolution controller allocated with resolution_controller_create.
+*/
+void resolution_controller_free(ResolutionController* controller);
+
+/**
+    Sets the range of scales the controller can pick from and the amount it changes by at a time.
+    Defaults to 0.5 to 1 in steps of 0.1.
+*/
+void resolution_controller_set_limits(ResolutionController* controller, float min_scale, float max_scale, float step);
+
+/**
+    Forgets the frame times and failed scales measured so far, keeping the settings.
+    Use when the scene changes so the timings of the old one don't carry over.
+*/
+void resolution_controller_reset(ResolutionController* controller);
+
+/**
+    Updates the averages with the last frame and changes the scale if needed.
+    Called by scene_draw after presenting when the scene has a controller.
+
+    \param controller The controller to update.
+    \param cpu_ms The time the CPU spent updating and drawing the frame, in milliseconds.
+*/
+void resolution_controller_update(ResolutionController* controller, double cpu_ms);
+
+#endif
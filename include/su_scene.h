@@ -4,7 +4,70 @@
 #include <ecs.h>
 #include <SDL.h>
 
+#include "su_allocator.h"
+#include "su_animation.h"
 #include "su_camera.h"
+#include "su_jobs.h"
+#include "su_parallax.h"
+#include "su_random.h"
+#include "su_resolution.h"
+#include "su_scheduler.h"
+#include "su_text.h"
+
+/**
+    The stages of a frame that are timed by a scene.
+*/
+typedef enum SceneStage {
+    SCENE_STAGE_UPDATE,
+    SCENE_STAGE_CLEAR,
+    SCENE_STAGE_DRAW,
+    SCENE_STAGE_COMPOSITE,
+    SCENE_STAGE_GUI,
+    SCENE_STAGE_PRESENT,
+    SCENE_STAGE_COUNT
+} SceneStage;
+
+/**
+    Timing information about a single stage of a scene.
+*/
+typedef struct SceneStageStats {
+    /**
+        The number of times the stage has run since the stats were reset.
+    */
+    Uint64 count;
+
+    /**
+        The time the stage took the last time it ran, in milliseconds.
+    */
+    double last_ms;
+
+    /**
+        The total time spent in the stage since the stats were reset, in milliseconds.
+    */
+    double total_ms;
+
+    /**
+        The longest time the stage took since the stats were reset, in milliseconds.
+    */
+    double max_ms;
+} SceneStageStats;
+
+struct Scene;
+struct ScenePool;
+
+/**
+    Creates a scene for a pool when it doesn't have one to reuse.
+    Returns NULL on failure.
+*/
+typedef struct Scene* (*ScenePoolCreateFn)(void* data);
+
+/**
+    Resets a scene before it's put back in a pool, usually by removing every
+    entity from its world while keeping the storage of the world around.
+
+    \return SDL_TRUE if the scene can be reused, SDL_FALSE to free it instead.
+*/
+typedef SDL_bool (*ScenePoolResetFn)(struct Scene* scene, void* data);
 
 /**
     Defines a self contained game scene.
@@ -16,24 +79,99 @@ typedef struct Scene {
     EcsSequentialSystem* draw;
     EcsSequentialSystem* gui;
     Camera* camera;
+    Parallax* parallax;
+    TextRenderer* text;
+    Animator* animator;
+    ResolutionController* resolution;
+    JobSystem* jobs;
+    FrameArena* frame_arena;
+    struct ScenePool* pool;
+    Random random;
+
+    /**
+        The seed passed to scene_seed_random, restored when the scene goes back
+        to a pool. Only used if random_seeded is set.
+    */
+    Uint64 random_seed;
+    SDL_bool random_seeded;
+    Scheduler scheduler;
     EcsWorld world;
     SDL_bool free_systems;
     SDL_bool free_camera;
+
+    /**
+        Determines if freeing this scene also frees its world. Set by scene_init,
+        clear it for scenes that share their world or don't use one.
+    */
+    SDL_bool free_world;
+    SDL_bool paused;
     Uint8 r;
     Uint8 g;
     Uint8 b;
     Uint8 a;
+    SceneStageStats stats[SCENE_STAGE_COUNT];
+    Uint64 stats_start;
 } Scene;
 
+/**
+    Keeps scenes that are done with so they can be reused instead of
+    freeing their world, systems and camera and creating them again.
+    Useful for scenes that are left and entered often, like restarting
+    a level or going back and forth between a menu and the game.
+
+    Scenes taken from a pool go back to it when they're popped with
+    free_scene set, including by scene_change.
+*/
+typedef struct ScenePool {
+    struct Scene** scenes;
+    int count;
+    int capacity;
+
+    /**
+        The scenes taken from the pool that haven't been put back yet, so they
+        can be detached from the pool when it's freed.
+    */
+    struct Scene** acquired;
+    int acquired_count;
+    int acquired_capacity;
+    ScenePoolCreateFn create;
+    ScenePoolResetFn reset;
+    void* data;
+} ScenePool;
+
+/**
+    Steps many independent scenes in parallel, for running simulations
+    without a display like bots or server side validation.
+*/
+typedef struct SceneBatch {
+    Scene** scenes;
+    int count;
+    int capacity;
+    JobSystem* jobs;
+
+    /**
+        The number of scene updates run by the batch since the stats were reset.
+    */
+    Uint64 ticks;
+
+    /**
+        The time spent running the batch since the stats were reset, in seconds.
+    */
+    double seconds;
+} SceneBatch;
+
 /**
     Initializes a scene.
 
     \param scene The scene to initialize.
     \param world The world to be used by this scene.
-    \param camera The camera to be used by this scene.
-    \param update The update system to be used by this scene.
-    \param draw The draw system to be used by this scene.
-    \param gui The gui system to be used by this scene.
+    \param camera The camera to be used by this scene. Can be NULL to make
+                  a headless scene, which only updates and doesn't need
+                  SDL video to be initialized.
+    \param update The update system to be used by this scene. Can be NULL for
+                  a scene driven only by its scheduler and animator.
+    \param draw The draw system to be used by this scene. Can be NULL for a headless scene.
+    \param gui The gui system to be used by this scene. Can be NULL for a headless scene.
     \param free_systems Determines if freeing this scene also frees the
                         systems used by it.
     \param free_camera Determines if freeing this scene also frees the
@@ -52,10 +190,11 @@ void scene_init(Scene* scene,
     Allocates and initializes a scene. Returns NULL on failure.
 
     \param world The world to be used by this scene.
-    \param camera The camera to be used by this scene.
-    \param update The update system to be used by this scene.
-    \param draw The draw system to be used by this scene.
-    \param gui The gui system to be used by this scene.
+    \param camera The camera to be used by this scene. Can be NULL to make a headless scene.
+    \param update The update system to be used by this scene. Can be NULL for
+                  a scene driven only by its scheduler and animator.
+    \param draw The draw system to be used by this scene. Can be NULL for a headless scene.
+    \param gui The gui system to be used by this scene. Can be NULL for a headless scene.
     \param free_systems Determines if freeing this scene also frees the
                         systems used by it.
     \param free_camera Determines if freeing this scene also frees the
@@ -82,15 +221,55 @@ void scene_free_resources(Scene* scene);
 void scene_free(Scene* scene);
 
 /**
-    Causes the scene to update.
+    Causes the scene to update. Advances the scene scheduler and animator, then
+    runs the update system. Does nothing while the scene is paused.
 */
 void scene_update(Scene* scene, float delta);
 
 /**
-    Causes the scene to draw.
+    Updates the scene with a fixed time step. The scheduler is advanced by the
+    specified number of milliseconds instead of following its clock.
+
+    Unlike scene_update, this doesn't run the main thread jobs or record metrics,
+    so it can be called from a job as long as no other thread uses the scene.
+
+    \param scene The scene to update.
+    \param delta The time passed to the update system.
+    \param milliseconds The time to advance the scheduler by.
+*/
+void scene_update_fixed(Scene* scene, float delta, Uint32 milliseconds);
+
+/**
+    Causes the scene to draw. Does nothing for a headless scene.
 */
 void scene_draw(Scene* scene, float delta);
 
+/**
+    Determines if the scene is headless, meaning it doesn't have a camera to draw to.
+*/
+static inline SDL_bool scene_headless(Scene* scene);
+
+/**
+    Pauses the scene. The update system stops running and the timers
+    of the scene scheduler stop progressing. The scene still draws.
+*/
+void scene_pause(Scene* scene);
+
+/**
+    Resumes the scene if it had been paused.
+*/
+void scene_resume(Scene* scene);
+
+/**
+    Determines if the scene is currently paused.
+*/
+static inline SDL_bool scene_paused(Scene* scene);
+
+/**
+    Gets the scheduler used to run the timers of the scene.
+*/
+static inline Scheduler* scene_get_scheduler(Scene* scene);
+
 /**
     Sets the background color used to clear any previous drawing. Defaults
     to black. Returns SDL_FALSE if there was a problem.
@@ -103,6 +282,108 @@ SDL_bool scene_set_background(Scene* scene, Uint32 color);
 */
 Uint32 scene_get_background(Scene* scene);
 
+/**
+    Sets the parallax background that is drawn after the scene is cleared
+    and before the draw system runs. The parallax is not freed with the scene.
+
+    \param parallax The parallax to draw, or NULL to remove it.
+*/
+static inline void scene_set_parallax(Scene* scene, Parallax* parallax);
+
+/**
+    Sets the text renderer that is flushed after the gui system runs, so all
+    of the text queued by the gui system is drawn in a few batches.
+    The text renderer is not freed with the scene.
+
+    \param text The text renderer to flush, or NULL to remove it.
+*/
+static inline void scene_set_text_renderer(Scene* scene, TextRenderer* text);
+
+/**
+    Sets the animator that is advanced at the start of every scene_update, before
+    the update system runs, so the update and draw systems see the current frames.
+    The animator is not freed with the scene.
+
+    \param animator The animator to advance, or NULL to remove it.
+*/
+static inline void scene_set_animator(Scene* scene, Animator* animator);
+
+/**
+    Sets the controller that adjusts the render scale of the camera after
+    every frame, based on how long the scene took to update and draw.
+    The controller is not freed with the scene.
+
+    \param resolution The controller to use, or NULL to remove it.
+*/
+static inline void scene_set_resolution_controller(Scene* scene, ResolutionController* resolution);
+
+/**
+    Sets the job system used by the scene. The jobs queued for the main
+    thread are run at the start of every scene_update, even while the scene
+    is paused. The job system is not freed with the scene.
+
+    \param jobs The job system to use, or NULL to remove it.
+*/
+static inline void scene_set_job_system(Scene* scene, JobSystem* jobs);
+
+/**
+    Gets the job system used by the scene, or NULL if it doesn't have one.
+*/
+static inline JobSystem* scene_get_job_system(Scene* scene);
+
+/**
+    Sets the arena used for memory that only lives for a frame. The arena
+    is reset at the end of every scene_draw, once the frame is presented.
+    Headless scenes never draw, so theirs is reset at the end of every
+    scene_update and scene_update_fixed instead, including the updates run
+    by scene_batch_run. Scenes in a batch can run on different threads, so
+    each one needs its own arena. The arena is not freed with the scene.
+
+    \param arena The arena to reset, or NULL to remove it.
+*/
+static inline void scene_set_frame_arena(Scene* scene, FrameArena* arena);
+
+/**
+    Gets the frame arena of the scene, or NULL if it doesn't have one.
+*/
+static inline FrameArena* scene_get_frame_arena(Scene* scene);
+
+/**
+    Reseeds the random number generator of the scene. Scenes are seeded
+    from the performance counter when initialized, so call this with a fixed
+    seed to get the same sequence every run. The seed is kept when the scene
+    goes back to a pool, so the next user of the scene gets the same sequence.
+*/
+static inline void scene_seed_random(Scene* scene, Uint64 seed);
+
+/**
+    Gets the random number generator of the scene.
+*/
+static inline Random* scene_get_random(Scene* scene);
+
+/**
+    Gets the timing information of a stage of the scene.
+*/
+static inline SceneStageStats scene_get_stats(Scene* scene, SceneStage stage);
+
+/**
+    Resets the timing information of every stage of the scene.
+*/
+void scene_reset_stats(Scene* scene);
+
+/**
+    Gets the name of a scene stage, as used by scene_write_stats.
+*/
+const char* scene_stage_name(SceneStage stage);
+
+/**
+    Writes the timing information of the scene as a single line of JSON,
+    including the number of frames drawn per second since the stats were reset.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool scene_write_stats(Scene* scene, SDL_RWops* output);
+
 /**
     Pushes a scene to be the current scene.
 */
@@ -117,6 +398,7 @@ void scene_change(Scene* scene);
 
 /**
     Pops the current scene from the stack, optionally freeing it.
+    Scenes that belong to a pool are put back in it instead of being freed.
 */
 Scene* scene_pop(bool free_scene);
 
@@ -125,4 +407,218 @@ Scene* scene_pop(bool free_scene);
 */
 Scene* scene_current(void);
 
+/**
+    Initializes a scene pool.
+
+    \param pool The pool to initialize.
+    \param create Creates a scene when the pool is empty. Can be NULL, in which
+                  case scene_pool_acquire returns NULL when the pool is empty.
+    \param reset Resets a scene when it's put back in the pool. Can be NULL.
+                 See scene_pool_release for what the pool resets itself.
+    \param data User data passed to create and reset.
+*/
+void scene_pool_init(ScenePool* pool, ScenePoolCreateFn create, ScenePoolResetFn reset, void* data);
+
+/**
+    Allocates and initializes a scene pool. Returns NULL on failure.
+
+    \see scene_pool_init
+*/
+ScenePool* scene_pool_create(ScenePoolCreateFn create, ScenePoolResetFn reset, void* data);
+
+/**
+    Frees the scenes in the pool and the resources used by the pool,
+    without freeing the pool itself. Scenes taken from the pool that
+    haven't been put back are detached from it, whether they're on the
+    scene stack or not, and are freed instead of going back to it.
+*/
+void scene_pool_free_resources(ScenePool* pool);
+
+/**
+    Frees the scenes in the pool, then frees the pool itself.
+
+    \see scene_pool_free_resources
+*/
+void scene_pool_free(ScenePool* pool);
+
+/**
+    Takes a scene from the pool, or creates one if the pool is empty.
+    Use in place of scene_create for scenes that belong to the pool.
+
+    \return The scene, or NULL on failure.
+*/
+Scene* scene_pool_acquire(ScenePool* pool);
+
+/**
+    Resets a scene and puts it in the pool. The scene is freed if it
+    can't be reset or there isn't enough memory to keep it.
+
+    The pool clears the scheduler, reseeds the random number generator with
+    the seed set by scene_seed_random or from the performance counter if it
+    wasn't set, resumes the scene and resets its stats. It also moves the camera back to
+    the origin with no rotation and a render scale of 1, and resets the
+    measurements of the resolution controller.
+
+    Everything else carries over to the next user of the scene: the world,
+    the systems, the camera size, the background color, and the parallax,
+    text renderer, animator, resolution controller, job system and frame
+    arena along with their contents, such as the animations that are still
+    playing. Reset those in the reset function of the pool.
+
+    \param pool The pool to put the scene in.
+    \param scene The scene to reuse. It can't be on the scene stack.
+    \return SDL_TRUE if the scene was put in the pool, SDL_FALSE if it was freed.
+*/
+SDL_bool scene_pool_release(ScenePool* pool, Scene* scene);
+
+/**
+    Gets the number of scenes waiting in the pool.
+*/
+static inline int scene_pool_get_count(ScenePool* pool);
+
+/**
+    Initializes a scene batch.
+
+    \param batch The batch to initialize.
+    \param jobs The job system used to step the scenes in parallel.
+                Can be NULL to step them one after the other on the calling thread.
+*/
+void scene_batch_init(SceneBatch* batch, JobSystem* jobs);
+
+/**
+    Allocates and initializes a scene batch. Returns NULL on failure.
+
+    \see scene_batch_init
+*/
+SceneBatch* scene_batch_create(JobSystem* jobs);
+
+/**
+    Frees the resources used by the batch without freeing the batch itself.
+    The scenes in the batch are not freed.
+*/
+void scene_batch_free_resources(SceneBatch* batch);
+
+/**
+    Frees the resources used by the batch, then frees the batch itself.
+    The scenes in the batch are not freed.
+*/
+void scene_batch_free(SceneBatch* batch);
+
+/**
+    Adds a scene to the batch. The scene shouldn't share its world,
+    systems or any other state with another scene in the batch.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool scene_batch_add(SceneBatch* batch, Scene* scene);
+
+/**
+    Removes a scene from the batch. The last scene in the
+    batch takes its place, so the order isn't kept.
+
+    \return SDL_TRUE if the scene was in the batch, SDL_FALSE otherwise.
+*/
+SDL_bool scene_batch_remove(SceneBatch* batch, Scene* scene);
+
+/**
+    Steps every scene in the batch with scene_update_fixed, spreading
+    the scenes across the threads of the job system. Returns once all
+    of them are done. A scene that is paused stops stepping.
+
+    \param batch The batch to run.
+    \param delta The time passed to the update systems each step.
+    \param milliseconds The time to advance the scene schedulers by each step.
+    \param steps The number of times to update each scene.
+
+    \remark The scenes are updated on the worker threads, so anything their
+            update systems and timers allocate, like a scheduler growing to fit
+            new timers, goes through the library allocator from those threads.
+            Only use a thread-safe allocator with a batch (see su_set_allocator),
+            and keep the update systems away from state shared between scenes,
+            like the input manager and the scene stack.
+*/
+void scene_batch_run(SceneBatch* batch, float delta, Uint32 milliseconds, int steps);
+
+/**
+    Gets the number of scene updates run per second by the batch
+    since the stats were reset, counting each scene separately.
+*/
+static inline double scene_batch_get_ticks_per_second(SceneBatch* batch);
+
+/**
+    Resets the number of ticks and the time counted by the batch.
+*/
+static inline void scene_batch_reset_stats(SceneBatch* batch);
+
+static inline SDL_bool scene_paused(Scene* scene) {
+    return scene->paused;
+}
+
+static inline SDL_bool scene_headless(Scene* scene) {
+    return scene->camera == NULL;
+}
+
+static inline Scheduler* scene_get_scheduler(Scene* scene) {
+    return &scene->scheduler;
+}
+
+static inline void scene_set_parallax(Scene* scene, Parallax* parallax) {
+    scene->parallax = parallax;
+}
+
+static inline void scene_set_text_renderer(Scene* scene, TextRenderer* text) {
+    scene->text = text;
+}
+
+static inline void scene_set_animator(Scene* scene, Animator* animator) {
+    scene->animator = animator;
+}
+
+static inline void scene_set_resolution_controller(Scene* scene, ResolutionController* resolution) {
+    scene->resolution = resolution;
+}
+
+static inline void scene_set_job_system(Scene* scene, JobSystem* jobs) {
+    scene->jobs = jobs;
+}
+
+static inline JobSystem* scene_get_job_system(Scene* scene) {
+    return scene->jobs;
+}
+
+static inline void scene_set_frame_arena(Scene* scene, FrameArena* arena) {
+    scene->frame_arena = arena;
+}
+
+static inline FrameArena* scene_get_frame_arena(Scene* scene) {
+    return scene->frame_arena;
+}
+
+static inline void scene_seed_random(Scene* scene, Uint64 seed) {
+    scene->random_seed = seed;
+    scene->random_seeded = SDL_TRUE;
+    random_seed(&scene->random, seed);
+}
+
+static inline Random* scene_get_random(Scene* scene) {
+    return &scene->random;
+}
+
+static inline SceneStageStats scene_get_stats(Scene* scene, SceneStage stage) {
+    return scene->stats[stage];
+}
+
+static inline int scene_pool_get_count(ScenePool* pool) {
+    return pool->count;
+}
+
+static inline double scene_batch_get_ticks_per_second(SceneBatch* batch) {
+    return batch->seconds > 0 ? (double)batch->ticks / batch->seconds : 0;
+}
+
+static inline void scene_batch_reset_stats(SceneBatch* batch) {
+    batch->ticks = 0;
+    batch->seconds = 0;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,191 @@
+#ifndef SDL_UTILS_SCHEDULER_H
+#define SDL_UTILS_SCHEDULER_H
+
+#include <SDL.h>
+
+#include "su_timer.h"
+#include "su_utils.h"
+
+#define SCHEDULER_SLOT_BITS 8
+#define SCHEDULER_SLOTS (1 << SCHEDULER_SLOT_BITS)
+#define SCHEDULER_LEVELS 4
+
+/**
+    Identifies a scheduled timer. Handles of cancelled or finished timers
+    are never reused, so they are always safe to cancel.
+*/
+typedef Uint64 ScheduleHandle;
+
+#define SCHEDULE_HANDLE_INVALID ((ScheduleHandle)0)
+
+typedef struct Scheduler Scheduler;
+
+/**
+    A function called when a scheduled timer fires. It's safe to schedule
+    and cancel timers, including the one that fired, from inside the callback.
+*/
+typedef void (*ScheduleFn)(Scheduler* scheduler, ScheduleHandle handle, void* data);
+
+typedef struct SchedulerEntry {
+    Uint64 deadline;
+    Uint32 period;
+    Uint32 generation;
+    Uint32 event_type;
+    ScheduleFn callback;
+    void* data;
+    int prev;
+    int next;
+    int slot;
+} SchedulerEntry;
+
+/**
+    Runs a large number of one-shot and repeating timers with O(1) scheduling
+    and cancellation, using a hierarchical timing wheel with millisecond resolution.
+
+    Time is measured with a TimerUtil, so the scheduler follows the same
+    start, pause and resume semantics.
+*/
+struct Scheduler {
+    SchedulerEntry* entries;
+    int entry_count;
+    int entry_capacity;
+    int free_list;
+    int active;
+    int wheel[SCHEDULER_LEVELS * SCHEDULER_SLOTS];
+    Uint64 now;
+    Uint32 last_ticks;
+    TimerUtil clock;
+};
+
+/**
+    Initializes a scheduler and starts its clock.
+*/
+void scheduler_init(Scheduler* scheduler);
+
+/**
+    Allocates and initializes a scheduler. Returns NULL on failure.
+*/
+Scheduler* scheduler_create(void);
+
+/**
+    Cancels every timer and restarts the clock of the scheduler, keeping
+    its storage so the timers added afterwards don't need to allocate.
+    Don't call from inside a timer callback.
+*/
+void scheduler_clear(Scheduler* scheduler);
+
+/**
+    Cancels every timer and frees the resources used by the scheduler
+    without freeing the scheduler itself.
+*/
+void scheduler_free_resources(Scheduler* scheduler);
+
+/**
+    Frees the resources used by the scheduler, then frees the scheduler itself.
+    Only use if the scheduler was allocated with scheduler_create.
+*/
+void scheduler_free(Scheduler* scheduler);
+
+/**
+    Schedules a callback.
+
+    \param scheduler The scheduler to add the timer to.
+    \param delay The number of milliseconds until the timer fires.
+                 A delay of 0 fires on the next update.
+    \param period The number of milliseconds between repeats after the first
+                  time the timer fires, or 0 to only fire once.
+    \param callback The function to call when the timer fires.
+    \param data User data passed to the callback.
+    \return A handle to the timer, or SCHEDULE_HANDLE_INVALID on failure.
+            Get the error using SDL_GetError.
+*/
+ScheduleHandle scheduler_add(Scheduler* scheduler, Uint32 delay, Uint32 period, ScheduleFn callback, void* data);
+
+/**
+    Schedules an SDL_UserEvent to be pushed onto the event queue.
+
+    \param scheduler The scheduler to add the timer to.
+    \param delay The number of milliseconds until the timer fires.
+                 A delay of 0 fires on the next update.
+    \param period The number of milliseconds between repeats after the first
+                  time the timer fires, or 0 to only fire once.
+    \param event_type The type of the event, usually from SDL_RegisterEvents.
+    \param data Stored in the data1 field of the event.
+    \return A handle to the timer, or SCHEDULE_HANDLE_INVALID on failure.
+            Get the error using SDL_GetError.
+*/
+ScheduleHandle scheduler_add_event(Scheduler* scheduler, Uint32 delay, Uint32 period, Uint32 event_type, void* data);
+
+/**
+    Cancels a timer. Returns SDL_FALSE if the timer had already finished or was cancelled.
+*/
+SDL_bool scheduler_cancel(Scheduler* scheduler, ScheduleHandle handle);
+
+/**
+    Determines if a timer is still waiting to fire.
+*/
+SDL_bool scheduler_is_scheduled(Scheduler* scheduler, ScheduleHandle handle);
+
+/**
+    Gets the number of milliseconds until a timer fires, or 0 if it isn't scheduled.
+*/
+Uint32 scheduler_get_remaining(Scheduler* scheduler, ScheduleHandle handle);
+
+/**
+    Advances the scheduler to the current time of its clock,
+    firing every timer that is due. Does nothing while paused.
+*/
+void scheduler_update(Scheduler* scheduler);
+
+/**
+    Advances the scheduler by a fixed amount of time, independent of its clock.
+    Useful for fixed time steps and replays.
+*/
+void scheduler_advance(Scheduler* scheduler, Uint32 milliseconds);
+
+/**
+    Pauses the clock of the scheduler. Timers don't progress while paused.
+*/
+static inline void scheduler_pause(Scheduler* scheduler);
+
+/**
+    Resumes the clock of the scheduler if it had been paused.
+*/
+static inline void scheduler_resume(Scheduler* scheduler);
+
+/**
+    Determines if the scheduler is currently paused.
+*/
+static inline SDL_bool scheduler_paused(Scheduler* scheduler);
+
+/**
+    Gets the number of milliseconds the scheduler has advanced.
+*/
+static inline Uint64 scheduler_get_time(Scheduler* scheduler);
+
+/**
+    Gets the number of timers waiting to fire.
+*/
+static inline int scheduler_get_count(Scheduler* scheduler);
+
+static inline void scheduler_pause(Scheduler* scheduler) {
+    timer_pause(&scheduler->clock);
+}
+
+static inline void scheduler_resume(Scheduler* scheduler) {
+    timer_resume(&scheduler->clock);
+}
+
+static inline SDL_bool scheduler_paused(Scheduler* scheduler) {
+    return timer_paused(&scheduler->clock);
+}
+
+static inline Uint64 scheduler_get_time(Scheduler* scheduler) {
+    return scheduler->now;
+}
+
+static inline int scheduler_get_count(Scheduler* scheduler) {
+    return scheduler->active;
+}
+
+#endif
@@ -0,0 +1,266 @@
+#ifndef SDL_UTILS_TEXT_H
+#define SDL_UTILS_TEXT_H
+
+#include <SDL.h>
+
+#include "su_atlas.h"
+#include "su_data_types.h"
+#include "su_utils.h"
+
+/**
+    The number of flushes a cached run of text is kept for after it was last drawn.
+*/
+#define TEXT_RUN_MAX_AGE 120
+
+/**
+    Describes where a glyph is in a font image, and how it's placed.
+*/
+typedef struct FontGlyphInfo {
+    Uint32 codepoint;
+
+    /**
+        The bounds of the glyph in the font image.
+    */
+    Rectangle rect;
+
+    /**
+        The offset from the pen position to the top left corner of the glyph.
+    */
+    int x_offset;
+    int y_offset;
+
+    /**
+        How far the pen moves after the glyph.
+    */
+    int advance;
+} FontGlyphInfo;
+
+typedef struct FontGlyph {
+    Uint32 codepoint;
+
+    /**
+        The glyph image in the atlas, or ATLAS_REGION_INVALID
+        if the glyph is blank, like a space.
+    */
+    AtlasRegionId region;
+
+    int x_offset;
+    int y_offset;
+    int width;
+    int height;
+    int advance;
+} FontGlyph;
+
+/**
+    A bitmap font whose glyphs are stored in a shared TextureAtlas,
+    so text from every font can be drawn without switching textures.
+*/
+typedef struct Font {
+    TextureAtlas* atlas;
+
+    /**
+        The glyphs of the font, sorted by codepoint.
+    */
+    FontGlyph* glyphs;
+    int glyph_count;
+
+    /**
+        The index of the glyph of each ASCII character, or -1.
+    */
+    int ascii[128];
+
+    /**
+        The index of the glyph drawn for missing characters, or -1 to skip them.
+    */
+    int fallback;
+
+    int line_height;
+} Font;
+
+/**
+    The laid out glyphs of a string, cached so the string doesn't
+    have to be laid out again while it stays the same.
+*/
+typedef struct TextRun {
+    Font* font;
+    char* text;
+    size_t length;
+    Uint32 hash;
+    SDL_Color color;
+
+    /**
+        Four vertices per glyph, relative to the position the text is drawn at.
+    */
+    SDL_Vertex* vertices;
+
+    /**
+        The texture of each glyph.
+    */
+    Texture** textures;
+    int quad_count;
+
+    /**
+        The atlas generation the texture coordinates were computed for.
+    */
+    int generation;
+
+    Uint32 last_used;
+    struct TextRun* next;
+} TextRun;
+
+/**
+    The vertices of every glyph drawn from a single texture during a frame.
+*/
+typedef struct TextBatch {
+    Texture* texture;
+    SDL_Vertex* vertices;
+    int quad_count;
+    int quad_capacity;
+} TextBatch;
+
+/**
+    Collects the text drawn during a frame and draws it with one
+    SDL_RenderGeometry call per atlas page.
+
+    Strings are laid out the first time they're drawn and cached, so drawing
+    text that didn't change since the last frame only copies its vertices.
+*/
+typedef struct TextRenderer {
+    SDL_Renderer* renderer;
+
+    TextRun** buckets;
+    int bucket_count;
+    int run_count;
+
+    TextBatch* batches;
+    int batch_count;
+    int batch_capacity;
+
+    /**
+        Indices shared by every batch, six per quad.
+    */
+    int* indices;
+    int index_quads;
+
+    Uint32 frame;
+} TextRenderer;
+
+/**
+    Initializes a font by copying its glyphs into an atlas.
+
+    \param font The font to initialize.
+    \param atlas The atlas to store the glyphs in. Must outlive the font.
+    \param surface The image containing the glyphs. Can be freed afterwards.
+    \param glyphs The location and metrics of each glyph.
+    \param glyph_count The number of glyphs.
+    \param line_height The distance between two lines of text.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool font_init(Font* font, TextureAtlas* atlas, SDL_Surface* surface, const FontGlyphInfo* glyphs, int glyph_count, int line_height);
+
+/**
+    Initializes a monospaced font from an image where the glyphs are laid
+    out in a grid, left to right then top to bottom, in codepoint order.
+
+    \param font The font to initialize.
+    \param atlas The atlas to store the glyphs in. Must outlive the font.
+    \param surface The image containing the glyphs. Can be freed afterwards.
+    \param first_codepoint The codepoint of the glyph in the top left cell.
+    \param cell_width The width of each cell, which is also the advance of each glyph.
+    \param cell_height The height of each cell, which is also the line height.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool font_init_grid(Font* font, TextureAtlas* atlas, SDL_Surface* surface, Uint32 first_codepoint, int cell_width, int cell_height);
+
+/**
+    Allocates and initializes a font. Returns NULL on failure.
+
+    \see font_init
+*/
+Font* font_create(TextureAtlas* atlas, SDL_Surface* surface, const FontGlyphInfo* glyphs, int glyph_count, int line_height);
+
+/**
+    Frees the glyphs of a font without freeing the font itself.
+    The glyph images stay in the atlas.
+*/
+void font_free_resources(Font* font);
+
+/**
+    Frees the resources used by the font, then frees the font itself.
+    Only use if the font was allocated with font_create.
+*/
+void font_free(Font* font);
+
+/**
+    Gets the glyph drawn for a character, or NULL if the font has no glyph
+    for the character and no fallback.
+*/
+FontGlyph* font_get_glyph(Font* font, Uint32 codepoint);
+
+/**
+    Sets the character drawn in place of characters the font doesn't have.
+    Defaults to '?' when the font has it.
+*/
+void font_set_fallback(Font* font, Uint32 codepoint);
+
+/**
+    Gets the size of a string once it's drawn.
+
+    \param font The font used to draw the string.
+    \param text The UTF-8 string to measure. Can contain newlines.
+    \param width Set to the width of the widest line. Can be NULL.
+    \param height Set to the height of every line. Can be NULL.
+*/
+void font_measure(Font* font, const char* text, int* width, int* height);
+
+/**
+    Initializes a text renderer.
+*/
+SDL_bool text_renderer_init(TextRenderer* text, SDL_Renderer* renderer);
+
+/**
+    Allocates and initializes a text renderer. Returns NULL on failure.
+*/
+TextRenderer* text_renderer_create(SDL_Renderer* renderer);
+
+/**
+    Frees the resources used by a text renderer without freeing the renderer itself.
+*/
+void text_renderer_free_resources(TextRenderer* text);
+
+/**
+    Frees the resources used by a text renderer, then frees the renderer itself.
+    Only use if it was allocated with text_renderer_create.
+*/
+void text_renderer_free(TextRenderer* text);
+
+/**
+    Queues a string to be drawn by the next text_renderer_flush.
+
+    \param text The text renderer.
+    \param font The font to draw the string with.
+    \param string The UTF-8 string to draw. Can contain newlines.
+    \param x The left edge of the text, in screen coordinates.
+    \param y The top edge of the text, in screen coordinates.
+    \param color The color of the text.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool text_draw(TextRenderer* text, Font* font, const char* string, float x, float y, SDL_Color color);
+
+/**
+    Draws every string queued since the last flush, then frees the cached
+    runs that haven't been drawn for TEXT_RUN_MAX_AGE flushes.
+
+    Text drawn from different atlas pages is drawn one page at a time, so
+    overlapping strings that use different pages may not be drawn in order.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool text_renderer_flush(TextRenderer* text);
+
+/**
+    Frees every cached run.
+*/
+void text_renderer_clear_cache(TextRenderer* text);
+
+#endif
@@ -0,0 +1,266 @@
+#ifndef SDL_UTILS_TILEMAP_H
+#define SDL_UTILS_TILEMAP_H
+
+#include <SDL.h>
+#include "su_camera.h"
+#include "su_data_types.h"
+#include "su_utils.h"
+
+/**
+    The id of a tile that isn't drawn. Any other id n refers to the
+    (n - 1)th tile in the tileset, counting left to right, top to bottom.
+*/
+#define TILE_EMPTY 0
+
+/**
+    The pixel format used by the cached chunk textures. It needs an alpha
+    channel so empty tiles stay transparent.
+*/
+#define TILEMAP_CHUNK_FORMAT SDL_PIXELFORMAT_ARGB8888
+
+typedef Uint16 TileId;
+
+/**
+    A square block of tiles that is drawn into its own texture.
+
+    \remark The tiles are only allocated once a tile in the chunk is set,
+            so large sparse maps don't pay for empty space.
+*/
+typedef struct TilemapChunk {
+    /**
+        The tiles of every layer in this chunk, stored layer by layer, row by row.
+        NULL if no tile has been set in this chunk.
+    */
+    TileId* tiles;
+
+    /**
+        The pre-rendered contents of the chunk. NULL if the chunk hasn't been
+        baked yet, or if it was evicted to stay under the memory budget.
+    */
+    Texture* texture;
+
+    /**
+        The neighbours of this chunk in the least recently used list of
+        baked chunks.
+    */
+    struct TilemapChunk* lru_prev;
+    struct TilemapChunk* lru_next;
+
+    /**
+        The last frame this chunk was drawn in.
+    */
+    Uint32 frame;
+
+    /**
+        Determines if the tiles changed since the texture was baked.
+    */
+    SDL_bool dirty;
+} TilemapChunk;
+
+/**
+    Defines a layered tile map that's split into fixed size chunks. Each chunk is
+    rendered to a cached texture once, so drawing the map only costs one copy per
+    visible chunk.
+
+    You should never alter the fields of the tilemap directly, instead
+    use the provided functions to do so.
+*/
+typedef struct Tilemap {
+    /**
+        The texture that holds the tile images.
+    */
+    Texture* tileset;
+
+    /**
+        The number of tiles in each row of the tileset.
+    */
+    int tileset_columns;
+
+    /**
+        The size of a single tile in pixels.
+    */
+    int tile_width;
+    int tile_height;
+
+    /**
+        The size of the map in tiles.
+    */
+    int width;
+    int height;
+
+    /**
+        The number of tile layers. Layers are drawn in order, so layer 0 is at the bottom.
+    */
+    int layer_count;
+
+    /**
+        The number of tiles along each side of a chunk.
+    */
+    int chunk_size;
+
+    /**
+        The number of chunks along each axis of the map.
+    */
+    int chunks_x;
+    int chunks_y;
+
+    /**
+        The chunks of the map, stored row by row.
+    */
+    TilemapChunk* chunks;
+
+    /**
+        The maximum number of bytes that the baked chunk textures should use,
+        or 0 if there is no limit.
+    */
+    size_t memory_budget;
+
+    /**
+        The number of bytes currently used by baked chunk textures.
+    */
+    size_t memory_used;
+
+    /**
+        The most and least recently drawn baked chunks.
+    */
+    TilemapChunk* lru_head;
+    TilemapChunk* lru_tail;
+
+    /**
+        Incremented every time the map is drawn.
+    */
+    Uint32 frame;
+} Tilemap;
+
+/**
+    Initializes a Tilemap allocated by the caller. All tiles start as TILE_EMPTY.
+
+    \param tilemap The tilemap to initialize.
+    \param tileset The texture that holds the tile images. It's not owned by the tilemap.
+    \param tile_width The width of a tile in pixels.
+    \param tile_height The height of a tile in pixels.
+    \param width The width of the map in tiles.
+    \param height The height of the map in tiles.
+    \param layer_count The number of tile layers.
+    \param chunk_size The number of tiles along each side of a chunk.
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool tilemap_init(Tilemap* tilemap,
+                      Texture* tileset,
+                      int tile_width,
+                      int tile_height,
+                      int width,
+                      int height,
+                      int layer_count,
+                      int chunk_size);
+
+/**
+    Allocates and initializes a new Tilemap.
+
+    \param tileset The texture that holds the tile images. It's not owned by the tilemap.
+    \param tile_width The width of a tile in pixels.
+    \param tile_height The height of a tile in pixels.
+    \param width The width of the map in tiles.
+    \param height The height of the map in tiles.
+    \param layer_count The number of tile layers.
+    \param chunk_size The number of tiles along each side of a chunk.
+    \return Allocated tilemap on success, NULL otherwise. Get the error using SDL_GetError.
+*/
+Tilemap* tilemap_create(Texture* tileset,
+                        int tile_width,
+                        int tile_height,
+                        int width,
+                        int height,
+                        int layer_count,
+                        int chunk_size);
+
+/**
+    Frees the resources used by the tilemap, without freeing the tilemap itself.
+    The tileset texture is not destroyed.
+*/
+void tilemap_free_resources(Tilemap* tilemap);
+
+/**
+    Frees the resources used by the tilemap, then frees the tilemap.
+*/
+void tilemap_free(Tilemap* tilemap);
+
+/**
+    Sets the tile at the specified position. Marks the containing chunk to be
+    baked again the next time it's drawn.
+
+    \return SDL_TRUE on success, SDL_FALSE if the position is outside of the map
+            or there wasn't enough memory for the chunk.
+*/
+SDL_bool tilemap_set_tile(Tilemap* tilemap, int layer, int x, int y, TileId tile);
+
+/**
+    Gets the tile at the specified position. Returns TILE_EMPTY if the position
+    is outside of the map.
+*/
+static inline TileId tilemap_get_tile(Tilemap* tilemap, int layer, int x, int y);
+
+/**
+    Changes the tileset texture used by the tilemap, causing every chunk to be baked again.
+*/
+void tilemap_set_tileset(Tilemap* tilemap, Texture* tileset);
+
+/**
+    Marks every chunk to be baked again the next time it's drawn.
+    Use this if the contents of the tileset texture changed.
+*/
+void tilemap_invalidate(Tilemap* tilemap);
+
+/**
+    Sets the maximum number of bytes the baked chunk textures should use.
+    The least recently drawn chunks are evicted first. Chunks that are
+    visible in the current frame are never evicted, so the budget can be
+    exceeded if it's smaller than a single screen worth of chunks.
+
+    \param bytes The memory budget, or 0 to remove the limit.
+*/
+void tilemap_set_memory_budget(Tilemap* tilemap, size_t bytes);
+
+/**
+    Gets the number of bytes currently used by baked chunk textures.
+*/
+static inline size_t tilemap_get_memory_used(Tilemap* tilemap);
+
+/**
+    Gets the bounds of a chunk in the game world in pixels.
+*/
+static inline Rectangle tilemap_get_chunk_bounds(Tilemap* tilemap, int chunk_x, int chunk_y);
+
+/**
+    Draws the part of the tilemap that is visible to the camera to the current
+    render target, baking any visible chunks that changed. Meant to be called
+    from a system in the draw pass of a scene.
+
+    \return SDL_TRUE on success, SDL_FALSE otherwise. Get the error using SDL_GetError.
+*/
+SDL_bool tilemap_draw(Tilemap* tilemap, Camera* camera);
+
+static inline TileId tilemap_get_tile(Tilemap* tilemap, int layer, int x, int y) {
+    if(layer < 0 || layer >= tilemap->layer_count || x < 0 || x >= tilemap->width || y < 0 || y >= tilemap->height)
+        return TILE_EMPTY;
+
+    TilemapChunk* chunk = tilemap->chunks + (y / tilemap->chunk_size) * tilemap->chunks_x + x / tilemap->chunk_size;
+    if(chunk->tiles == NULL)
+        return TILE_EMPTY;
+
+    int local_x = x % tilemap->chunk_size;
+    int local_y = y % tilemap->chunk_size;
+    return chunk->tiles[(layer * tilemap->chunk_size + local_y) * tilemap->chunk_size + local_x];
+}
+
+static inline size_t tilemap_get_memory_used(Tilemap* tilemap) {
+    return tilemap->memory_used;
+}
+
+static inline Rectangle tilemap_get_chunk_bounds(Tilemap* tilemap, int chunk_x, int chunk_y) {
+    int w = tilemap->chunk_size * tilemap->tile_width;
+    int h = tilemap->chunk_size * tilemap->tile_height;
+    return (Rectangle){ chunk_x * w, chunk_y * h, w, h };
+}
+
+#endif
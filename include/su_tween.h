@@ -0,0 +1,182 @@
+#ifndef SDL_UTILS_TWEEN_H
+#define SDL_UTILS_TWEEN_H
+
+#include <SDL.h>
+
+#include "su_data_types.h"
+#include "su_math.h"
+#include "su_utils.h"
+
+/**
+    The easing functions that can be used to interpolate a tween.
+*/
+typedef enum EaseType {
+    EASE_LINEAR,
+    EASE_QUAD_IN,
+    EASE_QUAD_OUT,
+    EASE_QUAD_IN_OUT,
+    EASE_CUBIC_IN,
+    EASE_CUBIC_OUT,
+    EASE_CUBIC_IN_OUT,
+    EASE_QUART_IN,
+    EASE_QUART_OUT,
+    EASE_QUART_IN_OUT,
+    EASE_BACK_IN,
+    EASE_BACK_OUT,
+    EASE_BACK_IN_OUT,
+    EASE_SMOOTHSTEP,
+    EASE_COUNT
+} EaseType;
+
+/**
+    Identifies a tween. 0 is never a valid id.
+*/
+typedef Uint32 TweenId;
+
+#define TWEEN_ID_INVALID ((TweenId)0)
+
+typedef struct Tweener Tweener;
+
+/**
+    A function called once a tween reaches its end value.
+    It's safe to add and cancel tweens from inside the callback.
+*/
+typedef void (*TweenDoneFn)(Tweener* tweener, TweenId id, void* data);
+
+/**
+    The active tweens that use a single easing function, stored as parallel
+    arrays so the whole bucket can be evaluated in batches.
+*/
+typedef struct TweenBucket {
+    float* elapsed;
+    float* inv_duration;
+    float* start;
+    float* change;
+    float* value;
+    void** target;
+    Uint8* flags;
+    TweenId* id;
+    TweenDoneFn* done;
+    void** data;
+    int count;
+    int capacity;
+} TweenBucket;
+
+typedef struct TweenCompletion {
+    TweenDoneFn done;
+    TweenId id;
+    void* data;
+} TweenCompletion;
+
+/**
+    Runs a large number of tweens that write into float, int, Vector2 and Point values.
+*/
+struct Tweener {
+    TweenBucket buckets[EASE_COUNT];
+    TweenCompletion* completions;
+    int completion_count;
+    int completion_capacity;
+    int callback_count;
+    TweenId next_id;
+};
+
+/**
+    Initializes a tweener.
+*/
+void tweener_init(Tweener* tweener);
+
+/**
+    Allocates and initializes a tweener. Returns NULL on failure.
+*/
+Tweener* tweener_create(void);
+
+/**
+    Cancels every tween and frees the resources used by the tweener
+    without freeing the tweener itself.
+*/
+void tweener_free_resources(Tweener* tweener);
+
+/**
+    Frees the resources used by the tweener, then frees the tweener itself.
+    Only use if the tweener was allocated with tweener_create.
+*/
+void tweener_free(Tweener* tweener);
+
+/**
+    Tweens a float from its current value to another value.
+
+    \param tweener The tweener that runs the tween.
+    \param target The value to tween. It must stay valid until the tween
+                  finishes or is cancelled.
+    \param to The value at the end of the tween.
+    \param duration The length of the tween, in the same units passed to tweener_update.
+    \param ease The easing function of the tween.
+    \param done Called when the tween finishes. Can be NULL.
+    \param data User data passed to done.
+    \return The id of the tween, or TWEEN_ID_INVALID on failure.
+            Get the error using SDL_GetError.
+*/
+TweenId tween_float(Tweener* tweener, float* target, float to, float duration, EaseType ease, TweenDoneFn done, void* data);
+
+/**
+    Tweens an int from its current value to another value.
+    Intermediate values are rounded to the nearest integer.
+
+    \see tween_float
+*/
+TweenId tween_int(Tweener* tweener, int* target, int to, float duration, EaseType ease, TweenDoneFn done, void* data);
+
+/**
+    Tweens both components of a Vector2 from its current value to another value.
+
+    \see tween_float
+*/
+TweenId tween_vector2(Tweener* tweener, Vector2* target, Vector2 to, float duration, EaseType ease, TweenDoneFn done, void* data);
+
+/**
+    Tweens both components of a Point from its current value to another value.
+    Intermediate values are rounded to the nearest integer.
+
+    \see tween_float
+*/
+TweenId tween_point(Tweener* tweener, Point* target, Point to, float duration, EaseType ease, TweenDoneFn done, void* data);
+
+/**
+    Cancels a tween, leaving its target at its current value.
+    Returns SDL_FALSE if the tween had already finished or was cancelled.
+*/
+SDL_bool tweener_cancel(Tweener* tweener, TweenId id);
+
+/**
+    Cancels every tween that writes into the specified value,
+    including the components of a Vector2 or Point.
+
+    \return The number of tweens that were cancelled.
+*/
+int tweener_cancel_target(Tweener* tweener, void* target);
+
+/**
+    Advances every tween and writes the new values into their targets.
+    Finished tweens are removed and their callbacks are called.
+*/
+void tweener_update(Tweener* tweener, float delta);
+
+/**
+    Gets the number of running tweens. Vector2 and Point tweens count twice.
+*/
+int tweener_get_count(Tweener* tweener);
+
+/**
+    Evaluates an easing function.
+
+    \param type The easing function.
+    \param t The progress in the range [0, 1].
+*/
+float ease(EaseType type, float t);
+
+/**
+    Evaluates an easing function over an array of progress values in place.
+*/
+void ease_batch(EaseType type, float* t, int count);
+
+#endif
@@ -7,15 +7,61 @@
     used by SDL.
 */
 
+#include <stddef.h>
+
+/**
+    A set of memory functions that the library allocates through.
+
+    \remark Every function receives the data pointer of the allocator as its
+            first argument. free must accept NULL.
+*/
+typedef struct Allocator {
+    void* (*malloc)(void* data, size_t size);
+    void* (*realloc)(void* data, void* ptr, size_t size);
+    void (*free)(void* data, void* ptr);
+    void* data;
+} Allocator;
+
+/**
+    Sets the allocator used by every allocation made by the library,
+    including scene_create, camera_create, timer_create and input_manager_init.
+
+    \param allocator The allocator to use, or NULL to go back to the default
+                     allocator. It must stay alive as long as it's in use.
+
+    \remark Like SDL_SetMemoryFunctions, this should be called before anything
+            is allocated, since memory has to be freed by the allocator that
+            allocated it.
+
+    \remark The job system, asset loader and scene batches allocate from worker
+            threads, so the allocator has to be thread-safe once any of them
+            is running. The default allocator is, a TrackingAllocator is if its
+            backing allocator is, and a FrameArena or PoolAllocator isn't.
+            This function itself isn't synchronized, call it before starting
+            any threads.
+*/
+void su_set_allocator(Allocator* allocator);
+
+/**
+    Gets the allocator currently used by the library.
+*/
+Allocator* su_get_allocator(void);
+
+/**
+    Gets the allocator that wraps the C standard library, or SDL if
+    SDL_UTILS_NO_STD_LIB is defined.
+*/
+Allocator* su_default_allocator(void);
+
+void* su_malloc(size_t size);
+void* su_realloc(void* ptr, size_t size);
+void* su_calloc(size_t nelems, size_t size);
+void su_free(void* ptr);
+
 #ifdef SDL_UTILS_NO_STD_LIB
 
 #include <SDL.h>
 
-#define su_malloc(size)            SDL_malloc(size)
-#define su_realloc(ptr, size)      SDL_realloc(ptr, size)
-#define su_calloc(nelems, size)    SDL_calloc(nelems, size)
-#define su_free(ptr)               SDL_free(ptr)
-
 #define su_memmove(dst, src, size) SDL_memmove(dst, src, size)
 
 #else
@@ -23,13 +69,8 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define su_malloc(size)            malloc(size)
-#define su_realloc(ptr, size)      realloc(ptr, size)
-#define su_calloc(nelems, size)    calloc(nelems, size)
-#define su_free(ptr)               free(ptr)
-
 #define su_memmove(dst, src, size) memmove(dst, src, size)
 
 #endif
 
-#endif
\ No newline at end of file
+#endif
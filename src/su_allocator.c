@@ -0,0 +1,386 @@
+#include <su_allocator.h>
+
+#ifdef SDL_UTILS_NO_STD_LIB
+
+static void* su_default_malloc(void* data, size_t size) { return SDL_malloc(size); }
+static void* su_default_realloc(void* data, void* ptr, size_t size) { return SDL_realloc(ptr, size); }
+static void su_default_free(void* data, void* ptr) { SDL_free(ptr); }
+
+#else
+
+static void* su_default_malloc(void* data, size_t size) { return malloc(size); }
+static void* su_default_realloc(void* data, void* ptr, size_t size) { return realloc(ptr, size); }
+static void su_default_free(void* data, void* ptr) { free(ptr); }
+
+#endif
+
+static Allocator default_allocator = { su_default_malloc, su_default_realloc, su_default_free, NULL };
+static Allocator* current_allocator = &default_allocator;
+
+void su_set_allocator(Allocator* allocator) {
+    current_allocator = allocator == NULL ? &default_allocator : allocator;
+}
+
+Allocator* su_get_allocator(void) {
+    return current_allocator;
+}
+
+Allocator* su_default_allocator(void) {
+    return &default_allocator;
+}
+
+void* su_malloc(size_t size) {
+    return current_allocator->malloc(current_allocator->data, size);
+}
+
+void* su_realloc(void* ptr, size_t size) {
+    return current_allocator->realloc(current_allocator->data, ptr, size);
+}
+
+void* su_calloc(size_t nelems, size_t size) {
+    if(size != 0 && nelems > SIZE_MAX / size)
+        return NULL;
+
+    size_t total = nelems * size;
+    void* ptr = current_allocator->malloc(current_allocator->data, total);
+    if(ptr != NULL)
+        SDL_memset(ptr, 0, total);
+
+    return ptr;
+}
+
+void su_free(void* ptr) {
+    current_allocator->free(current_allocator->data, ptr);
+}
+
+static inline size_t allocator_align(size_t size) {
+    return (size + ALLOCATOR_ALIGNMENT - 1) & ~(size_t)(ALLOCATOR_ALIGNMENT - 1);
+}
+
+static inline void allocator_stats_add(AllocatorStats* stats, size_t size) {
+    stats->allocations++;
+    stats->bytes_allocated += size;
+    stats->bytes_in_use += size;
+    if(stats->bytes_in_use > stats->high_water)
+        stats->high_water = stats->bytes_in_use;
+}
+
+static inline void allocator_stats_remove(AllocatorStats* stats, size_t size) {
+    stats->frees++;
+    stats->bytes_in_use -= size;
+}
+
+// Aligned memory from the backing allocators. The offset to the start of the
+// real allocation is stored right before the returned pointer.
+static void* allocator_aligned_malloc(Allocator* backing, size_t size) {
+    Uint8* raw = backing->malloc(backing->data, size + ALLOCATOR_ALIGNMENT);
+    if(raw == NULL)
+        return NULL;
+
+    Uint8* aligned = (Uint8*)allocator_align((size_t)raw + 1);
+    aligned[-1] = (Uint8)(aligned - raw);
+    return aligned;
+}
+
+static void allocator_aligned_free(Allocator* backing, void* ptr) {
+    Uint8* aligned = ptr;
+    backing->free(backing->data, aligned - aligned[-1]);
+}
+
+// Every arena allocation is preceded by a header holding its size,
+// which realloc needs to know how much to copy.
+#define ARENA_HEADER_SIZE ALLOCATOR_ALIGNMENT
+
+static void* frame_arena_malloc(void* data, size_t size) {
+    FrameArena* arena = data;
+    size_t total = allocator_align(size) + ARENA_HEADER_SIZE;
+
+    if(total < size || arena->capacity - arena->offset < total) {
+        arena->stats.failures++;
+        return NULL;
+    }
+
+    Uint8* header = arena->buffer + arena->offset;
+    *(size_t*)header = size;
+
+    arena->last_offset = arena->offset;
+    arena->offset += total;
+    allocator_stats_add(&arena->stats, total);
+
+    return header + ARENA_HEADER_SIZE;
+}
+
+static void frame_arena_release(void* data, void* ptr) {
+    if(ptr == NULL)
+        return;
+
+    FrameArena* arena = data;
+    Uint8* header = (Uint8*)ptr - ARENA_HEADER_SIZE;
+
+    // Only the most recent allocation can be given back, everything else
+    // waits for frame_arena_reset.
+    if(header == arena->buffer + arena->last_offset && arena->offset > arena->last_offset) {
+        allocator_stats_remove(&arena->stats, arena->offset - arena->last_offset);
+        arena->offset = arena->last_offset;
+    }
+}
+
+static void* frame_arena_realloc(void* data, void* ptr, size_t size) {
+    if(ptr == NULL)
+        return frame_arena_malloc(data, size);
+
+    FrameArena* arena = data;
+    Uint8* header = (Uint8*)ptr - ARENA_HEADER_SIZE;
+    size_t old_size = *(size_t*)header;
+
+    // The last allocation can grow or shrink in place.
+    if(header == arena->buffer + arena->last_offset) {
+        size_t total = allocator_align(size) + ARENA_HEADER_SIZE;
+        if(total >= size && arena->capacity - arena->last_offset >= total) {
+            size_t old_total = arena->offset - arena->last_offset;
+            arena->offset = arena->last_offset + total;
+            *(size_t*)header = size;
+
+            arena->stats.allocations++;
+            if(total > old_total) {
+                arena->stats.bytes_allocated += total - old_total;
+                arena->stats.bytes_in_use += total - old_total;
+                if(arena->stats.bytes_in_use > arena->stats.high_water)
+                    arena->stats.high_water = arena->stats.bytes_in_use;
+            } else {
+                arena->stats.bytes_in_use -= old_total - total;
+            }
+            return ptr;
+        }
+    }
+
+    void* result = frame_arena_malloc(data, size);
+    if(result == NULL)
+        return NULL;
+
+    SDL_memcpy(result, ptr, old_size < size ? old_size : size);
+    return result;
+}
+
+SDL_bool frame_arena_init(FrameArena* arena, Allocator* backing, size_t capacity) {
+    if(backing == NULL)
+        backing = su_get_allocator();
+
+    capacity = allocator_align(capacity);
+
+    arena->buffer = allocator_aligned_malloc(backing, capacity);
+    if(arena->buffer == NULL) {
+        SDL_SetError("Could not create frame arena, not enough memory.");
+        return SDL_FALSE;
+    }
+
+    arena->allocator.malloc = frame_arena_malloc;
+    arena->allocator.realloc = frame_arena_realloc;
+    arena->allocator.free = frame_arena_release;
+    arena->allocator.data = arena;
+    arena->backing = backing;
+    arena->capacity = capacity;
+    arena->offset = 0;
+    arena->last_offset = 0;
+    SDL_memset(&arena->stats, 0, sizeof(arena->stats));
+
+    return SDL_TRUE;
+}
+
+void frame_arena_free_resources(FrameArena* arena) {
+    if(arena->buffer != NULL)
+        allocator_aligned_free(arena->backing, arena->buffer);
+
+    arena->buffer = NULL;
+    arena->capacity = 0;
+    arena->offset = 0;
+    arena->last_offset = 0;
+}
+
+static void* pool_allocator_malloc(void* data, size_t size) {
+    PoolAllocator* pool = data;
+    if(size > pool->block_size || pool->free_list == NULL) {
+        pool->stats.failures++;
+        return NULL;
+    }
+
+    void* block = pool->free_list;
+    pool->free_list = *(void**)block;
+    allocator_stats_add(&pool->stats, pool->block_size);
+
+    return block;
+}
+
+static void pool_allocator_release(void* data, void* ptr) {
+    if(ptr == NULL)
+        return;
+
+    PoolAllocator* pool = data;
+    *(void**)ptr = pool->free_list;
+    pool->free_list = ptr;
+    allocator_stats_remove(&pool->stats, pool->block_size);
+}
+
+static void* pool_allocator_realloc(void* data, void* ptr, size_t size) {
+    if(ptr == NULL)
+        return pool_allocator_malloc(data, size);
+
+    // Every block has the same size, so either it already fits or it never will.
+    PoolAllocator* pool = data;
+    if(size > pool->block_size) {
+        pool->stats.failures++;
+        return NULL;
+    }
+
+    return ptr;
+}
+
+SDL_bool pool_allocator_init(PoolAllocator* pool, Allocator* backing, size_t block_size, size_t block_count) {
+    if(backing == NULL)
+        backing = su_get_allocator();
+
+    block_size = allocator_align(block_size < sizeof(void*) ? sizeof(void*) : block_size);
+
+    if(block_count != 0 && block_size > SIZE_MAX / block_count - ALLOCATOR_ALIGNMENT) {
+        SDL_SetError("Could not create pool allocator, not enough memory.");
+        return SDL_FALSE;
+    }
+
+    pool->buffer = allocator_aligned_malloc(backing, block_size * block_count);
+    if(pool->buffer == NULL) {
+        SDL_SetError("Could not create pool allocator, not enough memory.");
+        return SDL_FALSE;
+    }
+
+    pool->allocator.malloc = pool_allocator_malloc;
+    pool->allocator.realloc = pool_allocator_realloc;
+    pool->allocator.free = pool_allocator_release;
+    pool->allocator.data = pool;
+    pool->backing = backing;
+    pool->block_size = block_size;
+    pool->block_count = block_count;
+    SDL_memset(&pool->stats, 0, sizeof(pool->stats));
+
+    // Thread the free list through the blocks in address order.
+    pool->free_list = NULL;
+    for(size_t i = block_count; i > 0; i--) {
+        void* block = pool->buffer + (i - 1) * block_size;
+        *(void**)block = pool->free_list;
+        pool->free_list = block;
+    }
+
+    return SDL_TRUE;
+}
+
+void pool_allocator_free_resources(PoolAllocator* pool) {
+    if(pool->buffer != NULL)
+        allocator_aligned_free(pool->backing, pool->buffer);
+
+    pool->buffer = NULL;
+    pool->free_list = NULL;
+    pool->block_count = 0;
+}
+
+// Tracked allocations store their size in a header so the stats
+// stay correct through realloc and free.
+#define TRACKING_HEADER_SIZE ALLOCATOR_ALIGNMENT
+
+static void tracking_allocator_failed(TrackingAllocator* tracker) {
+    SDL_AtomicLock(&tracker->lock);
+    tracker->stats.failures++;
+    SDL_AtomicUnlock(&tracker->lock);
+}
+
+static void* tracking_allocator_malloc(void* data, size_t size) {
+    TrackingAllocator* tracker = data;
+    if(size > SIZE_MAX - TRACKING_HEADER_SIZE) {
+        tracking_allocator_failed(tracker);
+        return NULL;
+    }
+
+    Uint8* header = tracker->backing->malloc(tracker->backing->data, size + TRACKING_HEADER_SIZE);
+    if(header == NULL) {
+        tracking_allocator_failed(tracker);
+        return NULL;
+    }
+
+    *(size_t*)header = size;
+
+    SDL_AtomicLock(&tracker->lock);
+    allocator_stats_add(&tracker->stats, size);
+    SDL_AtomicUnlock(&tracker->lock);
+
+    return header + TRACKING_HEADER_SIZE;
+}
+
+static void tracking_allocator_release(void* data, void* ptr) {
+    if(ptr == NULL)
+        return;
+
+    TrackingAllocator* tracker = data;
+    Uint8* header = (Uint8*)ptr - TRACKING_HEADER_SIZE;
+
+    SDL_AtomicLock(&tracker->lock);
+    allocator_stats_remove(&tracker->stats, *(size_t*)header);
+    SDL_AtomicUnlock(&tracker->lock);
+
+    tracker->backing->free(tracker->backing->data, header);
+}
+
+static void* tracking_allocator_realloc(void* data, void* ptr, size_t size) {
+    if(ptr == NULL)
+        return tracking_allocator_malloc(data, size);
+
+    TrackingAllocator* tracker = data;
+    if(size > SIZE_MAX - TRACKING_HEADER_SIZE) {
+        tracking_allocator_failed(tracker);
+        return NULL;
+    }
+
+    Uint8* header = (Uint8*)ptr - TRACKING_HEADER_SIZE;
+    size_t old_size = *(size_t*)header;
+
+    header = tracker->backing->realloc(tracker->backing->data, header, size + TRACKING_HEADER_SIZE);
+    if(header == NULL) {
+        tracking_allocator_failed(tracker);
+        return NULL;
+    }
+
+    *(size_t*)header = size;
+
+    SDL_AtomicLock(&tracker->lock);
+    tracker->stats.bytes_in_use -= old_size;
+    allocator_stats_add(&tracker->stats, size);
+    SDL_AtomicUnlock(&tracker->lock);
+
+    return header + TRACKING_HEADER_SIZE;
+}
+
+Allocator* tracking_allocator_init(TrackingAllocator* tracker, Allocator* backing) {
+    if(backing == NULL)
+        backing = su_get_allocator();
+
+    tracker->allocator.malloc = tracking_allocator_malloc;
+    tracker->allocator.realloc = tracking_allocator_realloc;
+    tracker->allocator.free = tracking_allocator_release;
+    tracker->allocator.data = tracker;
+    tracker->backing = backing;
+    tracker->lock = 0;
+    SDL_memset(&tracker->stats, 0, sizeof(tracker->stats));
+
+    return &tracker->allocator;
+}
+
+AllocatorStats tracking_allocator_get_stats(TrackingAllocator* tracker) {
+    SDL_AtomicLock(&tracker->lock);
+    AllocatorStats stats = tracker->stats;
+    SDL_AtomicUnlock(&tracker->lock);
+
+    return stats;
+}
+
+void tracking_allocator_reset_stats(TrackingAllocator* tracker) {
+    SDL_AtomicLock(&tracker->lock);
+    allocator_stats_reset(&tracker->stats);
+    SDL_AtomicUnlock(&tracker->lock);
+}
@@ -0,0 +1,431 @@
+#include <su_animation.h>
+
+#include <math.h>
+
+#include "su_simd.h"
+
+#define ANIMATION_FLAG_ACTIVE 1
+#define ANIMATION_FLAG_FINISHED 2
+#define ANIMATION_FLAG_FINISHED_NOW 4
+
+// Keeps an animation that starts at the end of its clip on the last frame.
+#define ANIMATION_END_OFFSET 1e-4f
+
+static inline AnimationId animation_make_id(int index, Uint32 generation) {
+    return ((AnimationId)generation << 32) | (Uint32)index;
+}
+
+static int animation_get_slot(Animator* animator, AnimationId id) {
+    Uint32 index = (Uint32)id;
+    Uint32 generation = (Uint32)(id >> 32);
+
+    if(index >= (Uint32)animator->slot_count)
+        return -1;
+
+    if(animator->generation[index] != generation || !(animator->flags[index] & ANIMATION_FLAG_ACTIVE))
+        return -1;
+
+    return (int)index;
+}
+
+void animator_init(Animator* animator, TextureAtlas* atlas) {
+    SDL_memset(animator, 0, sizeof(*animator));
+    animator->atlas = atlas;
+    animator->free_list = -1;
+}
+
+Animator* animator_create(TextureAtlas* atlas) {
+    Animator* animator = su_malloc(sizeof(*animator));
+    if(animator == NULL) {
+        SDL_SetError("Could not create animator, not enough memory.");
+        return NULL;
+    }
+
+    animator_init(animator, atlas);
+    return animator;
+}
+
+void animator_free_resources(Animator* animator) {
+    su_free(animator->clips);
+    su_free(animator->frames);
+    su_free(animator->frame_events);
+    su_free(animator->position);
+    su_free(animator->rate);
+    su_free(animator->length);
+    su_free(animator->inv_length);
+    su_free(animator->loop);
+    su_free(animator->speed);
+    su_free(animator->frame);
+    su_free(animator->previous);
+    su_free(animator->region);
+    su_free(animator->clip);
+    su_free(animator->generation);
+    su_free(animator->flags);
+    su_free(animator->data);
+
+    animator_init(animator, animator->atlas);
+}
+
+void animator_free(Animator* animator) {
+    animator_free_resources(animator);
+    su_free(animator);
+}
+
+AnimationClipId animator_add_clip(Animator* animator, const AtlasRegionId* frames, int count, float frame_duration, AnimationMode mode) {
+    if(count <= 0 || frame_duration <= 0) {
+        SDL_SetError("Could not add animation clip, it needs at least one frame and a positive frame duration.");
+        return ANIMATION_CLIP_INVALID;
+    }
+
+    if(animator->clip_count == animator->clip_capacity) {
+        int capacity = animator->clip_capacity == 0 ? 16 : animator->clip_capacity * 2;
+        AnimationClip* clips = su_realloc(animator->clips, sizeof(AnimationClip) * capacity);
+        if(clips == NULL)
+            goto error;
+
+        animator->clips = clips;
+        animator->clip_capacity = capacity;
+    }
+
+    if(animator->frame_count + count > animator->frame_capacity) {
+        int capacity = animator->frame_capacity == 0 ? 64 : animator->frame_capacity * 2;
+        while(capacity < animator->frame_count + count)
+            capacity *= 2;
+
+        AtlasRegionId* regions = su_realloc(animator->frames, sizeof(AtlasRegionId) * capacity);
+        if(regions == NULL)
+            goto error;
+        animator->frames = regions;
+
+        int* events = su_realloc(animator->frame_events, sizeof(int) * capacity);
+        if(events == NULL)
+            goto error;
+        animator->frame_events = events;
+
+        animator->frame_capacity = capacity;
+    }
+
+    AnimationClip* clip = animator->clips + animator->clip_count;
+    clip->first = animator->frame_count;
+    clip->count = count;
+    clip->frame_duration = frame_duration;
+    clip->mode = mode;
+    clip->has_events = SDL_FALSE;
+
+    SDL_memcpy(animator->frames + clip->first, frames, sizeof(AtlasRegionId) * count);
+    SDL_memset(animator->frame_events + clip->first, 0, sizeof(int) * count);
+    animator->frame_count += count;
+
+    return animator->clip_count++;
+
+    error:
+        SDL_SetError("Could not add animation clip, not enough memory.");
+        return ANIMATION_CLIP_INVALID;
+}
+
+SDL_bool animator_set_frame_event(Animator* animator, AnimationClipId clip, int frame, int event) {
+    if(clip < 0 || clip >= animator->clip_count)
+        return SDL_FALSE;
+
+    AnimationClip* data = animator->clips + clip;
+    if(frame < 0 || frame >= data->count)
+        return SDL_FALSE;
+
+    animator->frame_events[data->first + frame] = event;
+
+    data->has_events = SDL_FALSE;
+    for(int i = 0; i < data->count; i++) {
+        if(animator->frame_events[data->first + i] != 0) {
+            data->has_events = SDL_TRUE;
+            break;
+        }
+    }
+
+    return SDL_TRUE;
+}
+
+#define ANIMATOR_GROW(field) \
+    do { \
+        void* grown = su_realloc(animator->field, sizeof(*animator->field) * capacity); \
+        if(grown == NULL) \
+            return SDL_FALSE; \
+        animator->field = grown; \
+    } while(0)
+
+static SDL_bool animator_reserve_slot(Animator* animator) {
+    if(animator->free_list != -1 || animator->slot_count < animator->slot_capacity)
+        return SDL_TRUE;
+
+    int capacity = animator->slot_capacity == 0 ? 64 : animator->slot_capacity * 2;
+
+    // The arrays that were grown before a failure keep working at the old capacity.
+    ANIMATOR_GROW(position);
+    ANIMATOR_GROW(rate);
+    ANIMATOR_GROW(length);
+    ANIMATOR_GROW(inv_length);
+    ANIMATOR_GROW(loop);
+    ANIMATOR_GROW(speed);
+    ANIMATOR_GROW(frame);
+    ANIMATOR_GROW(previous);
+    ANIMATOR_GROW(region);
+    ANIMATOR_GROW(clip);
+    ANIMATOR_GROW(generation);
+    ANIMATOR_GROW(flags);
+    ANIMATOR_GROW(data);
+
+    animator->slot_capacity = capacity;
+    return SDL_TRUE;
+}
+
+#undef ANIMATOR_GROW
+
+static void animator_start(Animator* animator, int index, AnimationClipId clip_id) {
+    AnimationClip* clip = animator->clips + clip_id;
+    float speed = animator->speed[index];
+    float length = (float)clip->count;
+
+    animator->position[index] = speed < 0 ? length - ANIMATION_END_OFFSET : 0;
+    animator->rate[index] = speed / clip->frame_duration;
+    animator->length[index] = length;
+    animator->inv_length[index] = 1 / length;
+    animator->loop[index] = clip->mode == ANIMATION_LOOP ? 1.0f : 0.0f;
+    animator->frame[index] = speed < 0 ? clip->count - 1 : 0;
+    animator->previous[index] = animator->frame[index];
+    animator->region[index] = animator->frames[clip->first + animator->frame[index]];
+    animator->clip[index] = clip_id;
+    animator->flags[index] = ANIMATION_FLAG_ACTIVE;
+}
+
+AnimationId animator_play(Animator* animator, AnimationClipId clip, float speed, void* data) {
+    if(clip < 0 || clip >= animator->clip_count) {
+        SDL_SetError("Could not play animation, invalid clip.");
+        return ANIMATION_ID_INVALID;
+    }
+
+    if(!animator_reserve_slot(animator)) {
+        SDL_SetError("Could not play animation, not enough memory.");
+        return ANIMATION_ID_INVALID;
+    }
+
+    int index = animator->free_list;
+    if(index != -1) {
+        // Free slots are linked through their frame.
+        animator->free_list = animator->frame[index];
+    } else {
+        index = animator->slot_count++;
+        animator->generation[index] = 1;
+    }
+
+    animator->speed[index] = speed;
+    animator->data[index] = data;
+    animator_start(animator, index, clip);
+    animator->active++;
+
+    return animation_make_id(index, animator->generation[index]);
+}
+
+SDL_bool animator_set_clip(Animator* animator, AnimationId id, AnimationClipId clip) {
+    int index = animation_get_slot(animator, id);
+    if(index == -1 || clip < 0 || clip >= animator->clip_count)
+        return SDL_FALSE;
+
+    animator_start(animator, index, clip);
+    return SDL_TRUE;
+}
+
+SDL_bool animator_stop(Animator* animator, AnimationId id) {
+    int index = animation_get_slot(animator, id);
+    if(index == -1)
+        return SDL_FALSE;
+
+    // Invalidate any outstanding ids.
+    if(++animator->generation[index] == 0)
+        animator->generation[index] = 1;
+
+    // Leave the slot in a state the batch pass can run over without effect.
+    animator->position[index] = 0;
+    animator->rate[index] = 0;
+    animator->length[index] = 1;
+    animator->inv_length[index] = 1;
+    animator->loop[index] = 0;
+    animator->flags[index] = 0;
+    animator->frame[index] = animator->free_list;
+    animator->free_list = index;
+    animator->active--;
+
+    return SDL_TRUE;
+}
+
+SDL_bool animator_is_playing(Animator* animator, AnimationId id) {
+    return animation_get_slot(animator, id) != -1;
+}
+
+SDL_bool animator_set_speed(Animator* animator, AnimationId id, float speed) {
+    int index = animation_get_slot(animator, id);
+    if(index == -1)
+        return SDL_FALSE;
+
+    animator->speed[index] = speed;
+    animator->rate[index] = speed / animator->clips[animator->clip[index]].frame_duration;
+
+    // Turning around at the end of a clip plays it again.
+    if(speed != 0)
+        animator->flags[index] &= ~ANIMATION_FLAG_FINISHED;
+
+    return SDL_TRUE;
+}
+
+int animator_get_frame(Animator* animator, AnimationId id) {
+    int index = animation_get_slot(animator, id);
+    return index != -1 ? animator->frame[index] : -1;
+}
+
+SDL_bool animator_finished(Animator* animator, AnimationId id) {
+    int index = animation_get_slot(animator, id);
+    return index != -1 && (animator->flags[index] & ANIMATION_FLAG_FINISHED) != 0;
+}
+
+AtlasRegion animator_get_region(Animator* animator, AnimationId id) {
+    int index = animation_get_slot(animator, id);
+    if(index == -1)
+        return (AtlasRegion){ NULL, { 0, 0, 0, 0 } };
+
+    return atlas_get_region(animator->atlas, animator->region[index]);
+}
+
+int animator_draw(Animator* animator, AnimationId id, const Rectangle* dst) {
+    int index = animation_get_slot(animator, id);
+    if(index == -1)
+        return SDL_SetError("Could not draw animation, it isn't playing.");
+
+    return atlas_draw(animator->atlas, animator->region[index], dst);
+}
+
+static void animator_advance(Animator* animator, float delta) {
+    float* position = animator->position;
+    float* rate = animator->rate;
+    float* length = animator->length;
+    float* inv_length = animator->inv_length;
+    float* loop = animator->loop;
+    int count = animator->slot_count;
+
+    // Looping animations wrap around their length, the others stop at either end.
+    int i = 0;
+#ifdef SU_SIMD
+    simd_float4 step = simd_set1(delta);
+    simd_float4 zero = simd_set1(0);
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_float4 p = simd_add(simd_load(position + i), simd_mul(step, simd_load(rate + i)));
+        simd_float4 l = simd_load(length + i);
+        simd_float4 wrapped = simd_sub(p, simd_mul(simd_floor(simd_mul(p, simd_load(inv_length + i))), l));
+        simd_float4 clamped = simd_max(simd_min(p, l), zero);
+        simd_store(position + i, simd_select(simd_cmpgt(simd_load(loop + i), zero), wrapped, clamped));
+    }
+#endif
+    for(; i < count; i++) {
+        float p = position[i] + delta * rate[i];
+        if(loop[i] > 0)
+            p -= floorf(p * inv_length[i]) * length[i];
+        else if(p > length[i])
+            p = length[i];
+        else if(p < 0)
+            p = 0;
+        position[i] = p;
+    }
+}
+
+// Updates the current frame of every animation from its position.
+// Returns SDL_TRUE if any animation has events to send.
+static SDL_bool animator_update_frames(Animator* animator) {
+    SDL_bool events = SDL_FALSE;
+
+    for(int i = 0; i < animator->slot_count; i++) {
+        if(!(animator->flags[i] & ANIMATION_FLAG_ACTIVE))
+            continue;
+
+        animator->previous[i] = animator->frame[i];
+        if(animator->rate[i] == 0)
+            continue;
+
+        AnimationClip* clip = animator->clips + animator->clip[i];
+        float position = animator->position[i];
+        int frame = (int)position;
+        if(frame >= clip->count)
+            frame = clip->count - 1;
+        else if(frame < 0)
+            frame = 0;
+
+        if(frame != animator->frame[i]) {
+            animator->frame[i] = frame;
+            animator->region[i] = animator->frames[clip->first + frame];
+            events |= clip->has_events;
+        }
+
+        if(clip->mode != ANIMATION_LOOP && !(animator->flags[i] & ANIMATION_FLAG_FINISHED)) {
+            SDL_bool forward = animator->rate[i] > 0;
+            if((forward && position >= animator->length[i]) || (!forward && position <= 0)) {
+                animator->flags[i] |= ANIMATION_FLAG_FINISHED | ANIMATION_FLAG_FINISHED_NOW;
+                events = SDL_TRUE;
+            }
+        }
+    }
+
+    return events;
+}
+
+static void animator_send_events(Animator* animator) {
+    // Animations played by the callbacks start on the next update.
+    int count = animator->slot_count;
+
+    for(int i = 0; i < count; i++) {
+        if(!(animator->flags[i] & ANIMATION_FLAG_ACTIVE))
+            continue;
+
+        AnimationClipId clip_id = animator->clip[i];
+        AnimationClip clip = animator->clips[clip_id];
+        AnimationId id = animation_make_id(i, animator->generation[i]);
+        int previous = animator->previous[i];
+        int frame = animator->frame[i];
+
+        if(clip.has_events && frame != previous) {
+            int direction = animator->rate[i] > 0 ? 1 : -1;
+            int steps = (frame - previous) * direction;
+            if(steps < 0)
+                steps += clip.count;
+
+            // The arrays can be reallocated by the callback, so nothing is cached across calls.
+            for(int step = 1; step <= steps; step++) {
+                int current = (previous + step * direction + clip.count) % clip.count;
+                int event = animator->frame_events[clip.first + current];
+                if(event == 0)
+                    continue;
+
+                animator->on_event(animator, id, event, animator->data[i]);
+
+                // Stop if the callback stopped or changed the animation.
+                if(animation_get_slot(animator, id) != i || animator->clip[i] != clip_id)
+                    break;
+            }
+        }
+
+        if(animation_get_slot(animator, id) != i || !(animator->flags[i] & ANIMATION_FLAG_FINISHED_NOW))
+            continue;
+
+        animator->flags[i] &= ~ANIMATION_FLAG_FINISHED_NOW;
+        animator->on_event(animator, id, ANIMATION_EVENT_FINISHED, animator->data[i]);
+    }
+}
+
+void animator_update(Animator* animator, float delta) {
+    animator_advance(animator, delta);
+
+    if(!animator_update_frames(animator))
+        return;
+
+    if(animator->on_event != NULL) {
+        animator_send_events(animator);
+    } else {
+        for(int i = 0; i < animator->slot_count; i++)
+            animator->flags[i] &= ~ANIMATION_FLAG_FINISHED_NOW;
+    }
+}
@@ -0,0 +1,392 @@
+#include <su_assets.h>
+
+#define ASSET_CACHE_INITIAL_BUCKETS 64
+
+static SDL_Surface* asset_decode_bmp(const char* path, void* data) {
+    return SDL_LoadBMP(path);
+}
+
+static Uint32 asset_hash(const char* path) {
+    // FNV-1a
+    Uint32 hash = 2166136261u;
+    for(const char* c = path; *c != '\0'; c++) {
+        hash ^= (Uint8)*c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int asset_cache_worker(void* data) {
+    AssetCache* cache = data;
+
+    SDL_LockMutex(cache->mutex);
+    for(;;) {
+        while(cache->jobs_head == NULL && !cache->quit)
+            SDL_CondWait(cache->cond, cache->mutex);
+
+        if(cache->quit)
+            break;
+
+        Asset* asset = cache->jobs_head;
+        cache->jobs_head = asset->queue_next;
+        if(cache->jobs_head == NULL)
+            cache->jobs_tail = NULL;
+
+        // The path never changes and nothing else touches the surface
+        // of a loading asset, so the decode can run unlocked.
+        SDL_UnlockMutex(cache->mutex);
+        SDL_Surface* surface = cache->decode(asset->path, cache->decode_data);
+        SDL_LockMutex(cache->mutex);
+
+        asset->surface = surface;
+        asset->queue_next = cache->decoded;
+        cache->decoded = asset;
+    }
+    SDL_UnlockMutex(cache->mutex);
+
+    return 0;
+}
+
+SDL_bool asset_cache_init(AssetCache* cache, SDL_Renderer* renderer, int worker_count) {
+    SDL_memset(cache, 0, sizeof(*cache));
+
+    if(worker_count < 0)
+        worker_count = 0;
+    else if(worker_count > ASSET_CACHE_MAX_WORKERS)
+        worker_count = ASSET_CACHE_MAX_WORKERS;
+
+    cache->renderer = renderer;
+    cache->decode = asset_decode_bmp;
+    cache->vram_budget = SIZE_MAX;
+    cache->ram_budget = 0;
+
+    cache->buckets = su_calloc(ASSET_CACHE_INITIAL_BUCKETS, sizeof(Asset*));
+    if(cache->buckets == NULL) {
+        SDL_SetError("Could not create asset cache, not enough memory.");
+        return SDL_FALSE;
+    }
+    cache->bucket_count = ASSET_CACHE_INITIAL_BUCKETS;
+
+    cache->mutex = SDL_CreateMutex();
+    if(cache->mutex == NULL)
+        goto error;
+
+    cache->cond = SDL_CreateCond();
+    if(cache->cond == NULL)
+        goto error;
+
+    for(int i = 0; i < worker_count; i++) {
+        cache->workers[i] = SDL_CreateThread(asset_cache_worker, "asset_worker", cache);
+        if(cache->workers[i] == NULL)
+            goto error;
+        cache->worker_count++;
+    }
+
+    return SDL_TRUE;
+
+    error:
+        asset_cache_free_resources(cache);
+        return SDL_FALSE;
+}
+
+AssetCache* asset_cache_create(SDL_Renderer* renderer, int worker_count) {
+    AssetCache* cache = su_malloc(sizeof(*cache));
+    if(cache == NULL) {
+        SDL_SetError("Could not create asset cache, not enough memory.");
+        return NULL;
+    }
+
+    if(!asset_cache_init(cache, renderer, worker_count)) {
+        su_free(cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
+static void asset_destroy(Asset* asset) {
+    if(asset->texture != NULL)
+        SDL_DestroyTexture(asset->texture);
+    if(asset->surface != NULL)
+        SDL_FreeSurface(asset->surface);
+    su_free(asset->path);
+    su_free(asset);
+}
+
+void asset_cache_free_resources(AssetCache* cache) {
+    if(cache->mutex != NULL) {
+        SDL_LockMutex(cache->mutex);
+        cache->quit = SDL_TRUE;
+        if(cache->cond != NULL)
+            SDL_CondBroadcast(cache->cond);
+        SDL_UnlockMutex(cache->mutex);
+    }
+
+    for(int i = 0; i < cache->worker_count; i++)
+        SDL_WaitThread(cache->workers[i], NULL);
+
+    // Every asset is in the LRU list, including the ones still loading.
+    Asset* asset = cache->lru_head;
+    while(asset != NULL) {
+        Asset* next = asset->lru_next;
+        asset_destroy(asset);
+        asset = next;
+    }
+
+    if(cache->cond != NULL)
+        SDL_DestroyCond(cache->cond);
+    if(cache->mutex != NULL)
+        SDL_DestroyMutex(cache->mutex);
+
+    su_free(cache->buckets);
+    SDL_memset(cache, 0, sizeof(*cache));
+}
+
+void asset_cache_free(AssetCache* cache) {
+    asset_cache_free_resources(cache);
+    su_free(cache);
+}
+
+void asset_cache_set_decoder(AssetCache* cache, AssetDecodeFn decode, void* data) {
+    cache->decode = decode != NULL ? decode : asset_decode_bmp;
+    cache->decode_data = data;
+}
+
+void asset_cache_set_budget(AssetCache* cache, size_t vram_budget, size_t ram_budget) {
+    cache->vram_budget = vram_budget;
+    cache->ram_budget = ram_budget;
+}
+
+static void asset_lru_unlink(AssetCache* cache, Asset* asset) {
+    if(asset->lru_prev != NULL)
+        asset->lru_prev->lru_next = asset->lru_next;
+    else
+        cache->lru_head = asset->lru_next;
+
+    if(asset->lru_next != NULL)
+        asset->lru_next->lru_prev = asset->lru_prev;
+    else
+        cache->lru_tail = asset->lru_prev;
+
+    asset->lru_prev = NULL;
+    asset->lru_next = NULL;
+}
+
+static void asset_lru_push_front(AssetCache* cache, Asset* asset) {
+    asset->lru_prev = NULL;
+    asset->lru_next = cache->lru_head;
+    if(cache->lru_head != NULL)
+        cache->lru_head->lru_prev = asset;
+    else
+        cache->lru_tail = asset;
+    cache->lru_head = asset;
+}
+
+static void asset_cache_remove(AssetCache* cache, Asset* asset) {
+    Asset** link = cache->buckets + (asset->hash & (cache->bucket_count - 1));
+    while(*link != asset)
+        link = &(*link)->hash_next;
+    *link = asset->hash_next;
+
+    asset_lru_unlink(cache, asset);
+    cache->vram_used -= asset->texture != NULL ? asset->vram_size : 0;
+    cache->ram_used -= asset->surface != NULL ? asset->ram_size : 0;
+    cache->asset_count--;
+
+    asset_destroy(asset);
+}
+
+static void asset_cache_grow(AssetCache* cache) {
+    int bucket_count = cache->bucket_count * 2;
+    Asset** buckets = su_calloc(bucket_count, sizeof(Asset*));
+
+    // Longer chains still work, so just try again next time.
+    if(buckets == NULL)
+        return;
+
+    for(int i = 0; i < cache->bucket_count; i++) {
+        Asset* asset = cache->buckets[i];
+        while(asset != NULL) {
+            Asset* next = asset->hash_next;
+            Asset** bucket = buckets + (asset->hash & (bucket_count - 1));
+            asset->hash_next = *bucket;
+            *bucket = asset;
+            asset = next;
+        }
+    }
+
+    su_free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucket_count = bucket_count;
+}
+
+static SDL_bool asset_create_texture(AssetCache* cache, Asset* asset) {
+    asset->texture = SDL_CreateTextureFromSurface(cache->renderer, asset->surface);
+    if(asset->texture == NULL)
+        return SDL_FALSE;
+
+    cache->vram_used += asset->vram_size;
+    return SDL_TRUE;
+}
+
+static void asset_cache_enqueue(AssetCache* cache, Asset* asset) {
+    cache->loading++;
+    asset->state = ASSET_LOADING;
+    asset->queue_next = NULL;
+
+    SDL_LockMutex(cache->mutex);
+    if(cache->jobs_tail != NULL)
+        cache->jobs_tail->queue_next = asset;
+    else
+        cache->jobs_head = asset;
+    cache->jobs_tail = asset;
+    SDL_CondSignal(cache->cond);
+    SDL_UnlockMutex(cache->mutex);
+}
+
+Asset* asset_cache_load(AssetCache* cache, const char* path) {
+    Uint32 hash = asset_hash(path);
+
+    for(Asset* asset = cache->buckets[hash & (cache->bucket_count - 1)]; asset != NULL; asset = asset->hash_next) {
+        if(asset->hash != hash || SDL_strcmp(asset->path, path) != 0)
+            continue;
+
+        asset->references++;
+        asset_lru_unlink(cache, asset);
+        asset_lru_push_front(cache, asset);
+
+        // The texture was evicted, but the decoded copy wasn't, so restore it without decoding.
+        if(asset->state == ASSET_READY && asset->texture == NULL && !asset_create_texture(cache, asset))
+            asset->state = ASSET_FAILED;
+
+        return asset;
+    }
+
+    Asset* asset = su_malloc(sizeof(*asset));
+    if(asset == NULL) {
+        SDL_SetError("Could not load asset, not enough memory.");
+        return NULL;
+    }
+
+    SDL_memset(asset, 0, sizeof(*asset));
+
+    size_t length = SDL_strlen(path) + 1;
+    asset->path = su_malloc(length);
+    if(asset->path == NULL) {
+        su_free(asset);
+        SDL_SetError("Could not load asset, not enough memory.");
+        return NULL;
+    }
+
+    SDL_memcpy(asset->path, path, length);
+    asset->hash = hash;
+    asset->references = 1;
+
+    if(cache->asset_count >= cache->bucket_count)
+        asset_cache_grow(cache);
+
+    Asset** bucket = cache->buckets + (hash & (cache->bucket_count - 1));
+    asset->hash_next = *bucket;
+    *bucket = asset;
+    cache->asset_count++;
+
+    asset_lru_push_front(cache, asset);
+    asset_cache_enqueue(cache, asset);
+
+    return asset;
+}
+
+void asset_cache_release(AssetCache* cache, Asset* asset) {
+    if(asset == NULL || asset->references == 0)
+        return;
+
+    // Failed assets are dropped right away so the next load tries again.
+    if(--asset->references == 0 && asset->state == ASSET_FAILED)
+        asset_cache_remove(cache, asset);
+}
+
+static void asset_cache_upload(AssetCache* cache, Asset* asset) {
+    cache->loading--;
+
+    if(asset->surface == NULL) {
+        asset->state = ASSET_FAILED;
+    } else {
+        asset->width = asset->surface->w;
+        asset->height = asset->surface->h;
+        asset->vram_size = (size_t)asset->width * asset->height * 4;
+        asset->ram_size = (size_t)asset->surface->pitch * asset->height;
+        cache->ram_used += asset->ram_size;
+
+        asset->state = asset_create_texture(cache, asset) ? ASSET_READY : ASSET_FAILED;
+    }
+
+    if(asset->references == 0 && asset->state == ASSET_FAILED)
+        asset_cache_remove(cache, asset);
+}
+
+static void asset_cache_evict(AssetCache* cache) {
+    // Textures can only be evicted once nothing is drawing them.
+    Asset* asset = cache->lru_tail;
+    while(asset != NULL && cache->vram_used > cache->vram_budget) {
+        Asset* prev = asset->lru_prev;
+        if(asset->references == 0 && asset->texture != NULL) {
+            SDL_DestroyTexture(asset->texture);
+            asset->texture = NULL;
+            cache->vram_used -= asset->vram_size;
+            if(asset->surface == NULL)
+                asset_cache_remove(cache, asset);
+        }
+        asset = prev;
+    }
+
+    // The decoded copy is only needed again for an unreferenced asset whose texture was evicted.
+    asset = cache->lru_tail;
+    while(asset != NULL && cache->ram_used > cache->ram_budget) {
+        Asset* prev = asset->lru_prev;
+        if(asset->state == ASSET_READY && asset->surface != NULL) {
+            SDL_FreeSurface(asset->surface);
+            asset->surface = NULL;
+            cache->ram_used -= asset->ram_size;
+            if(asset->texture == NULL)
+                asset_cache_remove(cache, asset);
+        }
+        asset = prev;
+    }
+}
+
+void asset_cache_update(AssetCache* cache) {
+    SDL_LockMutex(cache->mutex);
+
+    // Without workers, the decoding happens here instead.
+    if(cache->worker_count == 0) {
+        while(cache->jobs_head != NULL) {
+            Asset* asset = cache->jobs_head;
+            cache->jobs_head = asset->queue_next;
+            asset->surface = cache->decode(asset->path, cache->decode_data);
+            asset->queue_next = cache->decoded;
+            cache->decoded = asset;
+        }
+        cache->jobs_tail = NULL;
+    }
+
+    Asset* decoded = cache->decoded;
+    cache->decoded = NULL;
+    SDL_UnlockMutex(cache->mutex);
+
+    while(decoded != NULL) {
+        Asset* next = decoded->queue_next;
+        asset_cache_upload(cache, decoded);
+        decoded = next;
+    }
+
+    asset_cache_evict(cache);
+}
+
+void asset_cache_finish(AssetCache* cache) {
+    for(;;) {
+        asset_cache_update(cache);
+        if(cache->loading == 0)
+            break;
+        SDL_Delay(1);
+    }
+}
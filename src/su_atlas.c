@@ -0,0 +1,553 @@
+#include <su_atlas.h>
+
+#define ATLAS_FILE_MAGIC 0x54415553
+#define ATLAS_FILE_VERSION 1
+
+typedef struct AtlasSortEntry {
+    AtlasRegionId id;
+    int height;
+} AtlasSortEntry;
+
+static SDL_bool atlas_page_init(AtlasPage* page, SDL_Renderer* renderer, int size) {
+    page->skyline = su_malloc(sizeof(AtlasSkylineNode) * 16);
+    if(page->skyline == NULL) {
+        SDL_SetError("Could not create atlas page, not enough memory for skyline.");
+        return SDL_FALSE;
+    }
+
+    page->skyline_capacity = 16;
+    page->skyline_count = 1;
+    page->skyline[0] = (AtlasSkylineNode){ 0, 0, size };
+
+    page->surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, ATLAS_PIXEL_FORMAT);
+    if(page->surface == NULL) {
+        su_free(page->skyline);
+        return SDL_FALSE;
+    }
+
+    page->texture = SDL_CreateTexture(renderer, ATLAS_PIXEL_FORMAT, SDL_TEXTUREACCESS_STATIC, size, size);
+    if(page->texture == NULL) {
+        SDL_FreeSurface(page->surface);
+        su_free(page->skyline);
+        return SDL_FALSE;
+    }
+
+    SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_BLEND);
+    return SDL_TRUE;
+}
+
+static void atlas_page_free(AtlasPage* page) {
+    SDL_DestroyTexture(page->texture);
+    SDL_FreeSurface(page->surface);
+    su_free(page->skyline);
+}
+
+static void atlas_free_pages(AtlasPage* pages, int count) {
+    for(int i = 0; i < count; i++)
+        atlas_page_free(pages + i);
+    su_free(pages);
+}
+
+// Returns the y position that a rectangle of the specified size would be placed
+// at if its left edge was aligned with the skyline node at index, or -1 if it doesn't fit.
+static int skyline_fit(AtlasPage* page, int size, int index, int width, int height) {
+    int x = page->skyline[index].x;
+    if(x + width > size)
+        return -1;
+
+    int y = 0;
+    int remaining = width;
+    while(remaining > 0) {
+        y = SDL_max(y, page->skyline[index].y);
+        if(y + height > size)
+            return -1;
+        remaining -= page->skyline[index].width;
+        index++;
+    }
+
+    return y;
+}
+
+static SDL_bool skyline_insert(AtlasPage* page, int index, int x, int y, int width) {
+    if(page->skyline_count == page->skyline_capacity) {
+        int capacity = page->skyline_capacity * 2;
+        AtlasSkylineNode* skyline = su_realloc(page->skyline, sizeof(AtlasSkylineNode) * capacity);
+        if(skyline == NULL) {
+            SDL_SetError("Could not pack atlas page, not enough memory for skyline.");
+            return SDL_FALSE;
+        }
+        page->skyline = skyline;
+        page->skyline_capacity = capacity;
+    }
+
+    su_memmove(page->skyline + index + 1, page->skyline + index, (page->skyline_count - index) * sizeof(AtlasSkylineNode));
+    page->skyline[index] = (AtlasSkylineNode){ x, y, width };
+    page->skyline_count++;
+
+    // Shrink or remove the nodes that are now covered by the new node.
+    for(int i = index + 1; i < page->skyline_count; i++) {
+        AtlasSkylineNode* previous = page->skyline + i - 1;
+        AtlasSkylineNode* node = page->skyline + i;
+        int overlap = previous->x + previous->width - node->x;
+        if(overlap <= 0)
+            break;
+
+        node->x += overlap;
+        node->width -= overlap;
+        if(node->width > 0)
+            break;
+
+        su_memmove(node, node + 1, (page->skyline_count - i - 1) * sizeof(AtlasSkylineNode));
+        page->skyline_count--;
+        i--;
+    }
+
+    // Merge neighbouring nodes at the same height.
+    for(int i = 0; i < page->skyline_count - 1; i++) {
+        if(page->skyline[i].y == page->skyline[i + 1].y) {
+            page->skyline[i].width += page->skyline[i + 1].width;
+            su_memmove(page->skyline + i + 1, page->skyline + i + 2, (page->skyline_count - i - 2) * sizeof(AtlasSkylineNode));
+            page->skyline_count--;
+            i--;
+        }
+    }
+
+    return SDL_TRUE;
+}
+
+// Finds the bottom-left-most position for the rectangle using the skyline algorithm.
+static SDL_bool atlas_page_pack(AtlasPage* page, int size, int width, int height, Point* position) {
+    int best_index = -1;
+    int best_bottom = SDL_MAX_SINT32;
+    int best_width = SDL_MAX_SINT32;
+
+    for(int i = 0; i < page->skyline_count; i++) {
+        int y = skyline_fit(page, size, i, width, height);
+        if(y < 0)
+            continue;
+
+        if(y + height < best_bottom || (y + height == best_bottom && page->skyline[i].width < best_width)) {
+            best_index = i;
+            best_bottom = y + height;
+            best_width = page->skyline[i].width;
+            position->x = page->skyline[i].x;
+            position->y = y;
+        }
+    }
+
+    if(best_index == -1)
+        return SDL_FALSE;
+
+    return skyline_insert(page, best_index, position->x, position->y + height, width);
+}
+
+static void copy_pixels(SDL_Surface* src, Rectangle src_rect, SDL_Surface* dst, int x, int y) {
+    Uint8* src_row = (Uint8*)src->pixels + src_rect.y * src->pitch + src_rect.x * 4;
+    Uint8* dst_row = (Uint8*)dst->pixels + y * dst->pitch + x * 4;
+    for(int row = 0; row < src_rect.h; row++) {
+        SDL_memcpy(dst_row, src_row, src_rect.w * 4);
+        src_row += src->pitch;
+        dst_row += dst->pitch;
+    }
+}
+
+static AtlasPage* atlas_add_page(TextureAtlas* atlas) {
+    if(atlas->page_count == atlas->page_capacity) {
+        int capacity = atlas->page_capacity == 0 ? 2 : atlas->page_capacity * 2;
+        AtlasPage* pages = su_realloc(atlas->pages, sizeof(AtlasPage) * capacity);
+        if(pages == NULL) {
+            SDL_SetError("Could not add atlas page, not enough memory.");
+            return NULL;
+        }
+        atlas->pages = pages;
+        atlas->page_capacity = capacity;
+    }
+
+    AtlasPage* page = atlas->pages + atlas->page_count;
+    if(!atlas_page_init(page, atlas->renderer, atlas->page_size))
+        return NULL;
+
+    atlas->page_count++;
+    return page;
+}
+
+static SDL_bool atlas_reserve_regions(TextureAtlas* atlas, int count) {
+    if(count <= atlas->region_capacity)
+        return SDL_TRUE;
+
+    int capacity = atlas->region_capacity == 0 ? 16 : atlas->region_capacity;
+    while(capacity < count)
+        capacity *= 2;
+
+    AtlasRegion* regions = su_realloc(atlas->regions, sizeof(AtlasRegion) * capacity);
+    if(regions == NULL)
+        goto error;
+    atlas->regions = regions;
+
+    int* region_pages = su_realloc(atlas->region_pages, sizeof(int) * capacity);
+    if(region_pages == NULL)
+        goto error;
+    atlas->region_pages = region_pages;
+
+    atlas->region_capacity = capacity;
+    return SDL_TRUE;
+
+    error:
+        SDL_SetError("Could not add atlas region, not enough memory.");
+        return SDL_FALSE;
+}
+
+SDL_bool atlas_init(TextureAtlas* atlas, SDL_Renderer* renderer, int page_size, int max_page_size, int padding) {
+    if(page_size <= 0 || max_page_size < page_size || padding < 0) {
+        SDL_SetError("Could not initialize atlas, invalid page size.");
+        return SDL_FALSE;
+    }
+
+    atlas->renderer = renderer;
+    atlas->pages = NULL;
+    atlas->page_count = 0;
+    atlas->page_capacity = 0;
+    atlas->page_size = page_size;
+    atlas->max_page_size = max_page_size;
+    atlas->padding = padding;
+    atlas->regions = NULL;
+    atlas->region_pages = NULL;
+    atlas->region_count = 0;
+    atlas->region_capacity = 0;
+    atlas->generation = 0;
+    return SDL_TRUE;
+}
+
+TextureAtlas* atlas_create(SDL_Renderer* renderer, int page_size, int max_page_size, int padding) {
+    TextureAtlas* atlas = su_malloc(sizeof(*atlas));
+    if(atlas == NULL)
+        return NULL;
+
+    if(!atlas_init(atlas, renderer, page_size, max_page_size, padding)) {
+        su_free(atlas);
+        return NULL;
+    }
+
+    return atlas;
+}
+
+void atlas_free_resources(TextureAtlas* atlas) {
+    atlas_free_pages(atlas->pages, atlas->page_count);
+    su_free(atlas->regions);
+    su_free(atlas->region_pages);
+    atlas->pages = NULL;
+    atlas->regions = NULL;
+    atlas->region_pages = NULL;
+    atlas->page_count = 0;
+    atlas->page_capacity = 0;
+    atlas->region_count = 0;
+    atlas->region_capacity = 0;
+}
+
+void atlas_free(TextureAtlas* atlas) {
+    atlas_free_resources(atlas);
+    su_free(atlas);
+}
+
+static SDL_bool atlas_place(TextureAtlas* atlas, int width, int height, int* page_index, Point* position) {
+    int padded_width = width + atlas->padding;
+    int padded_height = height + atlas->padding;
+
+    for(int i = 0; i < atlas->page_count; i++) {
+        if(atlas_page_pack(atlas->pages + i, atlas->page_size, padded_width, padded_height, position)) {
+            *page_index = i;
+            return SDL_TRUE;
+        }
+    }
+
+    return SDL_FALSE;
+}
+
+AtlasRegionId atlas_add(TextureAtlas* atlas, SDL_Surface* surface) {
+    int padded_width = surface->w + atlas->padding;
+    int padded_height = surface->h + atlas->padding;
+    if(padded_width > atlas->max_page_size || padded_height > atlas->max_page_size) {
+        SDL_SetError("Could not add image to atlas, it's larger than the max page size.");
+        return ATLAS_REGION_INVALID;
+    }
+
+    if(!atlas_reserve_regions(atlas, atlas->region_count + 1))
+        return ATLAS_REGION_INVALID;
+
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, ATLAS_PIXEL_FORMAT, 0);
+    if(converted == NULL)
+        return ATLAS_REGION_INVALID;
+
+    int page_index;
+    Point position;
+
+    if(!atlas_place(atlas, surface->w, surface->h, &page_index, &position)) {
+        // Grow the pages first since a rebuild packs more tightly than
+        // adding the images one at a time. Once they can't grow anymore,
+        // start a new page.
+        SDL_bool placed = SDL_FALSE;
+        if(atlas->page_count > 0 && atlas->page_size < atlas->max_page_size) {
+            int size = atlas->page_size;
+            do {
+                size = SDL_min(size * 2, atlas->max_page_size);
+            } while(size < padded_width || size < padded_height);
+
+            if(atlas_rebuild(atlas, size))
+                placed = atlas_place(atlas, surface->w, surface->h, &page_index, &position);
+        }
+
+        if(!placed) {
+            if(atlas->page_count == 0) {
+                while(atlas->page_size < padded_width || atlas->page_size < padded_height)
+                    atlas->page_size = SDL_min(atlas->page_size * 2, atlas->max_page_size);
+            }
+
+            if(atlas_add_page(atlas) == NULL || !atlas_place(atlas, surface->w, surface->h, &page_index, &position)) {
+                SDL_FreeSurface(converted);
+                return ATLAS_REGION_INVALID;
+            }
+        }
+    }
+
+    AtlasPage* page = atlas->pages + page_index;
+    Rectangle rect = { position.x, position.y, surface->w, surface->h };
+
+    copy_pixels(converted, (Rectangle){ 0, 0, surface->w, surface->h }, page->surface, rect.x, rect.y);
+    SDL_UpdateTexture(page->texture, &rect, converted->pixels, converted->pitch);
+    SDL_FreeSurface(converted);
+
+    AtlasRegionId id = atlas->region_count++;
+    atlas->regions[id] = (AtlasRegion){ page->texture, rect };
+    atlas->region_pages[id] = page_index;
+    return id;
+}
+
+static int atlas_sort_compare(const void* left, const void* right) {
+    const AtlasSortEntry* a = left;
+    const AtlasSortEntry* b = right;
+    if(a->height != b->height)
+        return b->height - a->height;
+    return a->id - b->id;
+}
+
+SDL_bool atlas_rebuild(TextureAtlas* atlas, int page_size) {
+    AtlasSortEntry* order = NULL;
+    AtlasRegion* regions = NULL;
+    int* region_pages = NULL;
+
+    TextureAtlas rebuilt;
+    if(!atlas_init(&rebuilt, atlas->renderer, page_size, SDL_max(page_size, atlas->max_page_size), atlas->padding))
+        return SDL_FALSE;
+
+    if(atlas->region_count == 0) {
+        atlas->page_size = page_size;
+        return SDL_TRUE;
+    }
+
+    order = su_malloc(sizeof(AtlasSortEntry) * atlas->region_count);
+    regions = su_malloc(sizeof(AtlasRegion) * atlas->region_count);
+    region_pages = su_malloc(sizeof(int) * atlas->region_count);
+    if(order == NULL || regions == NULL || region_pages == NULL) {
+        SDL_SetError("Could not rebuild atlas, not enough memory.");
+        goto error;
+    }
+
+    for(int i = 0; i < atlas->region_count; i++)
+        order[i] = (AtlasSortEntry){ i, atlas->regions[i].rect.h };
+
+    SDL_qsort(order, atlas->region_count, sizeof(AtlasSortEntry), atlas_sort_compare);
+
+    for(int i = 0; i < atlas->region_count; i++) {
+        AtlasRegionId id = order[i].id;
+        Rectangle old_rect = atlas->regions[id].rect;
+        int page_index;
+        Point position;
+
+        if(!atlas_place(&rebuilt, old_rect.w, old_rect.h, &page_index, &position)) {
+            if(atlas_add_page(&rebuilt) == NULL)
+                goto error;
+            if(!atlas_place(&rebuilt, old_rect.w, old_rect.h, &page_index, &position)) {
+                SDL_SetError("Could not rebuild atlas, an image is larger than the page size.");
+                goto error;
+            }
+        }
+
+        AtlasPage* page = rebuilt.pages + page_index;
+        copy_pixels(atlas->pages[atlas->region_pages[id]].surface, old_rect, page->surface, position.x, position.y);
+        regions[id] = (AtlasRegion){ page->texture, { position.x, position.y, old_rect.w, old_rect.h } };
+        region_pages[id] = page_index;
+    }
+
+    for(int i = 0; i < rebuilt.page_count; i++) {
+        AtlasPage* page = rebuilt.pages + i;
+        if(SDL_UpdateTexture(page->texture, NULL, page->surface->pixels, page->surface->pitch) != 0)
+            goto error;
+    }
+
+    atlas_free_pages(atlas->pages, atlas->page_count);
+    atlas->pages = rebuilt.pages;
+    atlas->page_count = rebuilt.page_count;
+    atlas->page_capacity = rebuilt.page_capacity;
+    atlas->page_size = page_size;
+    atlas->generation++;
+    SDL_memcpy(atlas->regions, regions, sizeof(AtlasRegion) * atlas->region_count);
+    SDL_memcpy(atlas->region_pages, region_pages, sizeof(int) * atlas->region_count);
+
+    su_free(order);
+    su_free(regions);
+    su_free(region_pages);
+    return SDL_TRUE;
+
+    error:
+        atlas_free_pages(rebuilt.pages, rebuilt.page_count);
+        su_free(order);
+        su_free(regions);
+        su_free(region_pages);
+        return SDL_FALSE;
+}
+
+SDL_bool atlas_save(TextureAtlas* atlas, const char* file) {
+    SDL_RWops* rw = SDL_RWFromFile(file, "wb");
+    if(rw == NULL)
+        return SDL_FALSE;
+
+    size_t ok = 1;
+    ok &= SDL_WriteLE32(rw, ATLAS_FILE_MAGIC);
+    ok &= SDL_WriteLE32(rw, ATLAS_FILE_VERSION);
+    ok &= SDL_WriteLE32(rw, atlas->page_size);
+    ok &= SDL_WriteLE32(rw, atlas->page_count);
+    ok &= SDL_WriteLE32(rw, atlas->region_count);
+
+    for(int i = 0; i < atlas->region_count; i++) {
+        Rectangle rect = atlas->regions[i].rect;
+        ok &= SDL_WriteLE32(rw, atlas->region_pages[i]);
+        ok &= SDL_WriteLE32(rw, rect.x);
+        ok &= SDL_WriteLE32(rw, rect.y);
+        ok &= SDL_WriteLE32(rw, rect.w);
+        ok &= SDL_WriteLE32(rw, rect.h);
+    }
+
+    for(int i = 0; i < atlas->page_count && ok; i++) {
+        AtlasPage* page = atlas->pages + i;
+        ok &= SDL_WriteLE32(rw, page->skyline_count);
+        for(int j = 0; j < page->skyline_count; j++) {
+            ok &= SDL_WriteLE32(rw, page->skyline[j].x);
+            ok &= SDL_WriteLE32(rw, page->skyline[j].y);
+            ok &= SDL_WriteLE32(rw, page->skyline[j].width);
+        }
+
+        Uint8* row = page->surface->pixels;
+        for(int y = 0; y < page->surface->h && ok; y++, row += page->surface->pitch)
+            ok &= SDL_RWwrite(rw, row, page->surface->w * 4, 1);
+    }
+
+    if(SDL_RWclose(rw) != 0 || !ok) {
+        SDL_SetError("Could not write atlas to %s.", file);
+        return SDL_FALSE;
+    }
+
+    return SDL_TRUE;
+}
+
+static SDL_bool atlas_rect_in_page(Rectangle rect, int page_size) {
+    return rect.x >= 0 && rect.y >= 0 && rect.w >= 0 && rect.h >= 0
+        && rect.w <= page_size - rect.x
+        && rect.h <= page_size - rect.y;
+}
+
+SDL_bool atlas_load(TextureAtlas* atlas, SDL_Renderer* renderer, const char* file, int max_page_size, int padding) {
+    SDL_RWops* rw = SDL_RWFromFile(file, "rb");
+    if(rw == NULL)
+        return SDL_FALSE;
+
+    if(SDL_ReadLE32(rw) != ATLAS_FILE_MAGIC || SDL_ReadLE32(rw) != ATLAS_FILE_VERSION) {
+        SDL_SetError("%s is not an atlas file.", file);
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+
+    int page_size = (int)SDL_ReadLE32(rw);
+    int page_count = (int)SDL_ReadLE32(rw);
+    int region_count = (int)SDL_ReadLE32(rw);
+
+    if(page_size <= 0) {
+        SDL_SetError("Could not load atlas, %s is corrupt.", file);
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+
+    if(!atlas_init(atlas, renderer, page_size, SDL_max(page_size, max_page_size), padding)) {
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+
+    if(page_count < 0 || region_count < 0 || !atlas_reserve_regions(atlas, region_count))
+        goto error;
+
+    for(int i = 0; i < region_count; i++) {
+        atlas->region_pages[i] = (int)SDL_ReadLE32(rw);
+        Rectangle* rect = &atlas->regions[i].rect;
+        rect->x = (int)SDL_ReadLE32(rw);
+        rect->y = (int)SDL_ReadLE32(rw);
+        rect->w = (int)SDL_ReadLE32(rw);
+        rect->h = (int)SDL_ReadLE32(rw);
+        if(atlas->region_pages[i] < 0 || atlas->region_pages[i] >= page_count)
+            goto corrupt;
+
+        // Rebuilding copies the pixels of every region, so they have to fit in their page.
+        if(!atlas_rect_in_page(*rect, page_size))
+            goto corrupt;
+    }
+    atlas->region_count = region_count;
+
+    for(int i = 0; i < page_count; i++) {
+        AtlasPage* page = atlas_add_page(atlas);
+        if(page == NULL)
+            goto error;
+
+        int skyline_count = (int)SDL_ReadLE32(rw);
+        if(skyline_count <= 0 || skyline_count > page_size)
+            goto corrupt;
+
+        if(skyline_count > page->skyline_capacity) {
+            AtlasSkylineNode* skyline = su_realloc(page->skyline, sizeof(AtlasSkylineNode) * skyline_count);
+            if(skyline == NULL)
+                goto error;
+            page->skyline = skyline;
+            page->skyline_capacity = skyline_count;
+        }
+
+        page->skyline_count = skyline_count;
+        for(int j = 0; j < skyline_count; j++) {
+            page->skyline[j].x = (int)SDL_ReadLE32(rw);
+            page->skyline[j].y = (int)SDL_ReadLE32(rw);
+            page->skyline[j].width = (int)SDL_ReadLE32(rw);
+
+            AtlasSkylineNode* node = page->skyline + j;
+            if(!atlas_rect_in_page((Rectangle){ node->x, node->y, node->width, 0 }, page_size) || node->width == 0)
+                goto corrupt;
+        }
+
+        Uint8* row = page->surface->pixels;
+        for(int y = 0; y < page->surface->h; y++, row += page->surface->pitch) {
+            if(SDL_RWread(rw, row, page->surface->w * 4, 1) != 1)
+                goto corrupt;
+        }
+
+        if(SDL_UpdateTexture(page->texture, NULL, page->surface->pixels, page->surface->pitch) != 0)
+            goto error;
+    }
+
+    for(int i = 0; i < region_count; i++)
+        atlas->regions[i].texture = atlas->pages[atlas->region_pages[i]].texture;
+
+    SDL_RWclose(rw);
+    return SDL_TRUE;
+
+    corrupt:
+        SDL_SetError("Could not load atlas, %s is corrupt.", file);
+    error:
+        SDL_RWclose(rw);
+        atlas_free_resources(atlas);
+        return SDL_FALSE;
+}
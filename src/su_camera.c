@@ -1,5 +1,7 @@
 #include <su_camera.h>
 
+#include <su_metrics.h>
+
 SDL_bool camera_init(Camera* camera, SDL_Renderer* renderer, int width, int height, Rectangle* viewport, Uint32 pixel_format) {
     camera->render_target = SDL_CreateTexture(renderer, pixel_format, SDL_TEXTUREACCESS_TARGET, width, height);
     if(camera->render_target == NULL)
@@ -13,6 +15,7 @@ SDL_bool camera_init(Camera* camera, SDL_Renderer* renderer, int width, int heig
     camera->renderer = renderer;
     camera->viewport = viewport;
     camera->pixel_format = pixel_format;
+    camera->render_scale = 1;
     return SDL_TRUE;
 }
 
@@ -44,6 +47,7 @@ SDL_bool camera_set_size(Camera* camera, Point size) {
 
     SDL_DestroyTexture(camera->render_target);
     camera->render_target = texture;
+    metrics_add(METRIC_CAMERA_RENDER_TARGETS, 1);
 
     return SDL_TRUE;
 }
@@ -60,6 +64,7 @@ SDL_bool camera_set_width(Camera* camera, int width) {
 
     SDL_DestroyTexture(camera->render_target);
     camera->render_target = texture;
+    metrics_add(METRIC_CAMERA_RENDER_TARGETS, 1);
 
     return SDL_TRUE;
 }
@@ -76,6 +81,7 @@ SDL_bool camera_set_height(Camera* camera, int height) {
 
     SDL_DestroyTexture(camera->render_target);
     camera->render_target = texture;
+    metrics_add(METRIC_CAMERA_RENDER_TARGETS, 1);
 
     return SDL_TRUE;
 }
\ No newline at end of file
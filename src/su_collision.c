@@ -0,0 +1,398 @@
+#include <su_collision.h>
+
+#include <math.h>
+
+void collision_world_init(CollisionWorld* world) {
+    SDL_memset(world, 0, sizeof(*world));
+}
+
+CollisionWorld* collision_world_create(void) {
+    CollisionWorld* world = su_malloc(sizeof(*world));
+    if(world == NULL)
+        return NULL;
+
+    collision_world_init(world);
+    return world;
+}
+
+void collision_world_free_resources(CollisionWorld* world) {
+    su_free(world->min_x);
+    su_free(world->min_y);
+    su_free(world->max_x);
+    su_free(world->max_y);
+    su_free(world->mask);
+    su_free(world->data);
+    su_free(world->alive);
+    su_free(world->free_list);
+    su_free(world->order);
+    su_free(world->pairs);
+    collision_world_init(world);
+}
+
+void collision_world_free(CollisionWorld* world) {
+    collision_world_free_resources(world);
+    su_free(world);
+}
+
+#define COLLISION_WORLD_GROW(field) \
+    do { \
+        void* grown = su_realloc(world->field, sizeof(*world->field) * capacity); \
+        if(grown == NULL) \
+            return SDL_FALSE; \
+        world->field = grown; \
+    } while(0)
+
+static SDL_bool collision_world_grow(CollisionWorld* world) {
+    int capacity = world->body_capacity == 0 ? 64 : world->body_capacity * 2;
+
+    // The arrays that were grown before a failure keep working at the old capacity.
+    COLLISION_WORLD_GROW(min_x);
+    COLLISION_WORLD_GROW(min_y);
+    COLLISION_WORLD_GROW(max_x);
+    COLLISION_WORLD_GROW(max_y);
+    COLLISION_WORLD_GROW(mask);
+    COLLISION_WORLD_GROW(data);
+    COLLISION_WORLD_GROW(alive);
+    COLLISION_WORLD_GROW(free_list);
+    COLLISION_WORLD_GROW(order);
+
+    world->body_capacity = capacity;
+    return SDL_TRUE;
+}
+
+#undef COLLISION_WORLD_GROW
+
+int collision_world_add(CollisionWorld* world, const SDL_FRect* box, Uint32 mask, void* data) {
+    int body;
+
+    if(world->free_count > 0) {
+        body = world->free_list[--world->free_count];
+    } else {
+        if(world->body_count == world->body_capacity && !collision_world_grow(world)) {
+            SDL_SetError("Could not add collision body, not enough memory.");
+            return -1;
+        }
+        body = world->body_count++;
+    }
+
+    world->mask[body] = mask;
+    world->data[body] = data;
+    world->alive[body] = SDL_TRUE;
+    collision_world_set_box(world, body, box);
+
+    // Put the body at the end, the next sort moves it into place.
+    world->order[world->order_count++] = body;
+
+    return body;
+}
+
+void collision_world_remove(CollisionWorld* world, int body) {
+    if(body < 0 || body >= world->body_count || !world->alive[body])
+        return;
+
+    world->alive[body] = SDL_FALSE;
+    world->free_list[world->free_count++] = body;
+
+    for(int i = 0; i < world->order_count; i++) {
+        if(world->order[i] == body) {
+            su_memmove(world->order + i, world->order + i + 1, sizeof(int) * (world->order_count - i - 1));
+            world->order_count--;
+            break;
+        }
+    }
+}
+
+static void collision_world_sort(CollisionWorld* world) {
+    if(!world->dirty)
+        return;
+
+    int* order = world->order;
+    float* min_x = world->min_x;
+    float max_width = 0;
+
+    for(int i = 0; i < world->order_count; i++) {
+        int body = order[i];
+        float key = min_x[body];
+        int j = i - 1;
+        while(j >= 0 && min_x[order[j]] > key) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = body;
+
+        float width = world->max_x[body] - key;
+        if(width > max_width)
+            max_width = width;
+    }
+
+    world->max_width = max_width;
+    world->dirty = SDL_FALSE;
+}
+
+static SDL_bool collision_world_push_pair(CollisionWorld* world, int a, int b) {
+    if(world->pair_count == world->pair_capacity) {
+        int capacity = world->pair_capacity == 0 ? 64 : world->pair_capacity * 2;
+        CollisionPair* pairs = su_realloc(world->pairs, sizeof(CollisionPair) * capacity);
+        if(pairs == NULL)
+            return SDL_FALSE;
+        world->pairs = pairs;
+        world->pair_capacity = capacity;
+    }
+
+    world->pairs[world->pair_count++] = a < b ? (CollisionPair){ a, b } : (CollisionPair){ b, a };
+    return SDL_TRUE;
+}
+
+int collision_world_update(CollisionWorld* world) {
+    collision_world_sort(world);
+
+    int* order = world->order;
+    float* min_x = world->min_x;
+    float* min_y = world->min_y;
+    float* max_x = world->max_x;
+    float* max_y = world->max_y;
+    Uint32* mask = world->mask;
+
+    world->pair_count = 0;
+
+    for(int i = 0; i < world->order_count; i++) {
+        int a = order[i];
+        float right = max_x[a];
+
+        // Every body after this one starts further right, so stop at the
+        // first one that starts past the right edge.
+        for(int j = i + 1; j < world->order_count; j++) {
+            int b = order[j];
+            if(min_x[b] >= right)
+                break;
+
+            if(min_y[a] < max_y[b] && min_y[b] < max_y[a] && (mask[a] & mask[b]) != 0) {
+                if(!collision_world_push_pair(world, a, b)) {
+                    SDL_SetError("Could not store collision pairs, not enough memory.");
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return world->pair_count;
+}
+
+// Finds the first position in the sorted order whose body could reach past x.
+static int collision_world_lower_bound(CollisionWorld* world, float x) {
+    int low = 0;
+    int high = world->order_count;
+
+    while(low < high) {
+        int middle = low + (high - low) / 2;
+        if(world->min_x[world->order[middle]] + world->max_width <= x)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+int collision_world_query(CollisionWorld* world, const SDL_FRect* area, int* results, int max_results) {
+    collision_world_sort(world);
+
+    float left = area->x;
+    float top = area->y;
+    float right = area->x + area->w;
+    float bottom = area->y + area->h;
+    int found = 0;
+
+    for(int i = collision_world_lower_bound(world, left); i < world->order_count; i++) {
+        int body = world->order[i];
+        if(world->min_x[body] >= right)
+            break;
+
+        if(world->max_x[body] > left && world->min_y[body] < bottom && world->max_y[body] > top) {
+            if(found < max_results)
+                results[found] = body;
+            found++;
+        }
+    }
+
+    return found;
+}
+
+SDL_bool collision_sweep(const SDL_FRect* box, Vector2 motion, const SDL_FRect* target, float* time, Vector2* normal) {
+    float enter_x, exit_x, enter_y, exit_y;
+
+    // Treat the box as a point moving through the target grown by the size of the box.
+    if(motion.x == 0) {
+        if(box->x + box->w <= target->x || box->x >= target->x + target->w)
+            return SDL_FALSE;
+        enter_x = -INFINITY;
+        exit_x = INFINITY;
+    } else {
+        float near_x = motion.x > 0 ? target->x - (box->x + box->w) : target->x + target->w - box->x;
+        float far_x = motion.x > 0 ? target->x + target->w - box->x : target->x - (box->x + box->w);
+        enter_x = near_x / motion.x;
+        exit_x = far_x / motion.x;
+    }
+
+    if(motion.y == 0) {
+        if(box->y + box->h <= target->y || box->y >= target->y + target->h)
+            return SDL_FALSE;
+        enter_y = -INFINITY;
+        exit_y = INFINITY;
+    } else {
+        float near_y = motion.y > 0 ? target->y - (box->y + box->h) : target->y + target->h - box->y;
+        float far_y = motion.y > 0 ? target->y + target->h - box->y : target->y - (box->y + box->h);
+        enter_y = near_y / motion.y;
+        exit_y = far_y / motion.y;
+    }
+
+    float enter = SDL_max(enter_x, enter_y);
+    float exit = SDL_min(exit_x, exit_y);
+
+    if(enter >= exit || enter > 1 || exit <= 0)
+        return SDL_FALSE;
+
+    if(enter < 0) {
+        // The boxes already overlap.
+        *time = 0;
+        if(normal != NULL)
+            *normal = (Vector2){ 0, 0 };
+        return SDL_TRUE;
+    }
+
+    *time = enter;
+    if(normal != NULL) {
+        if(enter_x > enter_y)
+            *normal = (Vector2){ motion.x > 0 ? -1.0f : 1.0f, 0 };
+        else
+            *normal = (Vector2){ 0, motion.y > 0 ? -1.0f : 1.0f };
+    }
+
+    return SDL_TRUE;
+}
+
+int collision_world_sweep(CollisionWorld* world, int body, Vector2 motion, float* time, Vector2* normal) {
+    SDL_FRect box = collision_world_get_box(world, body);
+
+    // Only bodies that touch the area covered by the whole motion can be hit.
+    SDL_FRect area = {
+        motion.x < 0 ? box.x + motion.x : box.x,
+        motion.y < 0 ? box.y + motion.y : box.y,
+        box.w + fabsf(motion.x),
+        box.h + fabsf(motion.y)
+    };
+
+    collision_world_sort(world);
+
+    int hit = -1;
+    float best = 2;
+
+    for(int i = collision_world_lower_bound(world, area.x); i < world->order_count; i++) {
+        int other = world->order[i];
+        if(world->min_x[other] > area.x + area.w)
+            break;
+        if(other == body || (world->mask[other] & world->mask[body]) == 0)
+            continue;
+
+        SDL_FRect target = collision_world_get_box(world, other);
+        float t;
+        Vector2 n;
+        if(collision_sweep(&box, motion, &target, &t, &n) && t < best) {
+            best = t;
+            hit = other;
+            if(normal != NULL)
+                *normal = n;
+        }
+    }
+
+    if(hit != -1)
+        *time = best;
+
+    return hit;
+}
+
+static inline SDL_bool collision_tile_solid(Tilemap* tilemap, int layer, int x, int y, TileSolidFn solid, void* data) {
+    TileId tile = tilemap_get_tile(tilemap, layer, x, y);
+    if(solid == NULL)
+        return tile != TILE_EMPTY;
+    return solid(tile, data);
+}
+
+// Checks a column of tiles (or a row when vertical is set) for a solid tile.
+static SDL_bool collision_tile_line(Tilemap* tilemap, int layer, int line, int start, int end, SDL_bool vertical, TileSolidFn solid, void* data) {
+    for(int i = start; i <= end; i++) {
+        if(vertical ? collision_tile_solid(tilemap, layer, i, line, solid, data)
+                    : collision_tile_solid(tilemap, layer, line, i, solid, data))
+        {
+            return SDL_TRUE;
+        }
+    }
+
+    return SDL_FALSE;
+}
+
+int collision_move_on_tilemap(Tilemap* tilemap, int layer, SDL_FRect* box, Vector2 motion, TileSolidFn solid, void* data) {
+    float tile_width = (float)tilemap->tile_width;
+    float tile_height = (float)tilemap->tile_height;
+    int result = COLLISION_NONE;
+
+    if(motion.x != 0) {
+        int row_start = (int)floorf(box->y / tile_height);
+        int row_end = (int)ceilf((box->y + box->h) / tile_height) - 1;
+
+        if(motion.x > 0) {
+            float edge = box->x + box->w;
+            int column_end = (int)ceilf((edge + motion.x) / tile_width) - 1;
+            box->x += motion.x;
+            for(int column = (int)ceilf(edge / tile_width); column <= column_end; column++) {
+                if(collision_tile_line(tilemap, layer, column, row_start, row_end, SDL_FALSE, solid, data)) {
+                    box->x = column * tile_width - box->w;
+                    result |= COLLISION_RIGHT;
+                    break;
+                }
+            }
+        } else {
+            float edge = box->x;
+            int column_end = (int)floorf((edge + motion.x) / tile_width);
+            box->x += motion.x;
+            for(int column = (int)floorf(edge / tile_width) - 1; column >= column_end; column--) {
+                if(collision_tile_line(tilemap, layer, column, row_start, row_end, SDL_FALSE, solid, data)) {
+                    box->x = (column + 1) * tile_width;
+                    result |= COLLISION_LEFT;
+                    break;
+                }
+            }
+        }
+    }
+
+    if(motion.y != 0) {
+        int column_start = (int)floorf(box->x / tile_width);
+        int column_end = (int)ceilf((box->x + box->w) / tile_width) - 1;
+
+        if(motion.y > 0) {
+            float edge = box->y + box->h;
+            int row_end = (int)ceilf((edge + motion.y) / tile_height) - 1;
+            box->y += motion.y;
+            for(int row = (int)ceilf(edge / tile_height); row <= row_end; row++) {
+                if(collision_tile_line(tilemap, layer, row, column_start, column_end, SDL_TRUE, solid, data)) {
+                    box->y = row * tile_height - box->h;
+                    result |= COLLISION_BOTTOM;
+                    break;
+                }
+            }
+        } else {
+            float edge = box->y;
+            int row_end = (int)floorf((edge + motion.y) / tile_height);
+            box->y += motion.y;
+            for(int row = (int)floorf(edge / tile_height) - 1; row >= row_end; row--) {
+                if(collision_tile_line(tilemap, layer, row, column_start, column_end, SDL_TRUE, solid, data)) {
+                    box->y = (row + 1) * tile_height;
+                    result |= COLLISION_TOP;
+                    break;
+                }
+            }
+        }
+    }
+
+    return result;
+}
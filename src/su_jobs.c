@@ -0,0 +1,325 @@
+#include <su_jobs.h>
+
+static void job_execute(const Job* job) {
+    if(job->range_fn != NULL)
+        job->range_fn(job->start, job->end, job->data);
+    else
+        job->fn(job->data);
+
+    // The job is a copy, so nothing touches the queue after the waiter is released.
+    if(job->counter != NULL)
+        SDL_AtomicAdd(&job->counter->pending, -1);
+}
+
+static JobQueue* job_current_queue(JobSystem* system) {
+    JobQueue* queue = SDL_TLSGet(system->queue_id);
+    return queue != NULL ? queue : system->queues;
+}
+
+static SDL_bool job_queue_pop(JobQueue* queue, Job* job) {
+    SDL_bool found = SDL_FALSE;
+
+    SDL_AtomicLock(&queue->lock);
+    if(queue->bottom != queue->top) {
+        queue->bottom--;
+        *job = queue->jobs[queue->bottom & (JOB_QUEUE_CAPACITY - 1)];
+        found = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&queue->lock);
+
+    return found;
+}
+
+static SDL_bool job_queue_steal(JobQueue* queue, Job* job) {
+    SDL_bool found = SDL_FALSE;
+
+    SDL_AtomicLock(&queue->lock);
+    if(queue->bottom != queue->top) {
+        *job = queue->jobs[queue->top & (JOB_QUEUE_CAPACITY - 1)];
+        queue->top++;
+        found = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&queue->lock);
+
+    return found;
+}
+
+static SDL_bool job_take(JobSystem* system, int index, Job* job) {
+    // Newest first from the own queue while its data is still in the cache,
+    // oldest first from the others since those are usually the largest pieces of work.
+    if(!job_queue_pop(system->queues + index, job)) {
+        int count = system->queue_count;
+        int i = 1;
+        for(; i < count; i++) {
+            if(job_queue_steal(system->queues + (index + i) % count, job))
+                break;
+        }
+
+        if(i >= count)
+            return SDL_FALSE;
+    }
+
+    SDL_AtomicAdd(&system->queued, -1);
+    return SDL_TRUE;
+}
+
+static void job_push(JobSystem* system, const Job* job) {
+    JobQueue* queue = job_current_queue(system);
+
+    SDL_AtomicLock(&queue->lock);
+    if(queue->bottom - queue->top == JOB_QUEUE_CAPACITY) {
+        SDL_AtomicUnlock(&queue->lock);
+        job_execute(job);
+        return;
+    }
+
+    queue->jobs[queue->bottom & (JOB_QUEUE_CAPACITY - 1)] = *job;
+    queue->bottom++;
+    SDL_AtomicUnlock(&queue->lock);
+
+    // A worker marks itself as sleeping before checking for jobs, so either it
+    // sees this job or this sees it sleeping and wakes it up.
+    SDL_AtomicAdd(&system->queued, 1);
+    if(SDL_AtomicGet(&system->sleeping) > 0) {
+        SDL_LockMutex(system->mutex);
+        SDL_CondSignal(system->wake);
+        SDL_UnlockMutex(system->mutex);
+    }
+}
+
+static int job_worker(void* data) {
+    JobQueue* queue = data;
+    JobSystem* system = queue->system;
+    Job job;
+
+    SDL_TLSSet(system->queue_id, queue, NULL);
+
+    while(!SDL_AtomicGet(&system->quit)) {
+        if(job_take(system, queue->index, &job)) {
+            job_execute(&job);
+            continue;
+        }
+
+        SDL_LockMutex(system->mutex);
+        SDL_AtomicAdd(&system->sleeping, 1);
+        while(SDL_AtomicGet(&system->queued) <= 0 && !SDL_AtomicGet(&system->quit))
+            SDL_CondWait(system->wake, system->mutex);
+        SDL_AtomicAdd(&system->sleeping, -1);
+        SDL_UnlockMutex(system->mutex);
+    }
+
+    return 0;
+}
+
+SDL_bool job_system_init(JobSystem* system, int worker_count) {
+    SDL_memset(system, 0, sizeof(*system));
+
+    if(worker_count < 0)
+        worker_count = SDL_GetCPUCount() - 1;
+
+    if(worker_count < 0)
+        worker_count = 0;
+    else if(worker_count > JOB_MAX_WORKERS)
+        worker_count = JOB_MAX_WORKERS;
+
+    system->main_thread = SDL_ThreadID();
+    system->queue_id = SDL_TLSCreate();
+    if(system->queue_id == 0)
+        return SDL_FALSE;
+
+    system->mutex = SDL_CreateMutex();
+    system->wake = SDL_CreateCond();
+    if(system->mutex == NULL || system->wake == NULL)
+        goto error;
+
+    for(int i = 0; i <= worker_count; i++) {
+        JobQueue* queue = system->queues + i;
+        queue->jobs = su_malloc(sizeof(Job) * JOB_QUEUE_CAPACITY);
+        if(queue->jobs == NULL) {
+            SDL_SetError("Could not create job system, not enough memory.");
+            goto error;
+        }
+
+        queue->system = system;
+        queue->index = i;
+    }
+
+    // Set before the workers start since they read it while stealing.
+    system->queue_count = worker_count + 1;
+
+    for(int i = 0; i < worker_count; i++) {
+        system->workers[i] = SDL_CreateThread(job_worker, "job_worker", system->queues + i + 1);
+        if(system->workers[i] == NULL)
+            goto error;
+
+        system->worker_count++;
+    }
+
+    return SDL_TRUE;
+
+    error:
+        job_system_free_resources(system);
+        return SDL_FALSE;
+}
+
+JobSystem* job_system_create(int worker_count) {
+    JobSystem* system = su_malloc(sizeof(*system));
+    if(system == NULL) {
+        SDL_SetError("Could not create job system, not enough memory.");
+        return NULL;
+    }
+
+    if(!job_system_init(system, worker_count)) {
+        su_free(system);
+        return NULL;
+    }
+
+    return system;
+}
+
+void job_system_free_resources(JobSystem* system) {
+    SDL_AtomicSet(&system->quit, 1);
+
+    if(system->mutex != NULL) {
+        SDL_LockMutex(system->mutex);
+        SDL_CondBroadcast(system->wake);
+        SDL_UnlockMutex(system->mutex);
+    }
+
+    for(int i = 0; i < system->worker_count; i++)
+        SDL_WaitThread(system->workers[i], NULL);
+
+    for(int i = 0; i <= JOB_MAX_WORKERS; i++) {
+        su_free(system->queues[i].jobs);
+        system->queues[i].jobs = NULL;
+    }
+
+    if(system->wake != NULL)
+        SDL_DestroyCond(system->wake);
+    if(system->mutex != NULL)
+        SDL_DestroyMutex(system->mutex);
+
+    su_free(system->main_jobs);
+    su_free(system->main_running);
+
+    system->worker_count = 0;
+    system->wake = NULL;
+    system->mutex = NULL;
+    system->main_jobs = NULL;
+    system->main_running = NULL;
+    system->main_count = 0;
+    system->main_capacity = 0;
+    system->main_running_capacity = 0;
+}
+
+void job_system_free(JobSystem* system) {
+    job_system_free_resources(system);
+    su_free(system);
+}
+
+void job_run(JobSystem* system, JobFn fn, void* data, JobCounter* counter) {
+    if(counter != NULL)
+        SDL_AtomicAdd(&counter->pending, 1);
+
+    Job job = { fn, NULL, data, 0, 0, counter };
+    job_push(system, &job);
+}
+
+SDL_bool job_run_main(JobSystem* system, JobFn fn, void* data, JobCounter* counter) {
+    SDL_LockMutex(system->mutex);
+
+    if(system->main_count == system->main_capacity) {
+        int capacity = system->main_capacity == 0 ? 16 : system->main_capacity * 2;
+        Job* jobs = su_realloc(system->main_jobs, sizeof(Job) * capacity);
+        if(jobs == NULL) {
+            SDL_UnlockMutex(system->mutex);
+            SDL_SetError("Could not queue main thread job, not enough memory.");
+            return SDL_FALSE;
+        }
+
+        system->main_jobs = jobs;
+        system->main_capacity = capacity;
+    }
+
+    if(counter != NULL)
+        SDL_AtomicAdd(&counter->pending, 1);
+
+    system->main_jobs[system->main_count++] = (Job){ fn, NULL, data, 0, 0, counter };
+    SDL_AtomicAdd(&system->main_queued, 1);
+
+    SDL_UnlockMutex(system->mutex);
+    return SDL_TRUE;
+}
+
+void job_system_run_main_jobs(JobSystem* system) {
+    // A main thread job that waits on a counter would otherwise
+    // start running the list it's part of again.
+    if(system->running_main || SDL_AtomicGet(&system->main_queued) == 0)
+        return;
+
+    SDL_LockMutex(system->mutex);
+
+    // Swap the lists so jobs can keep being queued while these run.
+    Job* jobs = system->main_jobs;
+    int count = system->main_count;
+    int capacity = system->main_capacity;
+
+    system->main_jobs = system->main_running;
+    system->main_capacity = system->main_running_capacity;
+    system->main_count = 0;
+    system->main_running = jobs;
+    system->main_running_capacity = capacity;
+    SDL_AtomicAdd(&system->main_queued, -count);
+
+    SDL_UnlockMutex(system->mutex);
+
+    system->running_main = SDL_TRUE;
+    for(int i = 0; i < count; i++)
+        job_execute(jobs + i);
+    system->running_main = SDL_FALSE;
+}
+
+void job_parallel_for_async(JobSystem* system, int count, int batch_size, JobRangeFn fn, void* data, JobCounter* counter) {
+    if(count <= 0)
+        return;
+
+    // Make a few batches per thread so threads that finish
+    // early can steal from the ones that got slower batches.
+    int size = count / (system->queue_count * 4);
+    if(size < batch_size)
+        size = batch_size;
+    if(size < 1)
+        size = 1;
+
+    for(int start = 0; start < count; start += size) {
+        int end = count - start > size ? start + size : count;
+        SDL_AtomicAdd(&counter->pending, 1);
+
+        Job job = { NULL, fn, data, start, end, counter };
+        job_push(system, &job);
+    }
+}
+
+void job_parallel_for(JobSystem* system, int count, int batch_size, JobRangeFn fn, void* data) {
+    JobCounter counter;
+    job_counter_init(&counter);
+    job_parallel_for_async(system, count, batch_size, fn, data, &counter);
+    job_wait(system, &counter);
+}
+
+void job_wait(JobSystem* system, JobCounter* counter) {
+    int index = job_current_queue(system)->index;
+    SDL_bool main_thread = SDL_ThreadID() == system->main_thread;
+    Job job;
+
+    while(SDL_AtomicGet(&counter->pending) > 0) {
+        if(job_take(system, index, &job)) {
+            job_execute(&job);
+        } else if(main_thread && SDL_AtomicGet(&system->main_queued) > 0 && !system->running_main) {
+            job_system_run_main_jobs(system);
+        } else {
+            // The remaining jobs are running on other threads.
+            SDL_Delay(0);
+        }
+    }
+}
@@ -0,0 +1,154 @@
+#include <su_latency.h>
+
+#include <su_metrics.h>
+
+/**
+    A group of inputs that reached the same stage of a frame. Only the oldest and
+    newest input are kept, since those bound the latency of the rest.
+*/
+typedef struct LatencyGroup {
+    int count;
+    Uint64 oldest;
+    Uint64 newest;
+    double sample_ms;
+    double update_ms;
+} LatencyGroup;
+
+static struct {
+    SDL_bool enabled;
+    Uint32 input_delay;
+    Uint64 last_present;
+    LatencyGroup pending;
+    LatencyGroup sampled;
+    LatencyGroup updated;
+    LatencyFrame frame;
+} latency = { SDL_FALSE, 0, 0, { 0 }, { 0 }, { 0 }, { 0 } };
+
+static inline double latency_ms(Uint64 start, Uint64 end) {
+    return end > start ? (double)(end - start) * 1000.0 / (double)SDL_GetPerformanceFrequency() : 0;
+}
+
+static void latency_merge(LatencyGroup* into, LatencyGroup* from) {
+    if(from->count == 0)
+        return;
+
+    // The older group reached every stage first, so its times are kept.
+    if(into->count == 0) {
+        *into = *from;
+    } else {
+        into->count += from->count;
+        into->newest = from->newest;
+    }
+
+    SDL_memset(from, 0, sizeof(*from));
+}
+
+void latency_set_enabled(SDL_bool enabled) {
+    latency.enabled = enabled;
+    SDL_memset(&latency.pending, 0, sizeof(latency.pending));
+    SDL_memset(&latency.sampled, 0, sizeof(latency.sampled));
+    SDL_memset(&latency.updated, 0, sizeof(latency.updated));
+}
+
+SDL_bool latency_enabled(void) {
+    return latency.enabled;
+}
+
+void latency_event(const SDL_Event* event) {
+    if(!latency.enabled)
+        return;
+
+    switch(event->type) {
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+        case SDL_TEXTINPUT:
+        case SDL_MOUSEMOTION:
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+        case SDL_MOUSEWHEEL:
+        case SDL_CONTROLLERAXISMOTION:
+        case SDL_CONTROLLERBUTTONDOWN:
+        case SDL_CONTROLLERBUTTONUP:
+        case SDL_FINGERDOWN:
+        case SDL_FINGERUP:
+        case SDL_FINGERMOTION:
+            break;
+        default:
+            return;
+    }
+
+    // The timestamp only has millisecond precision, so it's moved onto the
+    // performance counter once to measure the rest of the stages precisely.
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint32 age = SDL_GetTicks() - event->common.timestamp;
+    Uint64 offset = (Uint64)age * SDL_GetPerformanceFrequency() / 1000;
+    Uint64 origin = offset < now ? now - offset : 0;
+
+    LatencyGroup* pending = &latency.pending;
+    if(pending->count == 0 || origin < pending->oldest)
+        pending->oldest = origin;
+    if(pending->count == 0 || origin > pending->newest)
+        pending->newest = origin;
+
+    pending->count++;
+}
+
+void latency_sampled(void) {
+    if(!latency.enabled || latency.pending.count == 0)
+        return;
+
+    latency.pending.sample_ms = latency_ms(latency.pending.oldest, SDL_GetPerformanceCounter());
+    latency_merge(&latency.sampled, &latency.pending);
+}
+
+void latency_updated(void) {
+    if(!latency.enabled || latency.sampled.count == 0)
+        return;
+
+    latency.sampled.update_ms = latency_ms(latency.sampled.oldest, SDL_GetPerformanceCounter());
+    latency_merge(&latency.updated, &latency.sampled);
+}
+
+void latency_presented(void) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    latency.last_present = now;
+
+    if(!latency.enabled || latency.updated.count == 0)
+        return;
+
+    LatencyGroup* group = &latency.updated;
+    LatencyFrame* frame = &latency.frame;
+
+    frame->inputs = group->count;
+    frame->sample_ms = group->sample_ms;
+    frame->update_ms = group->update_ms;
+    frame->present_ms = latency_ms(group->oldest, now);
+    frame->present_newest_ms = latency_ms(group->newest, now);
+
+    metrics_record(METRIC_LATENCY_SAMPLE_MS, frame->sample_ms);
+    metrics_record(METRIC_LATENCY_UPDATE_MS, frame->update_ms);
+    metrics_record(METRIC_LATENCY_PRESENT_MS, frame->present_ms);
+
+    SDL_memset(group, 0, sizeof(*group));
+}
+
+LatencyFrame latency_get_frame(void) {
+    return latency.frame;
+}
+
+void latency_set_input_delay(Uint32 milliseconds) {
+    latency.input_delay = milliseconds;
+}
+
+Uint32 latency_get_input_delay(void) {
+    return latency.input_delay;
+}
+
+void latency_wait_input(void) {
+    if(latency.input_delay == 0 || latency.last_present == 0)
+        return;
+
+    double elapsed = latency_ms(latency.last_present, SDL_GetPerformanceCounter());
+    if(elapsed < latency.input_delay)
+        SDL_Delay((Uint32)(latency.input_delay - elapsed));
+}
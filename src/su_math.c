@@ -0,0 +1,425 @@
+#include <su_math.h>
+
+#include "su_simd.h"
+
+// Each kernel processes SU_SIMD_WIDTH elements at a time when a vector
+// instruction set is available, then finishes the remainder with the
+// scalar loop, which is also the whole kernel on other targets.
+
+void floor_to_int_batch(const float* values, int* result, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH)
+        simd_store_int(result + i, simd_convert_trunc(simd_floor(simd_load(values + i))));
+#endif
+    for(; i < count; i++)
+        result[i] = floor_to_int(values[i]);
+}
+
+void ceil_to_int_batch(const float* values, int* result, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH)
+        simd_store_int(result + i, simd_convert_trunc(simd_ceil(simd_load(values + i))));
+#endif
+    for(; i < count; i++)
+        result[i] = ceil_to_int(values[i]);
+}
+
+void round_to_int_batch(const float* values, int* result, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    simd_float4 half = simd_set1(0.5f);
+    simd_float4 negative_half = simd_set1(-0.5f);
+    simd_float4 one = simd_set1(1);
+    simd_float4 zero = simd_set1(0);
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_float4 v = simd_load(values + i);
+        simd_float4 t = simd_trunc(v);
+        simd_float4 fraction = simd_sub(v, t);
+        t = simd_add(t, simd_select(simd_cmpge(fraction, half), one, zero));
+        t = simd_sub(t, simd_select(simd_cmple(fraction, negative_half), one, zero));
+        simd_store_int(result + i, simd_convert_trunc(t));
+    }
+#endif
+    for(; i < count; i++)
+        result[i] = round_to_int(values[i]);
+}
+
+void trunc_to_int_batch(const float* values, int* result, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH)
+        simd_store_int(result + i, simd_convert_trunc(simd_load(values + i)));
+#endif
+    for(; i < count; i++)
+        result[i] = trunc_to_int(values[i]);
+}
+
+void vector2_batch_add(float* x, float* y, const float* dx, const float* dy, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_store(x + i, simd_add(simd_load(x + i), simd_load(dx + i)));
+        simd_store(y + i, simd_add(simd_load(y + i), simd_load(dy + i)));
+    }
+#endif
+    for(; i < count; i++) {
+        x[i] += dx[i];
+        y[i] += dy[i];
+    }
+}
+
+void vector2_batch_add_scaled(float* x, float* y, const float* vx, const float* vy, float scale, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    simd_float4 s = simd_set1(scale);
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_store(x + i, simd_add(simd_load(x + i), simd_mul(simd_load(vx + i), s)));
+        simd_store(y + i, simd_add(simd_load(y + i), simd_mul(simd_load(vy + i), s)));
+    }
+#endif
+    for(; i < count; i++) {
+        x[i] += vx[i] * scale;
+        y[i] += vy[i] * scale;
+    }
+}
+
+void vector2_batch_scale(float* x, float* y, float scale, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    simd_float4 s = simd_set1(scale);
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_store(x + i, simd_mul(simd_load(x + i), s));
+        simd_store(y + i, simd_mul(simd_load(y + i), s));
+    }
+#endif
+    for(; i < count; i++) {
+        x[i] *= scale;
+        y[i] *= scale;
+    }
+}
+
+void vector2_batch_dot(const float* ax, const float* ay, const float* bx, const float* by, float* result, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_float4 dot = simd_add(simd_mul(simd_load(ax + i), simd_load(bx + i)),
+                                   simd_mul(simd_load(ay + i), simd_load(by + i)));
+        simd_store(result + i, dot);
+    }
+#endif
+    for(; i < count; i++)
+        result[i] = ax[i] * bx[i] + ay[i] * by[i];
+}
+
+void vector2_batch_length(const float* x, const float* y, float* result, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_float4 vx = simd_load(x + i);
+        simd_float4 vy = simd_load(y + i);
+        simd_store(result + i, simd_sqrt(simd_add(simd_mul(vx, vx), simd_mul(vy, vy))));
+    }
+#endif
+    for(; i < count; i++)
+        result[i] = sqrtf(x[i] * x[i] + y[i] * y[i]);
+}
+
+void vector2_batch_normalize(float* x, float* y, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    simd_float4 zero = simd_set1(0);
+    simd_float4 one = simd_set1(1);
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_float4 vx = simd_load(x + i);
+        simd_float4 vy = simd_load(y + i);
+        simd_float4 length = simd_sqrt(simd_add(simd_mul(vx, vx), simd_mul(vy, vy)));
+        simd_mask4 nonzero = simd_cmpgt(length, zero);
+        // Divide by 1 in the zero lanes so they stay zero instead of becoming NaN.
+        simd_float4 inverse = simd_div(one, simd_select(nonzero, length, one));
+        simd_store(x + i, simd_mul(vx, inverse));
+        simd_store(y + i, simd_mul(vy, inverse));
+    }
+#endif
+    for(; i < count; i++) {
+        float length = sqrtf(x[i] * x[i] + y[i] * y[i]);
+        if(length > 0) {
+            x[i] /= length;
+            y[i] /= length;
+        }
+    }
+}
+
+void vector2_batch_clamp_length(float* x, float* y, float max_length, int count) {
+    int i = 0;
+    float max_squared = max_length * max_length;
+#ifdef SU_SIMD
+    simd_float4 max = simd_set1(max_length);
+    simd_float4 max2 = simd_set1(max_squared);
+    simd_float4 one = simd_set1(1);
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_float4 vx = simd_load(x + i);
+        simd_float4 vy = simd_load(y + i);
+        simd_float4 length2 = simd_add(simd_mul(vx, vx), simd_mul(vy, vy));
+        simd_mask4 too_long = simd_cmpgt(length2, max2);
+        if(!simd_any(too_long))
+            continue;
+        simd_float4 scale = simd_select(too_long, simd_div(max, simd_sqrt(length2)), one);
+        simd_store(x + i, simd_mul(vx, scale));
+        simd_store(y + i, simd_mul(vy, scale));
+    }
+#endif
+    for(; i < count; i++) {
+        float length2 = x[i] * x[i] + y[i] * y[i];
+        if(length2 > max_squared) {
+            float scale = max_length / sqrtf(length2);
+            x[i] *= scale;
+            y[i] *= scale;
+        }
+    }
+}
+
+void vector2_batch_lerp(float* x, float* y, const float* to_x, const float* to_y, float amount, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    simd_float4 t = simd_set1(amount);
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_float4 vx = simd_load(x + i);
+        simd_float4 vy = simd_load(y + i);
+        simd_store(x + i, simd_add(vx, simd_mul(simd_sub(simd_load(to_x + i), vx), t)));
+        simd_store(y + i, simd_add(vy, simd_mul(simd_sub(simd_load(to_y + i), vy), t)));
+    }
+#endif
+    for(; i < count; i++) {
+        x[i] += (to_x[i] - x[i]) * amount;
+        y[i] += (to_y[i] - y[i]) * amount;
+    }
+}
+
+void vector2_batch_rotate(float* x, float* y, float radians, int count) {
+    float c = cosf(radians);
+    float s = sinf(radians);
+    int i = 0;
+#ifdef SU_SIMD
+    simd_float4 vc = simd_set1(c);
+    simd_float4 vs = simd_set1(s);
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_float4 vx = simd_load(x + i);
+        simd_float4 vy = simd_load(y + i);
+        simd_store(x + i, simd_sub(simd_mul(vx, vc), simd_mul(vy, vs)));
+        simd_store(y + i, simd_add(simd_mul(vx, vs), simd_mul(vy, vc)));
+    }
+#endif
+    for(; i < count; i++) {
+        float rx = x[i] * c - y[i] * s;
+        float ry = x[i] * s + y[i] * c;
+        x[i] = rx;
+        y[i] = ry;
+    }
+}
+
+// Lookup tables for the fixed-point trig functions. They are written out as
+// constants rather than computed with sinf/atanf at startup so every platform
+// gets the exact same values.
+
+// sin(i * pi / 512) in Q16.16 for a quarter wave, plus the end point.
+static const Fixed fixed_sin_table[257] = {
+    0, 402, 804, 1206, 1608, 2010, 2412, 2814,
+    3216, 3617, 4019, 4420, 4821, 5222, 5623, 6023,
+    6424, 6824, 7224, 7623, 8022, 8421, 8820, 9218,
+    9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391,
+    12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+    15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+    19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699,
+    22078, 22457, 22834, 23210, 23586, 23961, 24335, 24708,
+    25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+    28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+    30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347,
+    33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+    36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716,
+    39040, 39362, 39683, 40002, 40320, 40636, 40951, 41264,
+    41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+    44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056,
+    46341, 46624, 46906, 47186, 47464, 47741, 48015, 48288,
+    48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+    50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398,
+    52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+    54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+    56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607,
+    57798, 57986, 58172, 58356, 58538, 58718, 58896, 59071,
+    59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+    60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+    61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596,
+    62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+    63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197,
+    64277, 64354, 64429, 64501, 64571, 64639, 64704, 64766,
+    64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+    65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436,
+    65457, 65476, 65492, 65505, 65516, 65525, 65531, 65535,
+    65536
+};
+
+// atan(i / 256) in Q16.16, plus the end point.
+static const Fixed fixed_atan_table[257] = {
+    0, 256, 512, 768, 1024, 1280, 1536, 1792,
+    2047, 2303, 2559, 2814, 3070, 3325, 3580, 3836,
+    4091, 4346, 4600, 4855, 5110, 5364, 5618, 5872,
+    6126, 6380, 6633, 6887, 7140, 7392, 7645, 7898,
+    8150, 8402, 8653, 8905, 9156, 9407, 9657, 9908,
+    10158, 10408, 10657, 10906, 11155, 11403, 11652, 11899,
+    12147, 12394, 12641, 12887, 13133, 13379, 13624, 13869,
+    14114, 14358, 14601, 14845, 15088, 15330, 15572, 15814,
+    16055, 16296, 16536, 16776, 17015, 17254, 17492, 17730,
+    17968, 18205, 18441, 18677, 18913, 19148, 19382, 19616,
+    19850, 20083, 20315, 20547, 20779, 21009, 21240, 21469,
+    21699, 21927, 22156, 22383, 22610, 22836, 23062, 23288,
+    23512, 23737, 23960, 24183, 24406, 24627, 24849, 25069,
+    25289, 25509, 25727, 25946, 26163, 26380, 26597, 26813,
+    27028, 27242, 27456, 27670, 27882, 28094, 28306, 28517,
+    28727, 28936, 29145, 29354, 29561, 29768, 29975, 30180,
+    30386, 30590, 30794, 30997, 31200, 31402, 31603, 31803,
+    32003, 32203, 32401, 32600, 32797, 32994, 33190, 33385,
+    33580, 33774, 33968, 34160, 34353, 34544, 34735, 34925,
+    35115, 35304, 35492, 35680, 35867, 36053, 36239, 36424,
+    36608, 36792, 36975, 37158, 37340, 37521, 37701, 37881,
+    38060, 38239, 38417, 38594, 38771, 38947, 39123, 39297,
+    39472, 39645, 39818, 39990, 40162, 40333, 40503, 40673,
+    40842, 41010, 41178, 41346, 41512, 41678, 41844, 42008,
+    42172, 42336, 42499, 42661, 42823, 42984, 43145, 43304,
+    43464, 43622, 43780, 43938, 44095, 44251, 44407, 44562,
+    44716, 44870, 45024, 45176, 45328, 45480, 45631, 45781,
+    45931, 46080, 46229, 46377, 46525, 46672, 46818, 46964,
+    47109, 47254, 47398, 47542, 47685, 47827, 47969, 48111,
+    48251, 48392, 48531, 48671, 48809, 48947, 49085, 49222,
+    49359, 49495, 49630, 49765, 49899, 50033, 50167, 50299,
+    50432, 50563, 50695, 50826, 50956, 51086, 51215, 51344,
+    51472
+};
+
+// The number of sine table steps in a full circle, and the scale that converts
+// radians into steps in Q16.16: round(1024 / (2 * pi) * 65536).
+#define FIXED_SIN_STEPS 1024
+#define FIXED_SIN_SCALE 10680707
+
+static Uint32 isqrt64(Uint64 value) {
+    Uint64 result = 0;
+    Uint64 bit = (Uint64)1 << 62;
+
+    while(bit > value)
+        bit >>= 2;
+
+    while(bit != 0) {
+        if(value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (Uint32)result;
+}
+
+Fixed fixed_sqrt(Fixed value) {
+    if(value <= 0)
+        return 0;
+
+    // The square root of a Q32 number is a Q16 number.
+    return (Fixed)isqrt64((Uint64)value << FIXED_SHIFT);
+}
+
+// Gets the sine at a position on the circle measured in table steps, in Q16.16.
+static Fixed fixed_sin_position(Uint32 position) {
+    position &= ((Uint32)FIXED_SIN_STEPS << FIXED_SHIFT) - 1;
+
+    Uint32 index = position >> FIXED_SHIFT;
+    Sint64 fraction = position & (FIXED_ONE - 1);
+    Uint32 quadrant = index >> 8;
+    Uint32 step = index & 255;
+
+    Sint64 value;
+    if(quadrant & 1) {
+        Sint64 a = fixed_sin_table[256 - step];
+        Sint64 b = fixed_sin_table[255 - step];
+        value = a - ((a - b) * fraction) / FIXED_ONE;
+    } else {
+        Sint64 a = fixed_sin_table[step];
+        Sint64 b = fixed_sin_table[step + 1];
+        value = a + ((b - a) * fraction) / FIXED_ONE;
+    }
+
+    return (Fixed)(quadrant & 2 ? -value : value);
+}
+
+static Uint32 fixed_radians_to_position(Fixed radians) {
+    Sint64 position = ((Sint64)radians * FIXED_SIN_SCALE) / FIXED_ONE;
+    // Converting to unsigned wraps negative angles around the circle.
+    return (Uint32)((Uint64)position & 0xFFFFFFFF);
+}
+
+Fixed fixed_sin(Fixed radians) {
+    return fixed_sin_position(fixed_radians_to_position(radians));
+}
+
+Fixed fixed_cos(Fixed radians) {
+    return fixed_sin_position(fixed_radians_to_position(radians) + ((Uint32)(FIXED_SIN_STEPS / 4) << FIXED_SHIFT));
+}
+
+// Gets atan(ratio) where ratio is in [0, 1] measured in table steps in Q16.16.
+static Sint64 fixed_atan_ratio(Sint64 ratio) {
+    Sint64 index = ratio >> FIXED_SHIFT;
+    if(index >= 256)
+        return fixed_atan_table[256];
+
+    Sint64 fraction = ratio & (FIXED_ONE - 1);
+    Sint64 a = fixed_atan_table[index];
+    Sint64 b = fixed_atan_table[index + 1];
+    return a + ((b - a) * fraction) / FIXED_ONE;
+}
+
+Fixed fixed_atan2(Fixed y, Fixed x) {
+    if(x == 0 && y == 0)
+        return 0;
+
+    Sint64 ax = x < 0 ? -(Sint64)x : x;
+    Sint64 ay = y < 0 ? -(Sint64)y : y;
+
+    Sint64 angle;
+    if(ax >= ay)
+        angle = fixed_atan_ratio((ay << (FIXED_SHIFT + 8)) / ax);
+    else
+        angle = FIXED_HALF_PI - fixed_atan_ratio((ax << (FIXED_SHIFT + 8)) / ay);
+
+    if(x < 0)
+        angle = FIXED_PI - angle;
+    if(y < 0)
+        angle = -angle;
+
+    return (Fixed)angle;
+}
+
+Fixed fixed_vector2_length(FixedVector2 vector) {
+    // Both squares are Q32 and fit in 63 bits, so their sum fits in 64.
+    Uint64 squared = (Uint64)((Sint64)vector.x * vector.x) + (Uint64)((Sint64)vector.y * vector.y);
+    Uint32 length = isqrt64(squared);
+    return length > (Uint32)FIXED_MAX ? FIXED_MAX : (Fixed)length;
+}
+
+FixedVector2 fixed_vector2_normalize(FixedVector2 vector) {
+    Fixed length = fixed_vector2_length(vector);
+    if(length == 0)
+        return vector;
+
+    return (FixedVector2){ fixed_divide(vector.x, length), fixed_divide(vector.y, length) };
+}
+
+FixedVector2 fixed_vector2_rotate(FixedVector2 vector, Fixed radians) {
+    Fixed c = fixed_cos(radians);
+    Fixed s = fixed_sin(radians);
+    return (FixedVector2){
+        fixed_subtract(fixed_multiply(vector.x, c), fixed_multiply(vector.y, s)),
+        fixed_add(fixed_multiply(vector.x, s), fixed_multiply(vector.y, c))
+    };
+}
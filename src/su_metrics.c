@@ -0,0 +1,371 @@
+#include <su_metrics.h>
+
+#define METRIC_DEFAULT_FIRST_BOUND 0.01
+
+static Metric metrics_builtin[METRIC_BUILTIN_COUNT] = {
+    [METRIC_CAMERA_RENDER_TARGETS] = { "camera.render_targets", METRIC_COUNTER },
+    [METRIC_CAMERA_RENDER_SCALE] = { "camera.render_scale", METRIC_GAUGE },
+    [METRIC_SCENE_RENDER_CLEARS] = { "scene.render_clears", METRIC_COUNTER },
+    [METRIC_SCENE_RENDER_COPIES] = { "scene.render_copies", METRIC_COUNTER },
+    [METRIC_SCENE_DRAW_MS] = { "scene.draw_ms", METRIC_HISTOGRAM, .first_bound = METRIC_DEFAULT_FIRST_BOUND },
+    [METRIC_SCENE_UPDATE_MS] = { "scene.update_ms", METRIC_HISTOGRAM, .first_bound = METRIC_DEFAULT_FIRST_BOUND },
+    [METRIC_SCENE_PUSHES] = { "scene.pushes", METRIC_COUNTER },
+    [METRIC_SCENE_POPS] = { "scene.pops", METRIC_COUNTER },
+    [METRIC_SCENE_DEPTH] = { "scene.depth", METRIC_GAUGE },
+    [METRIC_INPUT_UPDATE_MS] = { "input.update_ms", METRIC_HISTOGRAM, .first_bound = METRIC_DEFAULT_FIRST_BOUND },
+    [METRIC_LATENCY_SAMPLE_MS] = { "latency.sample_ms", METRIC_HISTOGRAM, .first_bound = METRIC_DEFAULT_FIRST_BOUND },
+    [METRIC_LATENCY_UPDATE_MS] = { "latency.update_ms", METRIC_HISTOGRAM, .first_bound = METRIC_DEFAULT_FIRST_BOUND },
+    [METRIC_LATENCY_PRESENT_MS] = { "latency.present_ms", METRIC_HISTOGRAM, .first_bound = METRIC_DEFAULT_FIRST_BOUND }
+};
+
+static const char* metric_type_names[] = {
+    "counter",
+    "gauge",
+    "histogram"
+};
+
+static struct {
+    /**
+        Points at metrics_builtin until the first metric is registered by the user.
+    */
+    Metric* metrics;
+    int count;
+    int capacity;
+    SDL_bool enabled;
+
+    /**
+        Guards the values of the metrics, which can be updated from worker threads.
+    */
+    SDL_SpinLock lock;
+
+    SDL_RWops* dump;
+    MetricsFormat dump_format;
+    Uint32 dump_interval;
+    Uint32 dump_last;
+    SDL_bool dump_reset;
+} metrics_registry = { metrics_builtin, METRIC_BUILTIN_COUNT, 0, SDL_TRUE, 0, NULL, METRICS_FORMAT_CSV, 0, 0, SDL_FALSE };
+
+static SDL_bool metrics_valid_name(const char* name) {
+    if(*name == '\0')
+        return SDL_FALSE;
+
+    // The names are written to CSV and JSON without escaping.
+    for(const char* c = name; *c != '\0'; c++) {
+        if(*c == '"' || *c == '\\' || *c == ',' || (Uint8)*c < 0x20)
+            return SDL_FALSE;
+    }
+
+    return SDL_TRUE;
+}
+
+static MetricId metrics_add_metric(const char* name, MetricType type, double first_bound) {
+    MetricId existing = metrics_find(name);
+    if(existing != METRIC_INVALID) {
+        if(metrics_registry.metrics[existing].type != type) {
+            SDL_SetError("Could not register metric %s, it's already registered with a different type.", name);
+            return METRIC_INVALID;
+        }
+        return existing;
+    }
+
+    if(!metrics_valid_name(name)) {
+        SDL_SetError("Could not register metric, invalid name.");
+        return METRIC_INVALID;
+    }
+
+    if(metrics_registry.count == metrics_registry.capacity || metrics_registry.metrics == metrics_builtin) {
+        int capacity = metrics_registry.capacity == 0 ? 32 : metrics_registry.capacity * 2;
+        Metric* metrics;
+
+        if(metrics_registry.metrics == metrics_builtin) {
+            metrics = su_malloc(sizeof(Metric) * capacity);
+            if(metrics != NULL)
+                SDL_memcpy(metrics, metrics_builtin, sizeof(metrics_builtin));
+        } else {
+            metrics = su_realloc(metrics_registry.metrics, sizeof(Metric) * capacity);
+        }
+
+        if(metrics == NULL)
+            goto error;
+
+        metrics_registry.metrics = metrics;
+        metrics_registry.capacity = capacity;
+    }
+
+    size_t length = SDL_strlen(name) + 1;
+    char* copy = su_malloc(length);
+    if(copy == NULL)
+        goto error;
+
+    SDL_memcpy(copy, name, length);
+
+    Metric* metric = metrics_registry.metrics + metrics_registry.count;
+    SDL_memset(metric, 0, sizeof(*metric));
+    metric->name = copy;
+    metric->type = type;
+    metric->first_bound = first_bound;
+
+    return metrics_registry.count++;
+
+    error:
+        SDL_SetError("Could not register metric %s, not enough memory.", name);
+        return METRIC_INVALID;
+}
+
+MetricId metrics_register(const char* name, MetricType type) {
+    return metrics_add_metric(name, type, METRIC_DEFAULT_FIRST_BOUND);
+}
+
+MetricId metrics_register_histogram(const char* name, double first_bound) {
+    if(first_bound <= 0) {
+        SDL_SetError("Could not register metric %s, the first bound must be positive.", name);
+        return METRIC_INVALID;
+    }
+
+    return metrics_add_metric(name, METRIC_HISTOGRAM, first_bound);
+}
+
+MetricId metrics_find(const char* name) {
+    for(int i = 0; i < metrics_registry.count; i++) {
+        if(SDL_strcmp(metrics_registry.metrics[i].name, name) == 0)
+            return i;
+    }
+
+    return METRIC_INVALID;
+}
+
+const Metric* metrics_get(MetricId id) {
+    return metrics_registry.metrics + id;
+}
+
+int metrics_get_count(void) {
+    return metrics_registry.count;
+}
+
+void metrics_add(MetricId id, Uint64 amount) {
+    if(!metrics_registry.enabled)
+        return;
+
+    SDL_AtomicLock(&metrics_registry.lock);
+    metrics_registry.metrics[id].count += amount;
+    SDL_AtomicUnlock(&metrics_registry.lock);
+}
+
+void metrics_set(MetricId id, double value) {
+    if(!metrics_registry.enabled)
+        return;
+
+    SDL_AtomicLock(&metrics_registry.lock);
+
+    Metric* metric = metrics_registry.metrics + id;
+    if(metric->count == 0 || value < metric->min)
+        metric->min = value;
+    if(metric->count == 0 || value > metric->max)
+        metric->max = value;
+
+    metric->value = value;
+    metric->count++;
+
+    SDL_AtomicUnlock(&metrics_registry.lock);
+}
+
+void metrics_record(MetricId id, double value) {
+    if(!metrics_registry.enabled)
+        return;
+
+    int bucket = 0;
+    double bound = metrics_registry.metrics[id].first_bound;
+    while(bucket < METRIC_HISTOGRAM_BUCKETS - 1 && value >= bound) {
+        bound *= 2;
+        bucket++;
+    }
+
+    SDL_AtomicLock(&metrics_registry.lock);
+
+    Metric* metric = metrics_registry.metrics + id;
+    if(metric->count == 0 || value < metric->min)
+        metric->min = value;
+    if(metric->count == 0 || value > metric->max)
+        metric->max = value;
+
+    metric->count++;
+    metric->value += value;
+    metric->buckets[bucket]++;
+
+    SDL_AtomicUnlock(&metrics_registry.lock);
+}
+
+void metrics_time_end(MetricId id, Uint64 start) {
+    Uint64 end = SDL_GetPerformanceCounter();
+    metrics_record(id, (double)(end - start) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+
+double metrics_percentile(MetricId id, double percentile) {
+    Metric* metric = metrics_registry.metrics + id;
+    if(metric->count == 0)
+        return 0;
+
+    double target = percentile * (double)metric->count;
+    Uint64 seen = 0;
+    double bound = metric->first_bound;
+
+    for(int i = 0; i < METRIC_HISTOGRAM_BUCKETS - 1; i++) {
+        seen += metric->buckets[i];
+        if((double)seen >= target)
+            return SDL_min(bound, metric->max);
+        bound *= 2;
+    }
+
+    return metric->max;
+}
+
+void metrics_set_enabled(SDL_bool enabled) {
+    metrics_registry.enabled = enabled;
+}
+
+SDL_bool metrics_enabled(void) {
+    return metrics_registry.enabled;
+}
+
+void metrics_reset(void) {
+    SDL_AtomicLock(&metrics_registry.lock);
+
+    for(int i = 0; i < metrics_registry.count; i++) {
+        Metric* metric = metrics_registry.metrics + i;
+        metric->count = 0;
+        metric->value = 0;
+        metric->min = 0;
+        metric->max = 0;
+        SDL_memset(metric->buckets, 0, sizeof(metric->buckets));
+    }
+
+    SDL_AtomicUnlock(&metrics_registry.lock);
+}
+
+void metrics_quit(void) {
+    if(metrics_registry.metrics != metrics_builtin) {
+        for(int i = METRIC_BUILTIN_COUNT; i < metrics_registry.count; i++)
+            su_free((char*)metrics_registry.metrics[i].name);
+
+        SDL_memcpy(metrics_builtin, metrics_registry.metrics, sizeof(metrics_builtin));
+        su_free(metrics_registry.metrics);
+    }
+
+    metrics_registry.metrics = metrics_builtin;
+    metrics_registry.count = METRIC_BUILTIN_COUNT;
+    metrics_registry.capacity = 0;
+    metrics_registry.dump = NULL;
+}
+
+static SDL_bool metrics_write(SDL_RWops* output, const char* buffer, int length) {
+    if(length < 0 || length >= 512) {
+        SDL_SetError("Could not write metrics, buffer too small.");
+        return SDL_FALSE;
+    }
+
+    return SDL_RWwrite(output, buffer, length, 1) == 1;
+}
+
+SDL_bool metrics_write_csv(SDL_RWops* output) {
+    char buffer[512];
+    int length = SDL_snprintf(buffer, sizeof(buffer), "name,type,count,value,min,max,mean,p50,p90,p99\n");
+    if(!metrics_write(output, buffer, length))
+        return SDL_FALSE;
+
+    for(int i = 0; i < metrics_registry.count; i++) {
+        Metric* metric = metrics_registry.metrics + i;
+        double value = metric->type == METRIC_COUNTER ? (double)metric->count : metric->value;
+        double mean = metric->type == METRIC_HISTOGRAM && metric->count > 0 ? metric->value / (double)metric->count : 0;
+
+        length = SDL_snprintf(buffer, sizeof(buffer), "%s,%s,%llu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+                              metric->name,
+                              metric_type_names[metric->type],
+                              (unsigned long long)metric->count,
+                              value,
+                              metric->min,
+                              metric->max,
+                              mean,
+                              metric->type == METRIC_HISTOGRAM ? metrics_percentile(i, 0.5) : 0,
+                              metric->type == METRIC_HISTOGRAM ? metrics_percentile(i, 0.9) : 0,
+                              metric->type == METRIC_HISTOGRAM ? metrics_percentile(i, 0.99) : 0);
+
+        if(!metrics_write(output, buffer, length))
+            return SDL_FALSE;
+    }
+
+    return SDL_TRUE;
+}
+
+SDL_bool metrics_write_json(SDL_RWops* output) {
+    char buffer[512];
+    int length = SDL_snprintf(buffer, sizeof(buffer), "{\"ticks\":%u,\"metrics\":{", SDL_GetTicks());
+    if(!metrics_write(output, buffer, length))
+        return SDL_FALSE;
+
+    for(int i = 0; i < metrics_registry.count; i++) {
+        Metric* metric = metrics_registry.metrics + i;
+        const char* separator = i == 0 ? "" : ",";
+
+        switch(metric->type) {
+            case METRIC_COUNTER:
+                length = SDL_snprintf(buffer, sizeof(buffer), "%s\"%s\":{\"type\":\"counter\",\"count\":%llu}",
+                                      separator,
+                                      metric->name,
+                                      (unsigned long long)metric->count);
+                break;
+            case METRIC_GAUGE:
+                length = SDL_snprintf(buffer, sizeof(buffer), "%s\"%s\":{\"type\":\"gauge\",\"value\":%.6f,\"min\":%.6f,\"max\":%.6f}",
+                                      separator,
+                                      metric->name,
+                                      metric->value,
+                                      metric->min,
+                                      metric->max);
+                break;
+            case METRIC_HISTOGRAM:
+                length = SDL_snprintf(buffer, sizeof(buffer),
+                                      "%s\"%s\":{\"type\":\"histogram\",\"count\":%llu,\"sum\":%.6f,\"min\":%.6f,\"max\":%.6f,\"p50\":%.6f,\"p90\":%.6f,\"p99\":%.6f}",
+                                      separator,
+                                      metric->name,
+                                      (unsigned long long)metric->count,
+                                      metric->value,
+                                      metric->min,
+                                      metric->max,
+                                      metrics_percentile(i, 0.5),
+                                      metrics_percentile(i, 0.9),
+                                      metrics_percentile(i, 0.99));
+                break;
+        }
+
+        if(!metrics_write(output, buffer, length))
+            return SDL_FALSE;
+    }
+
+    return metrics_write(output, "}}\n", 3);
+}
+
+void metrics_set_dump(SDL_RWops* output, MetricsFormat format, Uint32 interval, SDL_bool reset) {
+    metrics_registry.dump = output;
+    metrics_registry.dump_format = format;
+    metrics_registry.dump_interval = interval;
+    metrics_registry.dump_last = SDL_GetTicks();
+    metrics_registry.dump_reset = reset;
+}
+
+void metrics_update(void) {
+    if(metrics_registry.dump == NULL)
+        return;
+
+    Uint32 now = SDL_GetTicks();
+    if(now - metrics_registry.dump_last < metrics_registry.dump_interval)
+        return;
+
+    metrics_registry.dump_last = now;
+
+    if(metrics_registry.dump_format == METRICS_FORMAT_CSV)
+        metrics_write_csv(metrics_registry.dump);
+    else
+        metrics_write_json(metrics_registry.dump);
+
+    if(metrics_registry.dump_reset)
+        metrics_reset();
+}
@@ -0,0 +1,793 @@
+#include <su_pack.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define PACK_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define PACK_MIN_MATCH 4
+#define PACK_LAST_LITERALS 5
+#define PACK_MATCH_LIMIT 12
+#define PACK_MAX_OFFSET 65535
+#define PACK_HASH_BITS 12
+
+/**
+    A decompressed file, read through an SDL_RWops.
+    The data is allocated right after the stream.
+*/
+typedef struct PackStream {
+    Uint8* data;
+    size_t size;
+    size_t position;
+} PackStream;
+
+Uint64 pack_hash(const char* name, size_t length) {
+    Uint64 hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < length; i++) {
+        hash ^= (Uint8)name[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static SDL_bool pack_map(Pack* pack, const char* file) {
+#if defined(_WIN32)
+    int length = MultiByteToWideChar(CP_UTF8, 0, file, -1, NULL, 0);
+    if(length == 0) {
+        SDL_SetError("Could not open pack %s, invalid path.", file);
+        return SDL_FALSE;
+    }
+
+    WCHAR* wide = su_malloc(sizeof(WCHAR) * length);
+    if(wide == NULL) {
+        SDL_SetError("Could not open pack %s, not enough memory.", file);
+        return SDL_FALSE;
+    }
+    MultiByteToWideChar(CP_UTF8, 0, file, -1, wide, length);
+
+    HANDLE handle = CreateFileW(wide, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    su_free(wide);
+    if(handle == INVALID_HANDLE_VALUE) {
+        SDL_SetError("Could not open pack %s.", file);
+        return SDL_FALSE;
+    }
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(handle, &size) || (Uint64)size.QuadPart < sizeof(PackHeader)) {
+        SDL_SetError("%s is not a pack file.", file);
+        CloseHandle(handle);
+        return SDL_FALSE;
+    }
+
+    HANDLE mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(mapping == NULL) {
+        SDL_SetError("Could not map pack %s.", file);
+        CloseHandle(handle);
+        return SDL_FALSE;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(data == NULL) {
+        SDL_SetError("Could not map pack %s.", file);
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return SDL_FALSE;
+    }
+
+    pack->data = data;
+    pack->size = (size_t)size.QuadPart;
+    pack->file = handle;
+    pack->mapping = mapping;
+    pack->mapped = SDL_TRUE;
+    return SDL_TRUE;
+#elif defined(PACK_MMAP)
+    int fd = open(file, O_RDONLY);
+    if(fd == -1) {
+        SDL_SetError("Could not open pack %s.", file);
+        return SDL_FALSE;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || (Uint64)info.st_size < sizeof(PackHeader)) {
+        SDL_SetError("%s is not a pack file.", file);
+        close(fd);
+        return SDL_FALSE;
+    }
+
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file.
+    close(fd);
+
+    if(data == MAP_FAILED) {
+        SDL_SetError("Could not map pack %s.", file);
+        return SDL_FALSE;
+    }
+
+    pack->data = data;
+    pack->size = (size_t)info.st_size;
+    pack->mapped = SDL_TRUE;
+    return SDL_TRUE;
+#else
+    SDL_RWops* rw = SDL_RWFromFile(file, "rb");
+    if(rw == NULL)
+        return SDL_FALSE;
+
+    Sint64 size = SDL_RWsize(rw);
+    if(size < (Sint64)sizeof(PackHeader)) {
+        SDL_SetError("%s is not a pack file.", file);
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+
+    Uint8* data = su_malloc((size_t)size);
+    if(data == NULL) {
+        SDL_SetError("Could not open pack %s, not enough memory.", file);
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+
+    if(SDL_RWread(rw, data, (size_t)size, 1) != 1) {
+        su_free(data);
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+
+    SDL_RWclose(rw);
+
+    pack->data = data;
+    pack->size = (size_t)size;
+    pack->mapped = SDL_FALSE;
+    return SDL_TRUE;
+#endif
+}
+
+static SDL_bool pack_validate(Pack* pack) {
+    const PackHeader* header = pack->header;
+    if(SDL_SwapLE32(header->magic) != PACK_FILE_MAGIC || SDL_SwapLE32(header->version) != PACK_FILE_VERSION)
+        return SDL_FALSE;
+
+    Uint64 count = SDL_SwapLE32(header->entry_count);
+    Uint64 index_offset = SDL_SwapLE64(header->index_offset);
+    Uint64 names_offset = SDL_SwapLE64(header->names_offset);
+    Uint64 names_size = SDL_SwapLE64(header->names_size);
+
+    // The index is read in place, so it has to be aligned for its largest field.
+    if(index_offset % sizeof(Uint64) != 0
+        || index_offset > pack->size
+        || count > (pack->size - index_offset) / sizeof(PackEntry)
+        || names_offset > pack->size
+        || names_size > pack->size - names_offset)
+    {
+        return SDL_FALSE;
+    }
+
+    pack->entries = (const PackEntry*)(pack->data + index_offset);
+    pack->names = (const char*)(pack->data + names_offset);
+    pack->entry_count = (Uint32)count;
+
+    // Checking every entry up front means none of the accessors have to.
+    for(Uint32 i = 0; i < pack->entry_count; i++) {
+        const PackEntry* entry = pack->entries + i;
+        Uint64 offset = SDL_SwapLE64(entry->offset);
+        Uint64 size = SDL_SwapLE64(entry->size);
+        Uint64 name_offset = SDL_SwapLE32(entry->name_offset);
+        Uint64 name_length = SDL_SwapLE32(entry->name_length);
+        Uint32 compression = SDL_SwapLE32(entry->compression);
+
+        if(offset > pack->size || size > pack->size - offset)
+            return SDL_FALSE;
+
+        if(name_offset > names_size || name_length > names_size - name_offset)
+            return SDL_FALSE;
+
+        if(compression == PACK_COMPRESSION_NONE) {
+            if(SDL_SwapLE64(entry->original_size) != size)
+                return SDL_FALSE;
+        } else if(compression != PACK_COMPRESSION_LZ4) {
+            return SDL_FALSE;
+        }
+
+        if(i > 0 && SDL_SwapLE64(entry[-1].hash) > SDL_SwapLE64(entry->hash))
+            return SDL_FALSE;
+    }
+
+    return SDL_TRUE;
+}
+
+SDL_bool pack_open(Pack* pack, const char* file) {
+    SDL_zero(*pack);
+
+    if(!pack_map(pack, file))
+        return SDL_FALSE;
+
+    pack->header = (const PackHeader*)pack->data;
+    if(!pack_validate(pack)) {
+        SDL_SetError("%s is not a pack file.", file);
+        pack_close(pack);
+        return SDL_FALSE;
+    }
+
+    return SDL_TRUE;
+}
+
+void pack_close(Pack* pack) {
+    if(pack->data == NULL)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(pack->data);
+    CloseHandle(pack->mapping);
+    CloseHandle(pack->file);
+#elif defined(PACK_MMAP)
+    munmap((void*)pack->data, pack->size);
+#else
+    su_free((void*)pack->data);
+#endif
+
+    SDL_zero(*pack);
+}
+
+int pack_find(Pack* pack, const char* name) {
+    size_t length = SDL_strlen(name);
+    Uint64 hash = pack_hash(name, length);
+
+    // Find the first entry with the hash, then compare the names of every entry that shares it.
+    Uint32 low = 0;
+    Uint32 high = pack->entry_count;
+    while(low < high) {
+        Uint32 mid = low + (high - low) / 2;
+        if(SDL_SwapLE64(pack->entries[mid].hash) < hash)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    for(Uint32 i = low; i < pack->entry_count && SDL_SwapLE64(pack->entries[i].hash) == hash; i++) {
+        const PackEntry* entry = pack->entries + i;
+        if(SDL_SwapLE32(entry->name_length) == length
+            && SDL_memcmp(pack->names + SDL_SwapLE32(entry->name_offset), name, length) == 0)
+        {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+const void* pack_get_data(Pack* pack, int index, size_t* size) {
+    const PackEntry* entry = pack->entries + index;
+    if(size != NULL)
+        *size = (size_t)SDL_SwapLE64(entry->size);
+
+    if(SDL_SwapLE32(entry->compression) != PACK_COMPRESSION_NONE)
+        return NULL;
+
+    return pack->data + SDL_SwapLE64(entry->offset);
+}
+
+SDL_bool pack_read(Pack* pack, int index, void* buffer) {
+    const PackEntry* entry = pack->entries + index;
+    const Uint8* data = pack->data + SDL_SwapLE64(entry->offset);
+    size_t size = (size_t)SDL_SwapLE64(entry->size);
+
+    if(SDL_SwapLE32(entry->compression) == PACK_COMPRESSION_NONE) {
+        SDL_memcpy(buffer, data, size);
+        return SDL_TRUE;
+    }
+
+    return pack_decompress(data, size, buffer, (size_t)SDL_SwapLE64(entry->original_size));
+}
+
+static Sint64 SDLCALL pack_stream_size(SDL_RWops* rw) {
+    PackStream* stream = rw->hidden.unknown.data1;
+    return (Sint64)stream->size;
+}
+
+static Sint64 SDLCALL pack_stream_seek(SDL_RWops* rw, Sint64 offset, int whence) {
+    PackStream* stream = rw->hidden.unknown.data1;
+    Sint64 position;
+    switch(whence) {
+        case RW_SEEK_SET:
+            position = offset;
+            break;
+        case RW_SEEK_CUR:
+            position = (Sint64)stream->position + offset;
+            break;
+        case RW_SEEK_END:
+            position = (Sint64)stream->size + offset;
+            break;
+        default:
+            return SDL_SetError("Unknown value for 'whence'");
+    }
+
+    if(position < 0)
+        position = 0;
+    else if(position > (Sint64)stream->size)
+        position = (Sint64)stream->size;
+
+    stream->position = (size_t)position;
+    return position;
+}
+
+static size_t SDLCALL pack_stream_read(SDL_RWops* rw, void* ptr, size_t size, size_t maxnum) {
+    PackStream* stream = rw->hidden.unknown.data1;
+    if(size == 0)
+        return 0;
+
+    size_t count = (stream->size - stream->position) / size;
+    if(count > maxnum)
+        count = maxnum;
+
+    SDL_memcpy(ptr, stream->data + stream->position, count * size);
+    stream->position += count * size;
+    return count;
+}
+
+static size_t SDLCALL pack_stream_write(SDL_RWops* rw, const void* ptr, size_t size, size_t num) {
+    SDL_SetError("Can't write to a pack stream.");
+    return 0;
+}
+
+static int SDLCALL pack_stream_close(SDL_RWops* rw) {
+    su_free(rw->hidden.unknown.data1);
+    SDL_FreeRW(rw);
+    return 0;
+}
+
+SDL_RWops* pack_open_rw(Pack* pack, const char* name) {
+    int index = pack_find(pack, name);
+    if(index == -1) {
+        SDL_SetError("Could not find %s in pack.", name);
+        return NULL;
+    }
+
+    const PackEntry* entry = pack->entries + index;
+    if(SDL_SwapLE32(entry->compression) == PACK_COMPRESSION_NONE) {
+        Uint64 size = SDL_SwapLE64(entry->size);
+        if(size > SDL_MAX_SINT32) {
+            SDL_SetError("Could not open %s, too large for a memory stream.", name);
+            return NULL;
+        }
+
+        return SDL_RWFromConstMem(pack->data + SDL_SwapLE64(entry->offset), (int)size);
+    }
+
+    size_t size = pack_get_size(pack, index);
+    PackStream* stream = su_malloc(sizeof(*stream) + size);
+    if(stream == NULL) {
+        SDL_SetError("Could not open %s, not enough memory.", name);
+        return NULL;
+    }
+
+    stream->data = (Uint8*)(stream + 1);
+    stream->size = size;
+    stream->position = 0;
+
+    if(!pack_read(pack, index, stream->data)) {
+        SDL_SetError("Could not open %s, the data is corrupt.", name);
+        su_free(stream);
+        return NULL;
+    }
+
+    SDL_RWops* rw = SDL_AllocRW();
+    if(rw == NULL) {
+        su_free(stream);
+        return NULL;
+    }
+
+    rw->size = pack_stream_size;
+    rw->seek = pack_stream_seek;
+    rw->read = pack_stream_read;
+    rw->write = pack_stream_write;
+    rw->close = pack_stream_close;
+    rw->type = SDL_RWOPS_UNKNOWN;
+    rw->hidden.unknown.data1 = stream;
+
+    return rw;
+}
+
+static inline Uint32 pack_read32(const Uint8* ptr) {
+    Uint32 value;
+    SDL_memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static inline Uint32 pack_hash_sequence(Uint32 sequence) {
+    return (sequence * 2654435761U) >> (32 - PACK_HASH_BITS);
+}
+
+static Uint8* pack_write_length(Uint8* op, size_t length) {
+    while(length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (Uint8)length;
+    return op;
+}
+
+static Uint8* pack_write_literals(Uint8* op, const Uint8* literals, size_t length) {
+    Uint8* token = op++;
+    if(length >= 15) {
+        *token = 15 << 4;
+        op = pack_write_length(op, length - 15);
+    } else {
+        *token = (Uint8)(length << 4);
+    }
+
+    SDL_memcpy(op, literals, length);
+    return op + length;
+}
+
+size_t pack_compress(const void* src, size_t size, void* dst) {
+    const Uint8* in = src;
+    Uint8* op = dst;
+    size_t anchor = 0;
+
+    // Blocks too small to hold a match are stored as a single run of literals.
+    if(size > PACK_MATCH_LIMIT) {
+        Uint32 table[1 << PACK_HASH_BITS];
+        SDL_memset(table, 0, sizeof(table));
+
+        size_t match_limit = size - PACK_MATCH_LIMIT;
+        size_t end_limit = size - PACK_LAST_LITERALS;
+        size_t ip = 0;
+
+        while(ip < match_limit) {
+            Uint32 sequence = pack_read32(in + ip);
+            Uint32 hash = pack_hash_sequence(sequence);
+            size_t ref = table[hash];
+            table[hash] = (Uint32)ip;
+
+            if(ref >= ip || ip - ref > PACK_MAX_OFFSET || pack_read32(in + ref) != sequence) {
+                // Skip ahead faster the longer nothing matches.
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            size_t length = PACK_MIN_MATCH;
+            while(ip + length < end_limit && in[ref + length] == in[ip + length])
+                length++;
+
+            while(ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1]) {
+                ip--;
+                ref--;
+                length++;
+            }
+
+            Uint8* token = op;
+            op = pack_write_literals(op, in + anchor, ip - anchor);
+
+            size_t offset = ip - ref;
+            *op++ = (Uint8)offset;
+            *op++ = (Uint8)(offset >> 8);
+
+            size_t extra = length - PACK_MIN_MATCH;
+            if(extra >= 15) {
+                *token |= 15;
+                op = pack_write_length(op, extra - 15);
+            } else {
+                *token |= (Uint8)extra;
+            }
+
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    op = pack_write_literals(op, in + anchor, size - anchor);
+    return (size_t)(op - (Uint8*)dst);
+}
+
+static SDL_bool pack_read_length(const Uint8** ip, const Uint8* end, size_t* length) {
+    Uint8 value;
+    do {
+        if(*ip >= end)
+            return SDL_FALSE;
+        value = *(*ip)++;
+        *length += value;
+    } while(value == 255);
+    return SDL_TRUE;
+}
+
+SDL_bool pack_decompress(const void* src, size_t size, void* dst, size_t dst_size) {
+    const Uint8* ip = src;
+    const Uint8* in_end = ip + size;
+    Uint8* op = dst;
+    Uint8* out_end = op + dst_size;
+
+    while(ip < in_end) {
+        Uint8 token = *ip++;
+
+        size_t literals = token >> 4;
+        if(literals == 15 && !pack_read_length(&ip, in_end, &literals))
+            return SDL_FALSE;
+
+        if(literals > (size_t)(in_end - ip) || literals > (size_t)(out_end - op))
+            return SDL_FALSE;
+
+        SDL_memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+
+        // The last sequence only contains literals.
+        if(ip == in_end)
+            break;
+
+        if(in_end - ip < 2)
+            return SDL_FALSE;
+
+        size_t offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if(offset == 0 || offset > (size_t)(op - (Uint8*)dst))
+            return SDL_FALSE;
+
+        size_t length = token & 15;
+        if(length == 15 && !pack_read_length(&ip, in_end, &length))
+            return SDL_FALSE;
+        length += PACK_MIN_MATCH;
+
+        if(length > (size_t)(out_end - op))
+            return SDL_FALSE;
+
+        const Uint8* match = op - offset;
+        if(offset >= length) {
+            SDL_memcpy(op, match, length);
+            op += length;
+        } else {
+            // The match overlaps the output, which repeats the last offset bytes.
+            for(size_t i = 0; i < length; i++)
+                *op++ = match[i];
+        }
+    }
+
+    return op == out_end;
+}
+
+void pack_writer_init(PackWriter* writer) {
+    writer->entries = NULL;
+    writer->count = 0;
+    writer->capacity = 0;
+}
+
+void pack_writer_free_resources(PackWriter* writer) {
+    for(int i = 0; i < writer->count; i++) {
+        su_free(writer->entries[i].name);
+        su_free(writer->entries[i].data);
+    }
+
+    su_free(writer->entries);
+    pack_writer_init(writer);
+}
+
+SDL_bool pack_writer_add(PackWriter* writer, const char* name, const void* data, size_t size, SDL_bool compress) {
+    if(writer->count == writer->capacity) {
+        int capacity = writer->capacity == 0 ? 16 : writer->capacity * 2;
+        PackWriterEntry* entries = su_realloc(writer->entries, sizeof(*entries) * capacity);
+        if(entries == NULL)
+            goto error;
+
+        writer->entries = entries;
+        writer->capacity = capacity;
+    }
+
+    size_t length = SDL_strlen(name);
+    char* copy = su_malloc(length + 1);
+    if(copy == NULL)
+        goto error;
+
+    // Allocate at least a byte so empty files still have a valid pointer.
+    Uint8* contents = su_malloc(size > 0 ? size : 1);
+    if(contents == NULL) {
+        su_free(copy);
+        goto error;
+    }
+
+    SDL_memcpy(copy, name, length + 1);
+    SDL_memcpy(contents, data, size);
+
+    writer->entries[writer->count++] = (PackWriterEntry){
+        copy,
+        pack_hash(name, length),
+        contents,
+        size,
+        compress
+    };
+
+    return SDL_TRUE;
+
+    error:
+        SDL_SetError("Could not add %s to pack, not enough memory.", name);
+        return SDL_FALSE;
+}
+
+SDL_bool pack_writer_add_file(PackWriter* writer, const char* name, const char* path, SDL_bool compress) {
+    SDL_RWops* rw = SDL_RWFromFile(path, "rb");
+    if(rw == NULL)
+        return SDL_FALSE;
+
+    Sint64 size = SDL_RWsize(rw);
+    if(size < 0) {
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+
+    Uint8* data = su_malloc(size > 0 ? (size_t)size : 1);
+    if(data == NULL) {
+        SDL_SetError("Could not read %s, not enough memory.", path);
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+
+    if(size > 0 && SDL_RWread(rw, data, (size_t)size, 1) != 1) {
+        su_free(data);
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+
+    SDL_RWclose(rw);
+
+    SDL_bool result = pack_writer_add(writer, name, data, (size_t)size, compress);
+    su_free(data);
+    return result;
+}
+
+static int pack_writer_compare(const void* left, const void* right) {
+    const PackWriterEntry* a = left;
+    const PackWriterEntry* b = right;
+    if(a->hash != b->hash)
+        return a->hash < b->hash ? -1 : 1;
+    return SDL_strcmp(a->name, b->name);
+}
+
+static SDL_bool pack_write_padding(SDL_RWops* output, Uint64* position, Uint32 alignment) {
+    static const Uint8 zeros[16] = { 0 };
+    Uint64 padding = (alignment - (*position & (alignment - 1))) & (alignment - 1);
+    *position += padding;
+
+    while(padding > 0) {
+        size_t chunk = padding < sizeof(zeros) ? (size_t)padding : sizeof(zeros);
+        if(SDL_RWwrite(output, zeros, chunk, 1) != 1)
+            return SDL_FALSE;
+        padding -= chunk;
+    }
+
+    return SDL_TRUE;
+}
+
+static SDL_bool pack_write_header(SDL_RWops* output, const PackHeader* header) {
+    size_t ok = 1;
+    ok &= SDL_WriteLE32(output, header->magic);
+    ok &= SDL_WriteLE32(output, header->version);
+    ok &= SDL_WriteLE32(output, header->entry_count);
+    ok &= SDL_WriteLE32(output, header->alignment);
+    ok &= SDL_WriteLE64(output, header->index_offset);
+    ok &= SDL_WriteLE64(output, header->names_offset);
+    ok &= SDL_WriteLE64(output, header->names_size);
+    return ok ? SDL_TRUE : SDL_FALSE;
+}
+
+SDL_bool pack_writer_save(PackWriter* writer, SDL_RWops* output, Uint32 alignment) {
+    if(alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        SDL_SetError("Could not save pack, the alignment must be a power of two.");
+        return SDL_FALSE;
+    }
+
+    if(alignment < sizeof(Uint64))
+        alignment = sizeof(Uint64);
+
+    SDL_qsort(writer->entries, writer->count, sizeof(*writer->entries), pack_writer_compare);
+
+    for(int i = 1; i < writer->count; i++) {
+        if(pack_writer_compare(writer->entries + i - 1, writer->entries + i) == 0) {
+            SDL_SetError("Could not save pack, %s was added more than once.", writer->entries[i].name);
+            return SDL_FALSE;
+        }
+    }
+
+    PackEntry* index = su_malloc(sizeof(*index) * (writer->count > 0 ? writer->count : 1));
+    if(index == NULL) {
+        SDL_SetError("Could not save pack, not enough memory.");
+        return SDL_FALSE;
+    }
+
+    Uint8* compressed = NULL;
+    PackHeader header = { PACK_FILE_MAGIC, PACK_FILE_VERSION, (Uint32)writer->count, alignment, 0, 0, 0 };
+
+    // The data is written first so each file can be compressed right before it's
+    // written. The header is rewritten at the end, once the index has been placed.
+    if(!pack_write_header(output, &header))
+        goto error;
+
+    Uint64 position = sizeof(PackHeader);
+    Uint32 names_size = 0;
+
+    for(int i = 0; i < writer->count; i++) {
+        PackWriterEntry* file = writer->entries + i;
+        const Uint8* data = file->data;
+        size_t size = file->size;
+        Uint32 compression = PACK_COMPRESSION_NONE;
+
+        if(file->compress && size > 0) {
+            Uint8* buffer = su_realloc(compressed, pack_compress_bound(size));
+            if(buffer == NULL) {
+                SDL_SetError("Could not save pack, not enough memory.");
+                goto error;
+            }
+            compressed = buffer;
+
+            size_t compressed_size = pack_compress(data, size, compressed);
+            if(compressed_size < size) {
+                data = compressed;
+                size = compressed_size;
+                compression = PACK_COMPRESSION_LZ4;
+            }
+        }
+
+        if(!pack_write_padding(output, &position, alignment))
+            goto error;
+
+        size_t name_length = SDL_strlen(file->name);
+        index[i] = (PackEntry){
+            file->hash,
+            position,
+            size,
+            file->size,
+            names_size,
+            (Uint32)name_length,
+            compression,
+            0
+        };
+
+        if(size > 0 && SDL_RWwrite(output, data, size, 1) != 1)
+            goto error;
+
+        position += size;
+        names_size += (Uint32)name_length;
+    }
+
+    if(!pack_write_padding(output, &position, sizeof(Uint64)))
+        goto error;
+
+    header.index_offset = position;
+    for(int i = 0; i < writer->count; i++) {
+        size_t ok = 1;
+        ok &= SDL_WriteLE64(output, index[i].hash);
+        ok &= SDL_WriteLE64(output, index[i].offset);
+        ok &= SDL_WriteLE64(output, index[i].size);
+        ok &= SDL_WriteLE64(output, index[i].original_size);
+        ok &= SDL_WriteLE32(output, index[i].name_offset);
+        ok &= SDL_WriteLE32(output, index[i].name_length);
+        ok &= SDL_WriteLE32(output, index[i].compression);
+        ok &= SDL_WriteLE32(output, index[i].reserved);
+        if(!ok)
+            goto error;
+    }
+
+    position += sizeof(PackEntry) * (Uint64)writer->count;
+    header.names_offset = position;
+    header.names_size = names_size;
+
+    for(int i = 0; i < writer->count; i++) {
+        if(index[i].name_length > 0 && SDL_RWwrite(output, writer->entries[i].name, index[i].name_length, 1) != 1)
+            goto error;
+    }
+
+    if(SDL_RWseek(output, 0, RW_SEEK_SET) != 0 || !pack_write_header(output, &header))
+        goto error;
+
+    su_free(compressed);
+    su_free(index);
+    return SDL_TRUE;
+
+    error:
+        su_free(compressed);
+        su_free(index);
+        return SDL_FALSE;
+}
@@ -0,0 +1,152 @@
+#include <su_parallax.h>
+
+#include <math.h>
+
+void parallax_init(Parallax* parallax) {
+    parallax->layers = NULL;
+    parallax->layer_count = 0;
+    parallax->layer_capacity = 0;
+}
+
+Parallax* parallax_create(void) {
+    Parallax* parallax = su_malloc(sizeof(*parallax));
+    if(parallax == NULL)
+        return NULL;
+
+    parallax_init(parallax);
+    return parallax;
+}
+
+void parallax_free_resources(Parallax* parallax) {
+    for(int i = 0; i < parallax->layer_count; i++) {
+        if(parallax->layers[i].target != NULL)
+            SDL_DestroyTexture(parallax->layers[i].target);
+    }
+
+    su_free(parallax->layers);
+    parallax_init(parallax);
+}
+
+void parallax_free(Parallax* parallax) {
+    parallax_free_resources(parallax);
+    su_free(parallax);
+}
+
+int parallax_add_layer(Parallax* parallax,
+                       int width,
+                       int height,
+                       Vector2 scroll,
+                       SDL_bool repeat_x,
+                       SDL_bool repeat_y,
+                       ParallaxDrawFn draw,
+                       void* data)
+{
+    if(width <= 0 || height <= 0) {
+        SDL_SetError("Could not add parallax layer, the size must be positive.");
+        return -1;
+    }
+
+    if(parallax->layer_count == parallax->layer_capacity) {
+        int capacity = parallax->layer_capacity == 0 ? 4 : parallax->layer_capacity * 2;
+        ParallaxLayer* layers = su_realloc(parallax->layers, sizeof(ParallaxLayer) * capacity);
+        if(layers == NULL) {
+            SDL_SetError("Could not add parallax layer, not enough memory.");
+            return -1;
+        }
+        parallax->layers = layers;
+        parallax->layer_capacity = capacity;
+    }
+
+    ParallaxLayer* layer = parallax->layers + parallax->layer_count;
+    layer->target = NULL;
+    layer->draw = draw;
+    layer->data = data;
+    layer->scroll = scroll;
+    layer->offset = (Vector2){ 0, 0 };
+    layer->width = width;
+    layer->height = height;
+    layer->repeat_x = repeat_x;
+    layer->repeat_y = repeat_y;
+    layer->dirty = SDL_TRUE;
+
+    return parallax->layer_count++;
+}
+
+static SDL_bool parallax_layer_redraw(ParallaxLayer* layer, SDL_Renderer* renderer) {
+    if(layer->target == NULL) {
+        layer->target = SDL_CreateTexture(renderer, PARALLAX_LAYER_FORMAT, SDL_TEXTUREACCESS_TARGET, layer->width, layer->height);
+        if(layer->target == NULL)
+            return SDL_FALSE;
+
+        SDL_SetTextureBlendMode(layer->target, SDL_BLENDMODE_BLEND);
+    }
+
+    Texture* previous_target = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    float scale_x, scale_y;
+    SDL_RenderGetScale(renderer, &scale_x, &scale_y);
+
+    if(SDL_SetRenderTarget(renderer, layer->target) != 0)
+        return SDL_FALSE;
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    if(layer->draw != NULL)
+        layer->draw(renderer, layer, layer->data);
+
+    // Changing the render target resets the scale and viewport, so put
+    // them back the way scene_draw leaves them.
+    SDL_SetRenderTarget(renderer, previous_target);
+    SDL_RenderSetScale(renderer, scale_x, scale_y);
+    SDL_RenderSetViewport(renderer, NULL);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+    layer->dirty = SDL_FALSE;
+    return SDL_TRUE;
+}
+
+// Gets the first position along an axis where a repeating layer needs to be drawn
+// so that it covers the start of the view.
+static inline float parallax_wrap(float position, int size) {
+    float wrapped = fmodf(position, (float)size);
+    if(wrapped > 0)
+        wrapped -= size;
+    return wrapped;
+}
+
+SDL_bool parallax_draw(Parallax* parallax, Camera* camera) {
+    SDL_Renderer* renderer = camera->renderer;
+    Rectangle view = camera_get_bounds(camera);
+    SDL_bool result = SDL_TRUE;
+
+    for(int i = 0; i < parallax->layer_count; i++) {
+        ParallaxLayer* layer = parallax->layers + i;
+
+        if(layer->dirty || layer->target == NULL) {
+            if(!parallax_layer_redraw(layer, renderer)) {
+                result = SDL_FALSE;
+                continue;
+            }
+        }
+
+        float x = layer->offset.x - view.x * layer->scroll.x;
+        float y = layer->offset.y - view.y * layer->scroll.y;
+
+        float start_x = layer->repeat_x ? parallax_wrap(x, layer->width) : x;
+        float start_y = layer->repeat_y ? parallax_wrap(y, layer->height) : y;
+        float end_x = layer->repeat_x ? (float)view.w : start_x + 1;
+        float end_y = layer->repeat_y ? (float)view.h : start_y + 1;
+
+        for(float draw_y = start_y; draw_y < end_y; draw_y += layer->height) {
+            for(float draw_x = start_x; draw_x < end_x; draw_x += layer->width) {
+                SDL_FRect dst = { draw_x, draw_y, (float)layer->width, (float)layer->height };
+                if(SDL_RenderCopyF(renderer, layer->target, NULL, &dst) != 0)
+                    result = SDL_FALSE;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,329 @@
+#include <su_particles.h>
+
+#include <math.h>
+
+#include "su_simd.h"
+
+/**
+    The fewest particles integrated by a single job. Smaller batches
+    cost more to schedule than they save.
+*/
+#define PARTICLE_JOB_BATCH 4096
+
+typedef struct ParticleJob {
+    ParticleEmitter* emitter;
+    float delta;
+} ParticleJob;
+
+static inline void particle_emitter_reset_bounds(ParticleEmitter* emitter) {
+    emitter->bounds_min = (Vector2){ INFINITY, INFINITY };
+    emitter->bounds_max = (Vector2){ -INFINITY, -INFINITY };
+}
+
+static inline void particle_emitter_expand_bounds(ParticleEmitter* emitter, float x, float y) {
+    if(x < emitter->bounds_min.x)
+        emitter->bounds_min.x = x;
+    if(y < emitter->bounds_min.y)
+        emitter->bounds_min.y = y;
+    if(x > emitter->bounds_max.x)
+        emitter->bounds_max.x = x;
+    if(y > emitter->bounds_max.y)
+        emitter->bounds_max.y = y;
+}
+
+SDL_bool particle_emitter_init(ParticleEmitter* emitter, const ParticleEmitterSettings* settings, int max_particles, Uint64 seed) {
+    if(max_particles <= 0 || max_particles > SDL_MAX_SINT32 / 6) {
+        SDL_SetError("Could not create particle emitter, invalid particle count.");
+        return SDL_FALSE;
+    }
+
+    SDL_memset(emitter, 0, sizeof(*emitter));
+
+    size_t size = sizeof(float) * max_particles;
+    if((emitter->x = su_malloc(size)) == NULL
+        || (emitter->y = su_malloc(size)) == NULL
+        || (emitter->velocity_x = su_malloc(size)) == NULL
+        || (emitter->velocity_y = su_malloc(size)) == NULL
+        || (emitter->life = su_malloc(size)) == NULL
+        || (emitter->inv_lifetime = su_malloc(size)) == NULL
+        || (emitter->vertices = su_malloc(sizeof(SDL_Vertex) * 4 * max_particles)) == NULL
+        || (emitter->indices = su_malloc(sizeof(int) * 6 * max_particles)) == NULL)
+    {
+        goto error;
+    }
+
+    // Every particle is a quad with the same layout, so the indices never change.
+    for(int i = 0; i < max_particles; i++) {
+        int* index = emitter->indices + i * 6;
+        int vertex = i * 4;
+        index[0] = vertex;
+        index[1] = vertex + 1;
+        index[2] = vertex + 2;
+        index[3] = vertex + 2;
+        index[4] = vertex + 1;
+        index[5] = vertex + 3;
+    }
+
+    emitter->capacity = max_particles;
+    emitter->emitting = SDL_TRUE;
+    particle_emitter_reset_bounds(emitter);
+    random_seed(&emitter->random, seed);
+    particle_emitter_set_settings(emitter, settings);
+
+    return SDL_TRUE;
+
+    error:
+        particle_emitter_free_resources(emitter);
+        SDL_SetError("Could not create particle emitter, not enough memory.");
+        return SDL_FALSE;
+}
+
+ParticleEmitter* particle_emitter_create(const ParticleEmitterSettings* settings, int max_particles, Uint64 seed) {
+    ParticleEmitter* emitter = su_malloc(sizeof(*emitter));
+    if(emitter == NULL) {
+        SDL_SetError("Could not create particle emitter, not enough memory.");
+        return NULL;
+    }
+
+    if(!particle_emitter_init(emitter, settings, max_particles, seed)) {
+        su_free(emitter);
+        return NULL;
+    }
+
+    return emitter;
+}
+
+void particle_emitter_free_resources(ParticleEmitter* emitter) {
+    su_free(emitter->x);
+    su_free(emitter->y);
+    su_free(emitter->velocity_x);
+    su_free(emitter->velocity_y);
+    su_free(emitter->life);
+    su_free(emitter->inv_lifetime);
+    su_free(emitter->vertices);
+    su_free(emitter->indices);
+
+    emitter->x = NULL;
+    emitter->y = NULL;
+    emitter->velocity_x = NULL;
+    emitter->velocity_y = NULL;
+    emitter->life = NULL;
+    emitter->inv_lifetime = NULL;
+    emitter->vertices = NULL;
+    emitter->indices = NULL;
+    emitter->count = 0;
+    emitter->capacity = 0;
+}
+
+void particle_emitter_free(ParticleEmitter* emitter) {
+    particle_emitter_free_resources(emitter);
+    su_free(emitter);
+}
+
+void particle_emitter_set_settings(ParticleEmitter* emitter, const ParticleEmitterSettings* settings) {
+    emitter->settings = *settings;
+
+    emitter->uv_min = (SDL_FPoint){ 0, 0 };
+    emitter->uv_max = (SDL_FPoint){ 1, 1 };
+
+    int width, height;
+    if(settings->texture != NULL && SDL_QueryTexture(settings->texture, NULL, NULL, &width, &height) == 0) {
+        Rectangle source = settings->source;
+        if(source.w > 0 && source.h > 0 && width > 0 && height > 0) {
+            emitter->uv_min = (SDL_FPoint){ (float)source.x / width, (float)source.y / height };
+            emitter->uv_max = (SDL_FPoint){ (float)(source.x + source.w) / width, (float)(source.y + source.h) / height };
+        }
+    }
+}
+
+int particle_emitter_emit(ParticleEmitter* emitter, int count) {
+    ParticleEmitterSettings* settings = &emitter->settings;
+    Random* random = &emitter->random;
+
+    if(count > emitter->capacity - emitter->count)
+        count = emitter->capacity - emitter->count;
+
+    for(int i = 0; i < count; i++) {
+        int index = emitter->count++;
+        float angle = random_range_float(random, settings->angle_min, settings->angle_max);
+        float speed = random_range_float(random, settings->speed_min, settings->speed_max);
+        float lifetime = random_range_float(random, settings->lifetime_min, settings->lifetime_max);
+
+        float x = settings->position.x + random_range_float(random, -settings->spread.x, settings->spread.x);
+        float y = settings->position.y + random_range_float(random, -settings->spread.y, settings->spread.y);
+
+        emitter->x[index] = x;
+        emitter->y[index] = y;
+        emitter->velocity_x[index] = cosf(angle) * speed;
+        emitter->velocity_y[index] = sinf(angle) * speed;
+        emitter->life[index] = lifetime;
+        emitter->inv_lifetime[index] = lifetime > 0 ? 1 / lifetime : 0;
+
+        particle_emitter_expand_bounds(emitter, x, y);
+    }
+
+    return count;
+}
+
+void particle_emitter_integrate(ParticleEmitter* emitter, float delta, int start, int end) {
+    float* x = emitter->x;
+    float* y = emitter->y;
+    float* velocity_x = emitter->velocity_x;
+    float* velocity_y = emitter->velocity_y;
+    float* life = emitter->life;
+
+    float gravity_x = emitter->settings.gravity.x * delta;
+    float gravity_y = emitter->settings.gravity.y * delta;
+    float damping = 1 - emitter->settings.drag * delta;
+    if(damping < 0)
+        damping = 0;
+
+    int i = start;
+#ifdef SU_SIMD
+    simd_float4 dt = simd_set1(delta);
+    simd_float4 gx = simd_set1(gravity_x);
+    simd_float4 gy = simd_set1(gravity_y);
+    simd_float4 damp = simd_set1(damping);
+    for(; i + SU_SIMD_WIDTH <= end; i += SU_SIMD_WIDTH) {
+        simd_float4 vx = simd_mul(simd_add(simd_load(velocity_x + i), gx), damp);
+        simd_float4 vy = simd_mul(simd_add(simd_load(velocity_y + i), gy), damp);
+        simd_store(velocity_x + i, vx);
+        simd_store(velocity_y + i, vy);
+        simd_store(x + i, simd_add(simd_load(x + i), simd_mul(vx, dt)));
+        simd_store(y + i, simd_add(simd_load(y + i), simd_mul(vy, dt)));
+        simd_store(life + i, simd_sub(simd_load(life + i), dt));
+    }
+#endif
+    for(; i < end; i++) {
+        velocity_x[i] = (velocity_x[i] + gravity_x) * damping;
+        velocity_y[i] = (velocity_y[i] + gravity_y) * damping;
+        x[i] += velocity_x[i] * delta;
+        y[i] += velocity_y[i] * delta;
+        life[i] -= delta;
+    }
+}
+
+void particle_emitter_compact(ParticleEmitter* emitter) {
+    float* x = emitter->x;
+    float* y = emitter->y;
+    float* life = emitter->life;
+
+    particle_emitter_reset_bounds(emitter);
+
+    int i = 0;
+    while(i < emitter->count) {
+        if(life[i] > 0) {
+            particle_emitter_expand_bounds(emitter, x[i], y[i]);
+            i++;
+            continue;
+        }
+
+        // Swap the last particle into the hole. It gets checked on the next iteration.
+        int last = --emitter->count;
+        x[i] = x[last];
+        y[i] = y[last];
+        emitter->velocity_x[i] = emitter->velocity_x[last];
+        emitter->velocity_y[i] = emitter->velocity_y[last];
+        life[i] = life[last];
+        emitter->inv_lifetime[i] = emitter->inv_lifetime[last];
+    }
+}
+
+static void particle_emitter_spawn(ParticleEmitter* emitter, float delta) {
+    if(emitter->emitting && emitter->settings.rate > 0) {
+        emitter->spawn_accumulator += emitter->settings.rate * delta;
+        int spawn = (int)emitter->spawn_accumulator;
+        emitter->spawn_accumulator -= spawn;
+        particle_emitter_emit(emitter, spawn);
+    }
+}
+
+void particle_emitter_update(ParticleEmitter* emitter, float delta) {
+    particle_emitter_integrate(emitter, delta, 0, emitter->count);
+    particle_emitter_compact(emitter);
+    particle_emitter_spawn(emitter, delta);
+}
+
+static void particle_emitter_integrate_job(int start, int end, void* data) {
+    ParticleJob* job = data;
+    particle_emitter_integrate(job->emitter, job->delta, start, end);
+}
+
+void particle_emitter_update_jobs(ParticleEmitter* emitter, JobSystem* jobs, float delta) {
+    ParticleJob job = { emitter, delta };
+    job_parallel_for(jobs, emitter->count, PARTICLE_JOB_BATCH, particle_emitter_integrate_job, &job);
+    particle_emitter_compact(emitter);
+    particle_emitter_spawn(emitter, delta);
+}
+
+static inline Uint8 particle_lerp_channel(Uint8 from, Uint8 to, float t) {
+    return (Uint8)(from + (to - from) * t + 0.5f);
+}
+
+SDL_bool particle_emitter_draw(ParticleEmitter* emitter, Camera* camera) {
+    if(emitter->count == 0)
+        return SDL_TRUE;
+
+    ParticleEmitterSettings* settings = &emitter->settings;
+    Rectangle view = camera_get_bounds(camera);
+    float radius = SDL_max(settings->start_size, settings->end_size) * 0.5f;
+
+    float view_left = view.x - radius;
+    float view_top = view.y - radius;
+    float view_right = view.x + view.w + radius;
+    float view_bottom = view.y + view.h + radius;
+
+    // Skip the whole emitter when none of its particles can be visible.
+    if(emitter->bounds_max.x < view_left || emitter->bounds_min.x > view_right
+        || emitter->bounds_max.y < view_top || emitter->bounds_min.y > view_bottom)
+    {
+        return SDL_TRUE;
+    }
+
+    SDL_Vertex* vertex = emitter->vertices;
+    int visible = 0;
+
+    for(int i = 0; i < emitter->count; i++) {
+        float x = emitter->x[i];
+        float y = emitter->y[i];
+        if(x < view_left || x > view_right || y < view_top || y > view_bottom)
+            continue;
+
+        float t = 1 - emitter->life[i] * emitter->inv_lifetime[i];
+        if(t < 0)
+            t = 0;
+        else if(t > 1)
+            t = 1;
+
+        float half = (settings->start_size + (settings->end_size - settings->start_size) * t) * 0.5f;
+        SDL_Color color = {
+            particle_lerp_channel(settings->start_color.r, settings->end_color.r, t),
+            particle_lerp_channel(settings->start_color.g, settings->end_color.g, t),
+            particle_lerp_channel(settings->start_color.b, settings->end_color.b, t),
+            particle_lerp_channel(settings->start_color.a, settings->end_color.a, t)
+        };
+
+        float left = x - view.x - half;
+        float top = y - view.y - half;
+        float right = x - view.x + half;
+        float bottom = y - view.y + half;
+
+        vertex[0] = (SDL_Vertex){ { left, top }, color, { emitter->uv_min.x, emitter->uv_min.y } };
+        vertex[1] = (SDL_Vertex){ { right, top }, color, { emitter->uv_max.x, emitter->uv_min.y } };
+        vertex[2] = (SDL_Vertex){ { left, bottom }, color, { emitter->uv_min.x, emitter->uv_max.y } };
+        vertex[3] = (SDL_Vertex){ { right, bottom }, color, { emitter->uv_max.x, emitter->uv_max.y } };
+
+        vertex += 4;
+        visible++;
+    }
+
+    if(visible == 0)
+        return SDL_TRUE;
+
+    return SDL_RenderGeometry(camera->renderer,
+                              settings->texture,
+                              emitter->vertices,
+                              visible * 4,
+                              emitter->indices,
+                              visible * 6) == 0;
+}
@@ -0,0 +1,131 @@
+#include <su_random.h>
+
+static inline Uint64 random_splitmix(Uint64* x) {
+    Uint64 z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void random_seed(Random* random, Uint64 seed) {
+    // splitmix64 spreads the seed over the whole state, which also
+    // guarantees it's never all zero.
+    for(int i = 0; i < 4; i++)
+        random->state[i] = random_splitmix(&seed);
+}
+
+static void random_jump_by(Random* random, const Uint64 table[4]) {
+    Uint64 s0 = 0;
+    Uint64 s1 = 0;
+    Uint64 s2 = 0;
+    Uint64 s3 = 0;
+
+    for(int i = 0; i < 4; i++) {
+        for(int b = 0; b < 64; b++) {
+            if(table[i] & ((Uint64)1 << b)) {
+                s0 ^= random->state[0];
+                s1 ^= random->state[1];
+                s2 ^= random->state[2];
+                s3 ^= random->state[3];
+            }
+            random_next(random);
+        }
+    }
+
+    random->state[0] = s0;
+    random->state[1] = s1;
+    random->state[2] = s2;
+    random->state[3] = s3;
+}
+
+void random_jump(Random* random) {
+    static const Uint64 table[4] = {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+        0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+    };
+
+    random_jump_by(random, table);
+}
+
+void random_long_jump(Random* random) {
+    static const Uint64 table[4] = {
+        0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull,
+        0x77710069854EE241ull, 0x39109BB02ACBE635ull
+    };
+
+    random_jump_by(random, table);
+}
+
+// The batch functions split every 64 bit output into two 32 bit values,
+// which halves the number of generator steps.
+
+void random_fill_u32(Random* random, Uint32* output, int count) {
+    int i = 0;
+    for(; i + 1 < count; i += 2) {
+        Uint64 value = random_next(random);
+        output[i] = (Uint32)(value >> 32);
+        output[i + 1] = (Uint32)value;
+    }
+
+    if(i < count)
+        output[i] = random_next_u32(random);
+}
+
+void random_fill_float(Random* random, float* output, int count, float min, float max) {
+    // 24 bits per float, the full precision of the mantissa.
+    float scale = (max - min) * (1.0f / 16777216.0f);
+
+    // min + scale * 0xFFFFFF can round up to max, so clamp to the float below it.
+    float limit = max > min ? random_float_before(max) : min;
+
+    int i = 0;
+    for(; i + 1 < count; i += 2) {
+        Uint64 value = random_next(random);
+        float first = min + (Uint32)(value >> 40) * scale;
+        float second = min + (Uint32)((value >> 8) & 0xFFFFFF) * scale;
+        output[i] = first > limit ? limit : first;
+        output[i + 1] = second > limit ? limit : second;
+    }
+
+    if(i < count) {
+        float last = min + (Uint32)(random_next(random) >> 40) * scale;
+        output[i] = last > limit ? limit : last;
+    }
+}
+
+// Hands out the two halves of every 64 bit output in turn. Both halves of
+// xoshiro256** are full quality.
+typedef struct RandomHalves {
+    Uint64 value;
+    SDL_bool buffered;
+} RandomHalves;
+
+static inline Uint32 random_halves_next(Random* random, RandomHalves* halves) {
+    if(halves->buffered) {
+        halves->buffered = SDL_FALSE;
+        return (Uint32)halves->value;
+    }
+
+    halves->value = random_next(random);
+    halves->buffered = SDL_TRUE;
+    return (Uint32)(halves->value >> 32);
+}
+
+void random_fill_int(Random* random, int* output, int count, int min, int max) {
+    Uint32 span = (Uint32)max - (Uint32)min + 1;
+    if(span == 0) {
+        random_fill_u32(random, (Uint32*)output, count);
+        return;
+    }
+
+    Uint32 threshold = (Uint32)-span % span;
+    RandomHalves halves = { 0, SDL_FALSE };
+
+    for(int i = 0; i < count; i++) {
+        Uint64 m = (Uint64)random_halves_next(random, &halves) * span;
+        while((Uint32)m < threshold)
+            m = (Uint64)random_halves_next(random, &halves) * span;
+
+        output[i] = (int)((Uint32)min + (Uint32)(m >> 32));
+    }
+}
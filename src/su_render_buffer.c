@@ -0,0 +1,262 @@
+#include <su_render_buffer.h>
+
+#define ARENA_ALIGNMENT 8
+
+static RenderCommand* render_buffer_push(RenderCommandBuffer* buffer, Uint64 sort_key, RenderCommandType type, Texture* texture) {
+    if(buffer->count == buffer->capacity) {
+        int capacity = buffer->capacity == 0 ? 64 : buffer->capacity * 2;
+        RenderCommand* commands = su_realloc(buffer->commands, sizeof(RenderCommand) * capacity);
+        if(commands == NULL) {
+            SDL_SetError("Could not record render command, not enough memory.");
+            return NULL;
+        }
+        buffer->commands = commands;
+        buffer->capacity = capacity;
+    }
+
+    RenderCommand* command = buffer->commands + buffer->count;
+    if(buffer->count > 0 && buffer->commands[buffer->count - 1].sort_key > sort_key)
+        buffer->sorted = SDL_FALSE;
+
+    command->sort_key = sort_key;
+    command->sequence = (Uint32)buffer->count++;
+    command->type = type;
+    command->texture = texture;
+    return command;
+}
+
+// Copies data into the arena and returns its offset, or SIZE_MAX on failure.
+// Offsets are stored instead of pointers since the arena can move when it grows.
+static size_t render_buffer_arena_push(RenderCommandBuffer* buffer, const void* data, size_t size) {
+    size_t offset = (buffer->arena_size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if(offset + size > buffer->arena_capacity) {
+        size_t capacity = buffer->arena_capacity == 0 ? 4096 : buffer->arena_capacity;
+        while(capacity < offset + size)
+            capacity *= 2;
+
+        Uint8* arena = su_realloc(buffer->arena, capacity);
+        if(arena == NULL) {
+            SDL_SetError("Could not record render command, not enough memory for geometry.");
+            return SIZE_MAX;
+        }
+        buffer->arena = arena;
+        buffer->arena_capacity = capacity;
+    }
+
+    SDL_memcpy(buffer->arena + offset, data, size);
+    buffer->arena_size = offset + size;
+    return offset;
+}
+
+void render_buffer_init(RenderCommandBuffer* buffer) {
+    buffer->commands = NULL;
+    buffer->count = 0;
+    buffer->capacity = 0;
+    buffer->arena = NULL;
+    buffer->arena_size = 0;
+    buffer->arena_capacity = 0;
+    buffer->sorted = SDL_TRUE;
+}
+
+RenderCommandBuffer* render_buffer_create(void) {
+    RenderCommandBuffer* buffer = su_malloc(sizeof(*buffer));
+    if(buffer == NULL)
+        return NULL;
+
+    render_buffer_init(buffer);
+    return buffer;
+}
+
+void render_buffer_free_resources(RenderCommandBuffer* buffer) {
+    su_free(buffer->commands);
+    su_free(buffer->arena);
+    render_buffer_init(buffer);
+}
+
+void render_buffer_free(RenderCommandBuffer* buffer) {
+    render_buffer_free_resources(buffer);
+    su_free(buffer);
+}
+
+SDL_bool render_buffer_clear(RenderCommandBuffer* buffer, Uint64 sort_key, SDL_Color color) {
+    RenderCommand* command = render_buffer_push(buffer, sort_key, RENDER_COMMAND_CLEAR, NULL);
+    if(command == NULL)
+        return SDL_FALSE;
+
+    command->data.clear = color;
+    return SDL_TRUE;
+}
+
+SDL_bool render_buffer_copy(RenderCommandBuffer* buffer,
+                            Uint64 sort_key,
+                            Texture* texture,
+                            const Rectangle* src,
+                            const SDL_FRect* dst,
+                            double angle,
+                            SDL_RendererFlip flip)
+{
+    RenderCommand* command = render_buffer_push(buffer, sort_key, RENDER_COMMAND_COPY, texture);
+    if(command == NULL)
+        return SDL_FALSE;
+
+    command->data.copy.has_src = src != NULL;
+    if(src != NULL)
+        command->data.copy.src = *src;
+    command->data.copy.dst = *dst;
+    command->data.copy.angle = angle;
+    command->data.copy.flip = flip;
+    return SDL_TRUE;
+}
+
+SDL_bool render_buffer_geometry(RenderCommandBuffer* buffer,
+                                Uint64 sort_key,
+                                Texture* texture,
+                                const SDL_Vertex* vertices,
+                                int vertex_count,
+                                const int* indices,
+                                int index_count)
+{
+    size_t vertex_offset = render_buffer_arena_push(buffer, vertices, sizeof(SDL_Vertex) * vertex_count);
+    if(vertex_offset == SIZE_MAX)
+        return SDL_FALSE;
+
+    size_t index_offset = 0;
+    if(indices != NULL) {
+        index_offset = render_buffer_arena_push(buffer, indices, sizeof(int) * index_count);
+        if(index_offset == SIZE_MAX)
+            return SDL_FALSE;
+    } else {
+        index_count = 0;
+    }
+
+    RenderCommand* command = render_buffer_push(buffer, sort_key, RENDER_COMMAND_GEOMETRY, texture);
+    if(command == NULL)
+        return SDL_FALSE;
+
+    command->data.geometry.vertex_offset = vertex_offset;
+    command->data.geometry.vertex_count = vertex_count;
+    command->data.geometry.index_offset = index_offset;
+    command->data.geometry.index_count = index_count;
+    return SDL_TRUE;
+}
+
+SDL_bool render_buffer_target(RenderCommandBuffer* buffer, Uint64 sort_key, Texture* target) {
+    return render_buffer_push(buffer, sort_key, RENDER_COMMAND_TARGET, target) != NULL;
+}
+
+static int render_command_compare(const void* left, const void* right) {
+    const RenderCommand* a = left;
+    const RenderCommand* b = right;
+    if(a->sort_key != b->sort_key)
+        return a->sort_key < b->sort_key ? -1 : 1;
+    return a->sequence < b->sequence ? -1 : (a->sequence > b->sequence);
+}
+
+void render_buffer_sort(RenderCommandBuffer* buffer) {
+    if(buffer->sorted)
+        return;
+
+    SDL_qsort(buffer->commands, buffer->count, sizeof(RenderCommand), render_command_compare);
+    buffer->sorted = SDL_TRUE;
+}
+
+static SDL_bool render_command_replay(SDL_Renderer* renderer, RenderCommandBuffer* buffer, RenderCommand* command, Texture* base_target, float base_scale_x, float base_scale_y) {
+    switch(command->type) {
+        case RENDER_COMMAND_CLEAR:
+        {
+            SDL_Color color = command->data.clear;
+            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+            return SDL_RenderClear(renderer) == 0;
+        }
+        case RENDER_COMMAND_COPY:
+            return SDL_RenderCopyExF(renderer,
+                                     command->texture,
+                                     command->data.copy.has_src ? &command->data.copy.src : NULL,
+                                     &command->data.copy.dst,
+                                     command->data.copy.angle,
+                                     NULL,
+                                     command->data.copy.flip) == 0;
+        case RENDER_COMMAND_GEOMETRY:
+            return SDL_RenderGeometry(renderer,
+                                      command->texture,
+                                      (SDL_Vertex*)(buffer->arena + command->data.geometry.vertex_offset),
+                                      command->data.geometry.vertex_count,
+                                      command->data.geometry.index_count > 0
+                                          ? (int*)(buffer->arena + command->data.geometry.index_offset)
+                                          : NULL,
+                                      command->data.geometry.index_count) == 0;
+        case RENDER_COMMAND_TARGET:
+        {
+            if(SDL_SetRenderTarget(renderer, command->texture != NULL ? command->texture : base_target) != 0)
+                return SDL_FALSE;
+
+            // Changing the render target resets the scale and viewport, so put
+            // them back the way scene_draw leaves them.
+            if(command->texture == NULL)
+                SDL_RenderSetScale(renderer, base_scale_x, base_scale_y);
+            return SDL_RenderSetViewport(renderer, NULL) == 0;
+        }
+    }
+
+    return SDL_FALSE;
+}
+
+SDL_bool render_buffer_submit(Camera* camera, RenderCommandBuffer** buffers, int buffer_count) {
+    SDL_Renderer* renderer = camera->renderer;
+    Texture* base_target = SDL_GetRenderTarget(renderer);
+    SDL_bool result = SDL_TRUE;
+    float scale_x, scale_y;
+    SDL_RenderGetScale(renderer, &scale_x, &scale_y);
+
+    // Position of the next command to replay in every buffer.
+    int cursors_stack[16];
+    int* cursors = buffer_count <= 16 ? cursors_stack : su_malloc(sizeof(int) * buffer_count);
+    if(cursors == NULL) {
+        SDL_SetError("Could not submit render buffers, not enough memory.");
+        return SDL_FALSE;
+    }
+
+    for(int i = 0; i < buffer_count; i++) {
+        render_buffer_sort(buffers[i]);
+        cursors[i] = 0;
+    }
+
+    // Every buffer is sorted, so a k-way merge gives the global order. The
+    // number of buffers is usually small (one per system or chunk), so a
+    // linear scan for the smallest key is cheaper than maintaining a heap.
+    for(;;) {
+        int next = -1;
+        Uint64 next_key = 0;
+        for(int i = 0; i < buffer_count; i++) {
+            if(cursors[i] == buffers[i]->count)
+                continue;
+
+            Uint64 key = buffers[i]->commands[cursors[i]].sort_key;
+            if(next == -1 || key < next_key) {
+                next = i;
+                next_key = key;
+            }
+        }
+
+        if(next == -1)
+            break;
+
+        RenderCommandBuffer* buffer = buffers[next];
+        while(cursors[next] < buffer->count && buffer->commands[cursors[next]].sort_key == next_key) {
+            if(!render_command_replay(renderer, buffer, buffer->commands + cursors[next], base_target, scale_x, scale_y))
+                result = SDL_FALSE;
+            cursors[next]++;
+        }
+    }
+
+    if(SDL_GetRenderTarget(renderer) != base_target) {
+        SDL_SetRenderTarget(renderer, base_target);
+        SDL_RenderSetScale(renderer, scale_x, scale_y);
+        SDL_RenderSetViewport(renderer, NULL);
+    }
+
+    if(cursors != cursors_stack)
+        su_free(cursors);
+
+    return result;
+}
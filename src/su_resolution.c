@@ -0,0 +1,119 @@
+#include <su_resolution.h>
+
+#include <su_metrics.h>
+
+// How much of the newest frame goes into the averages.
+#define RESOLUTION_SMOOTHING 0.1
+
+// How many cooldowns to wait before trying a scale that missed frames again.
+#define RESOLUTION_RETRY_COOLDOWNS 10
+
+// How far over the budget the time between frames can go before it counts as a missed frame.
+#define RESOLUTION_FRAME_TOLERANCE 1.05
+
+void resolution_controller_init(ResolutionController* controller, Camera* camera, double target_fps) {
+    controller->camera = camera;
+    controller->target_ms = target_fps > 0 ? 1000.0 / target_fps : 1000.0 / 60.0;
+    controller->min_scale = 0.5f;
+    controller->max_scale = 1;
+    controller->step = 0.1f;
+    controller->high_watermark = 0.9;
+    controller->low_watermark = 0.7;
+    controller->cooldown_frames = 30;
+    controller->cpu_ms = 0;
+    controller->frame_ms = 0;
+    controller->cooldown = 0;
+    controller->last_frame = 0;
+    controller->failed_scale = 2;
+    controller->retry = 0;
+}
+
+ResolutionController* resolution_controller_create(Camera* camera, double target_fps) {
+    ResolutionController* controller = su_malloc(sizeof(*controller));
+    if(controller == NULL) {
+        SDL_SetError("Could not create resolution controller, not enough memory.");
+        return NULL;
+    }
+
+    resolution_controller_init(controller, camera, target_fps);
+    return controller;
+}
+
+void resolution_controller_free(ResolutionController* controller) {
+    su_free(controller);
+}
+
+void resolution_controller_set_limits(ResolutionController* controller, float min_scale, float max_scale, float step) {
+    if(min_scale < CAMERA_MIN_RENDER_SCALE)
+        min_scale = CAMERA_MIN_RENDER_SCALE;
+    if(max_scale > 1)
+        max_scale = 1;
+    if(max_scale < min_scale)
+        max_scale = min_scale;
+
+    controller->min_scale = min_scale;
+    controller->max_scale = max_scale;
+    controller->step = step > 0 ? step : 0.1f;
+}
+
+void resolution_controller_reset(ResolutionController* controller) {
+    controller->cpu_ms = 0;
+    controller->frame_ms = 0;
+    controller->cooldown = 0;
+    controller->last_frame = 0;
+    controller->failed_scale = 2;
+    controller->retry = 0;
+}
+
+void resolution_controller_update(ResolutionController* controller, double cpu_ms) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 last = controller->last_frame;
+    controller->last_frame = now;
+
+    // The first frame has nothing to measure the time between frames against.
+    if(last == 0) {
+        controller->cpu_ms = cpu_ms;
+        controller->frame_ms = controller->target_ms;
+        return;
+    }
+
+    double frame_ms = (double)(now - last) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    controller->cpu_ms += (cpu_ms - controller->cpu_ms) * RESOLUTION_SMOOTHING;
+    controller->frame_ms += (frame_ms - controller->frame_ms) * RESOLUTION_SMOOTHING;
+
+    if(controller->retry > 0 && --controller->retry == 0)
+        controller->failed_scale = 2;
+
+    if(controller->cooldown > 0) {
+        controller->cooldown--;
+        return;
+    }
+
+    float scale = camera_get_render_scale(controller->camera);
+    float next = scale;
+    double budget = controller->target_ms;
+    SDL_bool missed = controller->frame_ms > budget * RESOLUTION_FRAME_TOLERANCE;
+
+    if(missed || controller->cpu_ms > budget * controller->high_watermark) {
+        next = scale - controller->step;
+        if(missed && scale < controller->failed_scale) {
+            controller->failed_scale = scale;
+            controller->retry = controller->cooldown_frames * RESOLUTION_RETRY_COOLDOWNS;
+        }
+    } else if(controller->cpu_ms < budget * controller->low_watermark) {
+        next = scale + controller->step;
+        if(next >= controller->failed_scale - 0.001f)
+            next = scale;
+    }
+
+    if(next < controller->min_scale)
+        next = controller->min_scale;
+    if(next > controller->max_scale)
+        next = controller->max_scale;
+
+    if(next != scale) {
+        camera_set_render_scale(controller->camera, next);
+        metrics_set(METRIC_CAMERA_RENDER_SCALE, camera_get_render_scale(controller->camera));
+        controller->cooldown = controller->cooldown_frames;
+    }
+}
@@ -1,5 +1,8 @@
 #include <su_scene.h>
 
+#include <su_latency.h>
+#include <su_metrics.h>
+
 struct SceneManager {
     Scene** scenes;
     int capacity;
@@ -8,6 +11,41 @@ struct SceneManager {
 
 static struct SceneManager scene_manager = { NULL, 0, 0 };
 
+static const char* scene_stage_names[SCENE_STAGE_COUNT] = {
+    "update",
+    "clear",
+    "draw",
+    "composite",
+    "gui",
+    "present"
+};
+
+typedef struct SceneBatchStep {
+    SceneBatch* batch;
+    float delta;
+    Uint32 milliseconds;
+    int steps;
+    SDL_atomic_t ticks;
+} SceneBatchStep;
+
+static inline Uint64 scene_stage_begin(void) {
+    return SDL_GetPerformanceCounter();
+}
+
+static inline Uint64 scene_stage_end(Scene* scene, SceneStage stage, Uint64 start) {
+    Uint64 end = SDL_GetPerformanceCounter();
+    double ms = (double)(end - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+
+    SceneStageStats* stats = scene->stats + stage;
+    stats->count++;
+    stats->last_ms = ms;
+    stats->total_ms += ms;
+    if(ms > stats->max_ms)
+        stats->max_ms = ms;
+
+    return end;
+}
+
 void scene_init(Scene* scene,
                 EcsWorld world, 
                 Camera* camera, 
@@ -19,15 +57,29 @@ void scene_init(Scene* scene,
 {
     scene->world = world;
     scene->camera = camera;
+    scene->parallax = NULL;
+    scene->text = NULL;
+    scene->animator = NULL;
+    scene->resolution = NULL;
+    scene->jobs = NULL;
+    scene->frame_arena = NULL;
+    scene->pool = NULL;
+    scene->random_seed = 0;
+    scene->random_seeded = SDL_FALSE;
+    random_seed(&scene->random, SDL_GetPerformanceCounter());
+    scheduler_init(&scene->scheduler);
     scene->update = update;
     scene->draw = draw;
     scene->gui = gui;
     scene->free_systems = free_systems;
     scene->free_camera = free_camera;
+    scene->free_world = SDL_TRUE;
+    scene->paused = SDL_FALSE;
     scene->r = 0;
     scene->g = 0;
     scene->b = 0;
     scene->a = 255;
+    scene_reset_stats(scene);
 }
 
 Scene* scene_create(EcsWorld world, 
@@ -46,20 +98,54 @@ Scene* scene_create(EcsWorld world,
     return scene;
 }
 
+static SDL_bool scene_pool_track(ScenePool* pool, Scene* scene) {
+    if(pool->acquired_count == pool->acquired_capacity) {
+        int capacity = pool->acquired_capacity == 0 ? 4 : pool->acquired_capacity * 2;
+        Scene** acquired = su_realloc(pool->acquired, sizeof(Scene*) * capacity);
+        if(acquired == NULL) {
+            SDL_SetError("Could not take scene from pool, not enough memory.");
+            return SDL_FALSE;
+        }
+
+        pool->acquired = acquired;
+        pool->acquired_capacity = capacity;
+    }
+
+    pool->acquired[pool->acquired_count++] = scene;
+    return SDL_TRUE;
+}
+
+static void scene_pool_untrack(ScenePool* pool, Scene* scene) {
+    for(int i = 0; i < pool->acquired_count; i++) {
+        if(pool->acquired[i] == scene) {
+            pool->acquired[i] = pool->acquired[--pool->acquired_count];
+            return;
+        }
+    }
+}
+
 void scene_free_resources(Scene* scene) {
     if(scene->free_systems) {
-        ecs_system_free_resources((EcsSystem*)scene->update);
-        ecs_system_free_resources((EcsSystem*)scene->draw);
-        ecs_system_free_resources((EcsSystem*)scene->gui);
-        free(scene->update);
-        free(scene->draw);
-        free(scene->gui);
-    }
-    if(scene->free_camera) {
+        // Headless scenes don't need draw or gui systems.
+        EcsSequentialSystem* systems[] = { scene->update, scene->draw, scene->gui };
+        for(int i = 0; i < 3; i++) {
+            if(systems[i] == NULL)
+                continue;
+            ecs_system_free_resources((EcsSystem*)systems[i]);
+            free(systems[i]);
+        }
+    }
+    if(scene->free_camera && scene->camera != NULL) {
         camera_free(scene->camera);
     }
 
-    ecs_world_free(scene->world);
+    scheduler_free_resources(&scene->scheduler);
+    if(scene->free_world)
+        ecs_world_free(scene->world);
+
+    // The pool can't detach the scene once it's gone.
+    if(scene->pool != NULL)
+        scene_pool_untrack(scene->pool, scene);
 }
 
 void scene_free(Scene* scene) {
@@ -68,26 +154,98 @@ void scene_free(Scene* scene) {
 }
 
 void scene_update(Scene* scene, float delta) {
-    ecs_system_update((EcsSystem*)scene->update, delta);
+    // Work sent to the main thread, like texture uploads, keeps flowing while paused.
+    if(scene->jobs != NULL)
+        job_system_run_main_jobs(scene->jobs);
+
+    if(scene->paused)
+        return;
+
+    Uint64 start = scene_stage_begin();
+
+    scheduler_update(&scene->scheduler);
+    if(scene->animator != NULL)
+        animator_update(scene->animator, delta);
+    if(scene->update != NULL)
+        ecs_system_update((EcsSystem*)scene->update, delta);
+    latency_updated();
+
+    scene_stage_end(scene, SCENE_STAGE_UPDATE, start);
+    metrics_time_end(METRIC_SCENE_UPDATE_MS, start);
+
+    // Headless scenes never reach the reset at the end of scene_draw.
+    if(scene->camera == NULL && scene->frame_arena != NULL)
+        frame_arena_reset(scene->frame_arena);
+}
+
+void scene_update_fixed(Scene* scene, float delta, Uint32 milliseconds) {
+    if(scene->paused)
+        return;
+
+    Uint64 start = scene_stage_begin();
+
+    scheduler_advance(&scene->scheduler, milliseconds);
+    if(scene->animator != NULL)
+        animator_update(scene->animator, delta);
+    if(scene->update != NULL)
+        ecs_system_update((EcsSystem*)scene->update, delta);
+
+    scene_stage_end(scene, SCENE_STAGE_UPDATE, start);
+
+    if(scene->camera == NULL && scene->frame_arena != NULL)
+        frame_arena_reset(scene->frame_arena);
+}
+
+void scene_pause(Scene* scene) {
+    scene->paused = SDL_TRUE;
+    scheduler_pause(&scene->scheduler);
+}
+
+void scene_resume(Scene* scene) {
+    scene->paused = SDL_FALSE;
+    scheduler_resume(&scene->scheduler);
 }
 
 void scene_draw(Scene* scene, float delta) {
     // TODO: Add error handling
 
+    if(scene->camera == NULL)
+        return;
+
+    Uint64 start = scene_stage_begin();
+    Uint64 frame_start = start;
+
     Texture* render_target = camera_get_render_target(scene->camera);
     SDL_SetRenderTarget(scene->camera->renderer, render_target);
+
+    // Draw into the top left of the target at the render scale. Setting the render target
+    // resets the scale, and going back to the window restores the window's scale.
+    float render_scale = camera_get_render_scale(scene->camera);
+    if(render_scale != 1)
+        SDL_RenderSetScale(scene->camera->renderer, render_scale, render_scale);
+
     SDL_SetRenderDrawColor(scene->camera->renderer, scene->r, scene->g, scene->b, scene->a);
     SDL_RenderClear(scene->camera->renderer);
     SDL_RenderSetViewport(scene->camera->renderer, NULL);
+    metrics_add(METRIC_SCENE_RENDER_CLEARS, 1);
+
+    start = scene_stage_end(scene, SCENE_STAGE_CLEAR, start);
+
+    if(scene->parallax != NULL)
+        parallax_draw(scene->parallax, scene->camera);
 
-    ecs_system_update((EcsSystem*)scene->draw, delta);
+    if(scene->draw != NULL)
+        ecs_system_update((EcsSystem*)scene->draw, delta);
+
+    start = scene_stage_end(scene, SCENE_STAGE_DRAW, start);
 
     SDL_SetRenderTarget(scene->camera->renderer, NULL);
     SDL_SetRenderDrawColor(scene->camera->renderer, scene->r, scene->g, scene->b, scene->a);
     SDL_RenderClear(scene->camera->renderer);
     SDL_RenderSetViewport(scene->camera->renderer, scene->camera->viewport);
+    metrics_add(METRIC_SCENE_RENDER_CLEARS, 1);
 
-    Point size = camera_get_size(scene->camera);
+    Point size = camera_get_render_size(scene->camera);
 
     SDL_RenderCopyEx(scene->camera->renderer, 
                      render_target, 
@@ -96,14 +254,91 @@ void scene_draw(Scene* scene, float delta) {
                      camera_get_rotation(scene->camera), 
                      NULL, 
                      SDL_FLIP_NONE);
+    metrics_add(METRIC_SCENE_RENDER_COPIES, 1);
+
+    start = scene_stage_end(scene, SCENE_STAGE_COMPOSITE, start);
+
+    if(scene->gui != NULL)
+        ecs_system_update((EcsSystem*)scene->gui, delta);
+
+    if(scene->text != NULL)
+        text_renderer_flush(scene->text);
 
-    ecs_system_update((EcsSystem*)scene->gui, delta);
+    start = scene_stage_end(scene, SCENE_STAGE_GUI, start);
 
     SDL_RenderPresent(scene->camera->renderer);
+    latency_presented();
+
+    scene_stage_end(scene, SCENE_STAGE_PRESENT, start);
+    metrics_time_end(METRIC_SCENE_DRAW_MS, frame_start);
+
+    if(scene->resolution != NULL) {
+        // Presenting is left out since it includes waiting for vsync.
+        double cpu_ms = 0;
+        for(int i = SCENE_STAGE_UPDATE; i < SCENE_STAGE_PRESENT; i++)
+            cpu_ms += scene->stats[i].last_ms;
+
+        resolution_controller_update(scene->resolution, cpu_ms);
+    }
+    metrics_update();
+
+    if(scene->frame_arena != NULL)
+        frame_arena_reset(scene->frame_arena);
+}
+
+void scene_reset_stats(Scene* scene) {
+    SDL_memset(scene->stats, 0, sizeof(scene->stats));
+    scene->stats_start = SDL_GetPerformanceCounter();
+}
+
+const char* scene_stage_name(SceneStage stage) {
+    if(stage < 0 || stage >= SCENE_STAGE_COUNT)
+        return NULL;
+    return scene_stage_names[stage];
+}
+
+SDL_bool scene_write_stats(Scene* scene, SDL_RWops* output) {
+    double elapsed = (double)(SDL_GetPerformanceCounter() - scene->stats_start) / (double)SDL_GetPerformanceFrequency();
+    Uint64 frames = scene->stats[SCENE_STAGE_PRESENT].count;
+    double fps = elapsed > 0 ? (double)frames / elapsed : 0;
+
+    char buffer[1024];
+    int length = SDL_snprintf(buffer, sizeof(buffer), "{\"frames\":%llu,\"seconds\":%.6f,\"fps\":%.3f,\"stages\":{",
+                              (unsigned long long)frames, elapsed, fps);
+
+    for(int i = 0; i < SCENE_STAGE_COUNT && length < (int)sizeof(buffer); i++) {
+        SceneStageStats* stats = scene->stats + i;
+        double average = stats->count > 0 ? stats->total_ms / (double)stats->count : 0;
+        length += SDL_snprintf(buffer + length, sizeof(buffer) - length,
+                               "%s\"%s\":{\"count\":%llu,\"last_ms\":%.6f,\"avg_ms\":%.6f,\"max_ms\":%.6f}",
+                               i == 0 ? "" : ",",
+                               scene_stage_names[i],
+                               (unsigned long long)stats->count,
+                               stats->last_ms,
+                               average,
+                               stats->max_ms);
+    }
+
+    if(length >= (int)sizeof(buffer) - 3) {
+        SDL_SetError("Could not write scene stats, buffer too small.");
+        return SDL_FALSE;
+    }
+
+    length += SDL_snprintf(buffer + length, sizeof(buffer) - length, "}}\n");
+
+    if(SDL_RWwrite(output, buffer, length, 1) != 1)
+        return SDL_FALSE;
+
+    return SDL_TRUE;
+}
+
+static Uint32 scene_pixel_format(Scene* scene) {
+    // Headless scenes still keep a background so they can be given a camera later.
+    return scene->camera != NULL ? scene->camera->pixel_format : SDL_PIXELFORMAT_RGBA8888;
 }
 
 SDL_bool scene_set_background(Scene* scene, Uint32 color) {
-    SDL_PixelFormat* format = SDL_AllocFormat(scene->camera->pixel_format);
+    SDL_PixelFormat* format = SDL_AllocFormat(scene_pixel_format(scene));
     if(format == NULL)
         return SDL_FALSE;
 
@@ -114,7 +349,7 @@ SDL_bool scene_set_background(Scene* scene, Uint32 color) {
 }
 
 Uint32 scene_get_background(Scene* scene) {
-    SDL_PixelFormat* format = SDL_AllocFormat(scene->camera->pixel_format);
+    SDL_PixelFormat* format = SDL_AllocFormat(scene_pixel_format(scene));
     if(format == NULL)
         return 0;
 
@@ -127,6 +362,8 @@ Uint32 scene_get_background(Scene* scene) {
 void scene_push(Scene* scene) {
     ECS_ARRAY_RESIZE(scene_manager.scenes, scene_manager.capacity, scene_manager.count+1, sizeof(Scene));
     scene_manager.scenes[scene_manager.count++] = scene;
+    metrics_add(METRIC_SCENE_PUSHES, 1);
+    metrics_set(METRIC_SCENE_DEPTH, scene_manager.count);
 }
 
 void scene_change(Scene* scene) {
@@ -138,8 +375,14 @@ void scene_change(Scene* scene) {
 
 Scene* scene_pop(bool free_scene) {
     Scene* scene = scene_manager.scenes[--scene_manager.count];
-    if(free_scene)
-        scene_free(scene);
+    metrics_add(METRIC_SCENE_POPS, 1);
+    metrics_set(METRIC_SCENE_DEPTH, scene_manager.count);
+    if(free_scene) {
+        if(scene->pool != NULL)
+            scene_pool_release(scene->pool, scene);
+        else
+            scene_free(scene);
+    }
     return scene;
 }
 
@@ -147,4 +390,219 @@ Scene* scene_current(void) {
     if(scene_manager.count == 0)
         return NULL;
     return scene_manager.scenes[scene_manager.count - 1];
-}
\ No newline at end of file
+}
+
+void scene_pool_init(ScenePool* pool, ScenePoolCreateFn create, ScenePoolResetFn reset, void* data) {
+    pool->scenes = NULL;
+    pool->count = 0;
+    pool->capacity = 0;
+    pool->acquired = NULL;
+    pool->acquired_count = 0;
+    pool->acquired_capacity = 0;
+    pool->create = create;
+    pool->reset = reset;
+    pool->data = data;
+}
+
+ScenePool* scene_pool_create(ScenePoolCreateFn create, ScenePoolResetFn reset, void* data) {
+    ScenePool* pool = su_malloc(sizeof(*pool));
+    if(pool == NULL) {
+        SDL_SetError("Could not create scene pool, not enough memory.");
+        return NULL;
+    }
+
+    scene_pool_init(pool, create, reset, data);
+    return pool;
+}
+
+void scene_pool_free_resources(ScenePool* pool) {
+    // Scenes that are still in use can't return to a pool that's gone.
+    for(int i = 0; i < pool->acquired_count; i++)
+        pool->acquired[i]->pool = NULL;
+
+    su_free(pool->acquired);
+    pool->acquired = NULL;
+    pool->acquired_count = 0;
+    pool->acquired_capacity = 0;
+
+    for(int i = 0; i < pool->count; i++) {
+        pool->scenes[i]->pool = NULL;
+        scene_free(pool->scenes[i]);
+    }
+
+    su_free(pool->scenes);
+    pool->scenes = NULL;
+    pool->count = 0;
+    pool->capacity = 0;
+}
+
+void scene_pool_free(ScenePool* pool) {
+    scene_pool_free_resources(pool);
+    su_free(pool);
+}
+
+Scene* scene_pool_acquire(ScenePool* pool) {
+    Scene* scene;
+    if(pool->count > 0) {
+        scene = pool->scenes[pool->count - 1];
+    } else {
+        if(pool->create == NULL)
+            return NULL;
+
+        scene = pool->create(pool->data);
+        if(scene == NULL)
+            return NULL;
+    }
+
+    if(!scene_pool_track(pool, scene)) {
+        if(pool->count == 0)
+            scene_free(scene);
+        return NULL;
+    }
+
+    if(pool->count > 0)
+        pool->count--;
+
+    scene->pool = pool;
+    return scene;
+}
+
+SDL_bool scene_pool_release(ScenePool* pool, Scene* scene) {
+    if(scene->pool != NULL) {
+        scene_pool_untrack(scene->pool, scene);
+        scene->pool = NULL;
+    }
+
+    if(pool->count == pool->capacity) {
+        int capacity = pool->capacity == 0 ? 4 : pool->capacity * 2;
+        Scene** scenes = su_realloc(pool->scenes, sizeof(Scene*) * capacity);
+        if(scenes == NULL) {
+            scene_free(scene);
+            SDL_SetError("Could not add scene to pool, not enough memory.");
+            return SDL_FALSE;
+        }
+
+        pool->scenes = scenes;
+        pool->capacity = capacity;
+    }
+
+    // Keep the storage and attachments of the scene, but reset the state
+    // that changes while it runs.
+    scheduler_clear(&scene->scheduler);
+    random_seed(&scene->random, scene->random_seeded ? scene->random_seed : SDL_GetPerformanceCounter());
+    scene->paused = SDL_FALSE;
+    scene_reset_stats(scene);
+
+    if(scene->camera != NULL) {
+        camera_set_position(scene->camera, (Point){ 0, 0 });
+        camera_set_rotation(scene->camera, 0);
+        camera_set_render_scale(scene->camera, 1);
+    }
+
+    if(scene->resolution != NULL)
+        resolution_controller_reset(scene->resolution);
+
+    if(pool->reset != NULL && !pool->reset(scene, pool->data)) {
+        scene_free(scene);
+        return SDL_FALSE;
+    }
+
+    scene->pool = pool;
+    pool->scenes[pool->count++] = scene;
+    return SDL_TRUE;
+}
+
+void scene_batch_init(SceneBatch* batch, JobSystem* jobs) {
+    batch->scenes = NULL;
+    batch->count = 0;
+    batch->capacity = 0;
+    batch->jobs = jobs;
+    batch->ticks = 0;
+    batch->seconds = 0;
+}
+
+SceneBatch* scene_batch_create(JobSystem* jobs) {
+    SceneBatch* batch = su_malloc(sizeof(*batch));
+    if(batch == NULL) {
+        SDL_SetError("Could not create scene batch, not enough memory.");
+        return NULL;
+    }
+
+    scene_batch_init(batch, jobs);
+    return batch;
+}
+
+void scene_batch_free_resources(SceneBatch* batch) {
+    su_free(batch->scenes);
+    batch->scenes = NULL;
+    batch->count = 0;
+    batch->capacity = 0;
+}
+
+void scene_batch_free(SceneBatch* batch) {
+    scene_batch_free_resources(batch);
+    su_free(batch);
+}
+
+SDL_bool scene_batch_add(SceneBatch* batch, Scene* scene) {
+    if(batch->count == batch->capacity) {
+        int capacity = batch->capacity == 0 ? 16 : batch->capacity * 2;
+        Scene** scenes = su_realloc(batch->scenes, sizeof(Scene*) * capacity);
+        if(scenes == NULL) {
+            SDL_SetError("Could not add scene to batch, not enough memory.");
+            return SDL_FALSE;
+        }
+
+        batch->scenes = scenes;
+        batch->capacity = capacity;
+    }
+
+    batch->scenes[batch->count++] = scene;
+    return SDL_TRUE;
+}
+
+SDL_bool scene_batch_remove(SceneBatch* batch, Scene* scene) {
+    for(int i = 0; i < batch->count; i++) {
+        if(batch->scenes[i] == scene) {
+            batch->scenes[i] = batch->scenes[--batch->count];
+            return SDL_TRUE;
+        }
+    }
+
+    return SDL_FALSE;
+}
+
+static void scene_batch_step_range(int start, int end, void* data) {
+    SceneBatchStep* step = data;
+    int ticks = 0;
+
+    // Run every step of a scene before moving on so its world stays in the cache.
+    // Paused scenes don't update, including ones that pause themselves partway through.
+    for(int i = start; i < end; i++) {
+        Scene* scene = step->batch->scenes[i];
+        for(int j = 0; j < step->steps && !scene->paused; j++) {
+            scene_update_fixed(scene, step->delta, step->milliseconds);
+            ticks++;
+        }
+    }
+
+    SDL_AtomicAdd(&step->ticks, ticks);
+}
+
+void scene_batch_run(SceneBatch* batch, float delta, Uint32 milliseconds, int steps) {
+    if(batch->count == 0 || steps <= 0)
+        return;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    SceneBatchStep step = { batch, delta, milliseconds, steps, { 0 } };
+
+    if(batch->jobs != NULL)
+        job_parallel_for(batch->jobs, batch->count, 1, scene_batch_step_range, &step);
+    else
+        scene_batch_step_range(0, batch->count, &step);
+
+    // Each worker counts the updates it actually ran, so scenes paused or resumed
+    // during the run are counted correctly.
+    batch->ticks += (Uint64)(Uint32)SDL_AtomicGet(&step.ticks);
+    batch->seconds += (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+}
@@ -0,0 +1,290 @@
+#include <su_scheduler.h>
+
+// Special slot values for entries that aren't in the wheel.
+#define SCHEDULER_SLOT_FREE -1
+#define SCHEDULER_SLOT_FIRING -2
+
+#define SCHEDULER_SLOT_MASK (SCHEDULER_SLOTS - 1)
+
+static inline ScheduleHandle scheduler_make_handle(int index, Uint32 generation) {
+    return ((ScheduleHandle)generation << 32) | (Uint32)index;
+}
+
+static SchedulerEntry* scheduler_get_entry(Scheduler* scheduler, ScheduleHandle handle) {
+    Uint32 index = (Uint32)handle;
+    Uint32 generation = (Uint32)(handle >> 32);
+
+    if(index >= (Uint32)scheduler->entry_count)
+        return NULL;
+
+    SchedulerEntry* entry = scheduler->entries + index;
+    if(entry->generation != generation || entry->slot == SCHEDULER_SLOT_FREE)
+        return NULL;
+
+    return entry;
+}
+
+static void scheduler_link(Scheduler* scheduler, int index) {
+    SchedulerEntry* entry = scheduler->entries + index;
+    Uint64 delta = entry->deadline - scheduler->now;
+
+    // Find the lowest level whose range covers the deadline. The slot is taken
+    // from the absolute deadline so it lines up with the cascades in scheduler_advance.
+    int level = 0;
+    while(level < SCHEDULER_LEVELS - 1 && delta >= ((Uint64)1 << (SCHEDULER_SLOT_BITS * (level + 1))))
+        level++;
+
+    int slot = level * SCHEDULER_SLOTS + (int)((entry->deadline >> (SCHEDULER_SLOT_BITS * level)) & SCHEDULER_SLOT_MASK);
+
+    entry->slot = slot;
+    entry->prev = -1;
+    entry->next = scheduler->wheel[slot];
+    if(entry->next != -1)
+        scheduler->entries[entry->next].prev = index;
+    scheduler->wheel[slot] = index;
+}
+
+static void scheduler_unlink(Scheduler* scheduler, int index) {
+    SchedulerEntry* entry = scheduler->entries + index;
+
+    if(entry->prev != -1)
+        scheduler->entries[entry->prev].next = entry->next;
+    else
+        scheduler->wheel[entry->slot] = entry->next;
+
+    if(entry->next != -1)
+        scheduler->entries[entry->next].prev = entry->prev;
+}
+
+static void scheduler_release(Scheduler* scheduler, int index) {
+    SchedulerEntry* entry = scheduler->entries + index;
+
+    // Invalidate any outstanding handles.
+    if(++entry->generation == 0)
+        entry->generation = 1;
+
+    entry->slot = SCHEDULER_SLOT_FREE;
+    entry->next = scheduler->free_list;
+    scheduler->free_list = index;
+    scheduler->active--;
+}
+
+void scheduler_init(Scheduler* scheduler) {
+    scheduler->entries = NULL;
+    scheduler->entry_count = 0;
+    scheduler->entry_capacity = 0;
+    scheduler->free_list = -1;
+    scheduler->active = 0;
+    scheduler->now = 0;
+    scheduler->last_ticks = 0;
+
+    for(int i = 0; i < SCHEDULER_LEVELS * SCHEDULER_SLOTS; i++)
+        scheduler->wheel[i] = -1;
+
+    timer_init(&scheduler->clock);
+    timer_start(&scheduler->clock);
+}
+
+Scheduler* scheduler_create(void) {
+    Scheduler* scheduler = su_malloc(sizeof(*scheduler));
+    if(scheduler == NULL)
+        return NULL;
+
+    scheduler_init(scheduler);
+    return scheduler;
+}
+
+void scheduler_clear(Scheduler* scheduler) {
+    // Chain every entry into the free list in order, invalidating the handles of the active ones.
+    for(int i = scheduler->entry_count - 1; i >= 0; i--) {
+        SchedulerEntry* entry = scheduler->entries + i;
+        if(entry->slot != SCHEDULER_SLOT_FREE && ++entry->generation == 0)
+            entry->generation = 1;
+
+        entry->slot = SCHEDULER_SLOT_FREE;
+        entry->next = i + 1 < scheduler->entry_count ? i + 1 : -1;
+    }
+
+    scheduler->free_list = scheduler->entry_count > 0 ? 0 : -1;
+    scheduler->active = 0;
+    scheduler->now = 0;
+    scheduler->last_ticks = 0;
+
+    for(int i = 0; i < SCHEDULER_LEVELS * SCHEDULER_SLOTS; i++)
+        scheduler->wheel[i] = -1;
+
+    timer_init(&scheduler->clock);
+    timer_start(&scheduler->clock);
+}
+
+void scheduler_free_resources(Scheduler* scheduler) {
+    su_free(scheduler->entries);
+    scheduler_init(scheduler);
+}
+
+void scheduler_free(Scheduler* scheduler) {
+    scheduler_free_resources(scheduler);
+    su_free(scheduler);
+}
+
+static ScheduleHandle scheduler_add_entry(Scheduler* scheduler,
+                                          Uint32 delay,
+                                          Uint32 period,
+                                          ScheduleFn callback,
+                                          Uint32 event_type,
+                                          void* data)
+{
+    int index = scheduler->free_list;
+
+    if(index != -1) {
+        scheduler->free_list = scheduler->entries[index].next;
+    } else {
+        if(scheduler->entry_count == scheduler->entry_capacity) {
+            int capacity = scheduler->entry_capacity == 0 ? 64 : scheduler->entry_capacity * 2;
+            SchedulerEntry* entries = su_realloc(scheduler->entries, sizeof(SchedulerEntry) * capacity);
+            if(entries == NULL) {
+                SDL_SetError("Could not schedule timer, not enough memory.");
+                return SCHEDULE_HANDLE_INVALID;
+            }
+            scheduler->entries = entries;
+            scheduler->entry_capacity = capacity;
+        }
+
+        index = scheduler->entry_count++;
+        scheduler->entries[index].generation = 1;
+    }
+
+    SchedulerEntry* entry = scheduler->entries + index;
+
+    // The current tick has already been processed, so the earliest a timer can fire is the next one.
+    entry->deadline = scheduler->now + (delay == 0 ? 1 : delay);
+    entry->period = period;
+    entry->callback = callback;
+    entry->event_type = event_type;
+    entry->data = data;
+
+    scheduler_link(scheduler, index);
+    scheduler->active++;
+
+    return scheduler_make_handle(index, entry->generation);
+}
+
+ScheduleHandle scheduler_add(Scheduler* scheduler, Uint32 delay, Uint32 period, ScheduleFn callback, void* data) {
+    return scheduler_add_entry(scheduler, delay, period, callback, 0, data);
+}
+
+ScheduleHandle scheduler_add_event(Scheduler* scheduler, Uint32 delay, Uint32 period, Uint32 event_type, void* data) {
+    return scheduler_add_entry(scheduler, delay, period, NULL, event_type, data);
+}
+
+SDL_bool scheduler_cancel(Scheduler* scheduler, ScheduleHandle handle) {
+    SchedulerEntry* entry = scheduler_get_entry(scheduler, handle);
+    if(entry == NULL)
+        return SDL_FALSE;
+
+    int index = (int)(entry - scheduler->entries);
+
+    if(entry->slot == SCHEDULER_SLOT_FIRING) {
+        // Cancelled from inside its own callback. Clearing the period
+        // stops it from being rescheduled once the callback returns.
+        if(entry->period == 0)
+            return SDL_FALSE;
+        entry->period = 0;
+        return SDL_TRUE;
+    }
+
+    scheduler_unlink(scheduler, index);
+    scheduler_release(scheduler, index);
+    return SDL_TRUE;
+}
+
+SDL_bool scheduler_is_scheduled(Scheduler* scheduler, ScheduleHandle handle) {
+    SchedulerEntry* entry = scheduler_get_entry(scheduler, handle);
+    return entry != NULL && entry->slot >= 0;
+}
+
+Uint32 scheduler_get_remaining(Scheduler* scheduler, ScheduleHandle handle) {
+    SchedulerEntry* entry = scheduler_get_entry(scheduler, handle);
+    if(entry == NULL || entry->slot < 0)
+        return 0;
+
+    return (Uint32)(entry->deadline - scheduler->now);
+}
+
+static void scheduler_fire(Scheduler* scheduler, int index) {
+    SchedulerEntry* entry = scheduler->entries + index;
+    ScheduleHandle handle = scheduler_make_handle(index, entry->generation);
+
+    scheduler_unlink(scheduler, index);
+    entry->slot = SCHEDULER_SLOT_FIRING;
+
+    if(entry->callback != NULL) {
+        entry->callback(scheduler, handle, entry->data);
+
+        // The callback can add timers, which may move the entries.
+        entry = scheduler->entries + index;
+    } else {
+        SDL_Event event;
+        SDL_zero(event);
+        event.type = entry->event_type;
+        event.user.timestamp = SDL_GetTicks();
+        event.user.data1 = entry->data;
+        SDL_PushEvent(&event);
+    }
+
+    if(entry->period != 0) {
+        entry->deadline += entry->period;
+        scheduler_link(scheduler, index);
+    } else {
+        scheduler_release(scheduler, index);
+    }
+}
+
+static void scheduler_cascade(Scheduler* scheduler, int level) {
+    int slot = level * SCHEDULER_SLOTS + (int)((scheduler->now >> (SCHEDULER_SLOT_BITS * level)) & SCHEDULER_SLOT_MASK);
+    int index = scheduler->wheel[slot];
+    scheduler->wheel[slot] = -1;
+
+    // Every entry in the slot is now within range of a lower level.
+    while(index != -1) {
+        int next = scheduler->entries[index].next;
+        scheduler_link(scheduler, index);
+        index = next;
+    }
+}
+
+void scheduler_advance(Scheduler* scheduler, Uint32 milliseconds) {
+    while(milliseconds > 0) {
+        // Nothing can fire, so skip ahead. Timers are always placed
+        // relative to the current time, so the wheel stays consistent.
+        if(scheduler->active == 0) {
+            scheduler->now += milliseconds;
+            return;
+        }
+
+        scheduler->now++;
+        milliseconds--;
+
+        int slot = (int)(scheduler->now & SCHEDULER_SLOT_MASK);
+
+        // Each time a level wraps around, move the next slot of the level above down.
+        if(slot == 0) {
+            for(int level = 1; level < SCHEDULER_LEVELS; level++) {
+                scheduler_cascade(scheduler, level);
+                if(((scheduler->now >> (SCHEDULER_SLOT_BITS * level)) & SCHEDULER_SLOT_MASK) != 0)
+                    break;
+            }
+        }
+
+        while(scheduler->wheel[slot] != -1)
+            scheduler_fire(scheduler, scheduler->wheel[slot]);
+    }
+}
+
+void scheduler_update(Scheduler* scheduler) {
+    Uint32 ticks = timer_ticks(&scheduler->clock);
+    Uint32 elapsed = ticks - scheduler->last_ticks;
+    scheduler->last_ticks = ticks;
+
+    scheduler_advance(scheduler, elapsed);
+}
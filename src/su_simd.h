@@ -0,0 +1,139 @@
+#ifndef SDL_UTILS_SIMD_H
+#define SDL_UTILS_SIMD_H
+
+/**
+    \file A thin wrapper over the 4-wide float instructions of the target,
+          used internally by the batch kernels. The path is selected at compile
+          time. When SU_SIMD is not defined, the kernels only run their scalar loops.
+
+          Define SDL_UTILS_NO_SIMD to force the scalar fallback.
+*/
+
+#if !defined(SDL_UTILS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+
+#define SU_SIMD
+#define SU_SIMD_SSE2
+#include <emmintrin.h>
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define SU_SIMD_SSE41
+#include <smmintrin.h>
+#endif
+
+typedef __m128 simd_float4;
+typedef __m128 simd_mask4;
+typedef __m128i simd_int4;
+
+static inline simd_float4 simd_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void simd_store(float* p, simd_float4 v) { _mm_storeu_ps(p, v); }
+static inline simd_float4 simd_set1(float value) { return _mm_set1_ps(value); }
+static inline simd_float4 simd_add(simd_float4 a, simd_float4 b) { return _mm_add_ps(a, b); }
+static inline simd_float4 simd_sub(simd_float4 a, simd_float4 b) { return _mm_sub_ps(a, b); }
+static inline simd_float4 simd_mul(simd_float4 a, simd_float4 b) { return _mm_mul_ps(a, b); }
+static inline simd_float4 simd_div(simd_float4 a, simd_float4 b) { return _mm_div_ps(a, b); }
+static inline simd_float4 simd_sqrt(simd_float4 a) { return _mm_sqrt_ps(a); }
+static inline simd_float4 simd_min(simd_float4 a, simd_float4 b) { return _mm_min_ps(a, b); }
+static inline simd_float4 simd_max(simd_float4 a, simd_float4 b) { return _mm_max_ps(a, b); }
+static inline simd_mask4 simd_cmplt(simd_float4 a, simd_float4 b) { return _mm_cmplt_ps(a, b); }
+static inline simd_mask4 simd_cmple(simd_float4 a, simd_float4 b) { return _mm_cmple_ps(a, b); }
+static inline simd_mask4 simd_cmpgt(simd_float4 a, simd_float4 b) { return _mm_cmpgt_ps(a, b); }
+static inline simd_mask4 simd_cmpge(simd_float4 a, simd_float4 b) { return _mm_cmpge_ps(a, b); }
+static inline simd_float4 simd_select(simd_mask4 mask, simd_float4 a, simd_float4 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+static inline int simd_any(simd_mask4 mask) { return _mm_movemask_ps(mask) != 0; }
+static inline simd_int4 simd_convert_trunc(simd_float4 a) { return _mm_cvttps_epi32(a); }
+static inline simd_float4 simd_convert_float(simd_int4 a) { return _mm_cvtepi32_ps(a); }
+static inline void simd_store_int(int* p, simd_int4 v) { _mm_storeu_si128((__m128i*)p, v); }
+
+#ifdef SU_SIMD_SSE41
+static inline simd_float4 simd_trunc(simd_float4 a) { return _mm_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+static inline simd_float4 simd_floor(simd_float4 a) { return _mm_round_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+static inline simd_float4 simd_ceil(simd_float4 a) { return _mm_round_ps(a, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC); }
+#else
+// Only valid while the values fit in an int, which covers every float with a fraction.
+static inline simd_float4 simd_trunc(simd_float4 a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a)); }
+static inline simd_float4 simd_floor(simd_float4 a) {
+    simd_float4 t = simd_trunc(a);
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1)));
+}
+static inline simd_float4 simd_ceil(simd_float4 a) {
+    simd_float4 t = simd_trunc(a);
+    return _mm_add_ps(t, _mm_and_ps(_mm_cmplt_ps(t, a), _mm_set1_ps(1)));
+}
+#endif
+
+#elif !defined(SDL_UTILS_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+
+#define SU_SIMD
+#define SU_SIMD_NEON
+#include <arm_neon.h>
+
+typedef float32x4_t simd_float4;
+typedef uint32x4_t simd_mask4;
+typedef int32x4_t simd_int4;
+
+static inline simd_float4 simd_load(const float* p) { return vld1q_f32(p); }
+static inline void simd_store(float* p, simd_float4 v) { vst1q_f32(p, v); }
+static inline simd_float4 simd_set1(float value) { return vdupq_n_f32(value); }
+static inline simd_float4 simd_add(simd_float4 a, simd_float4 b) { return vaddq_f32(a, b); }
+static inline simd_float4 simd_sub(simd_float4 a, simd_float4 b) { return vsubq_f32(a, b); }
+static inline simd_float4 simd_mul(simd_float4 a, simd_float4 b) { return vmulq_f32(a, b); }
+static inline simd_float4 simd_min(simd_float4 a, simd_float4 b) { return vminq_f32(a, b); }
+static inline simd_float4 simd_max(simd_float4 a, simd_float4 b) { return vmaxq_f32(a, b); }
+static inline simd_mask4 simd_cmplt(simd_float4 a, simd_float4 b) { return vcltq_f32(a, b); }
+static inline simd_mask4 simd_cmple(simd_float4 a, simd_float4 b) { return vcleq_f32(a, b); }
+static inline simd_mask4 simd_cmpgt(simd_float4 a, simd_float4 b) { return vcgtq_f32(a, b); }
+static inline simd_mask4 simd_cmpge(simd_float4 a, simd_float4 b) { return vcgeq_f32(a, b); }
+static inline simd_float4 simd_select(simd_mask4 mask, simd_float4 a, simd_float4 b) { return vbslq_f32(mask, a, b); }
+static inline simd_int4 simd_convert_trunc(simd_float4 a) { return vcvtq_s32_f32(a); }
+static inline simd_float4 simd_convert_float(simd_int4 a) { return vcvtq_f32_s32(a); }
+static inline void simd_store_int(int* p, simd_int4 v) { vst1q_s32(p, v); }
+
+#if defined(__aarch64__)
+static inline simd_float4 simd_trunc(simd_float4 a) { return vrndq_f32(a); }
+static inline simd_float4 simd_floor(simd_float4 a) { return vrndmq_f32(a); }
+static inline simd_float4 simd_ceil(simd_float4 a) { return vrndpq_f32(a); }
+static inline simd_float4 simd_div(simd_float4 a, simd_float4 b) { return vdivq_f32(a, b); }
+static inline simd_float4 simd_sqrt(simd_float4 a) { return vsqrtq_f32(a); }
+static inline int simd_any(simd_mask4 mask) { return vmaxvq_u32(mask) != 0; }
+#else
+// Only valid while the values fit in an int, which covers every float with a fraction.
+static inline simd_float4 simd_trunc(simd_float4 a) { return vcvtq_f32_s32(vcvtq_s32_f32(a)); }
+static inline simd_float4 simd_floor(simd_float4 a) {
+    simd_float4 t = simd_trunc(a);
+    return vbslq_f32(vcgtq_f32(t, a), vsubq_f32(t, vdupq_n_f32(1)), t);
+}
+static inline simd_float4 simd_ceil(simd_float4 a) {
+    simd_float4 t = simd_trunc(a);
+    return vbslq_f32(vcltq_f32(t, a), vaddq_f32(t, vdupq_n_f32(1)), t);
+}
+
+// ARMv7 has no vector divide or square root, so refine the hardware
+// estimates with two Newton-Raphson steps.
+static inline simd_float4 simd_div(simd_float4 a, simd_float4 b) {
+    simd_float4 reciprocal = vrecpeq_f32(b);
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    return vmulq_f32(a, reciprocal);
+}
+
+static inline simd_float4 simd_sqrt(simd_float4 a) {
+    simd_float4 estimate = vrsqrteq_f32(a);
+    estimate = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, estimate), estimate), estimate);
+    estimate = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, estimate), estimate), estimate);
+    // sqrt(0) would be 0 * inf, so mask zero lanes out.
+    return vbslq_f32(vceqq_f32(a, vdupq_n_f32(0)), a, vmulq_f32(a, estimate));
+}
+
+static inline int simd_any(simd_mask4 mask) {
+    uint32x2_t folded = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+    return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+}
+#endif
+
+#endif
+
+#define SU_SIMD_WIDTH 4
+
+#endif
@@ -0,0 +1,647 @@
+#include <su_text.h>
+
+#define TEXT_INITIAL_BUCKETS 64
+#define TEXT_REPLACEMENT_CHARACTER 0xFFFD
+
+static int font_glyph_compare(const void* left, const void* right) {
+    const FontGlyph* a = left;
+    const FontGlyph* b = right;
+    if(a->codepoint != b->codepoint)
+        return a->codepoint < b->codepoint ? -1 : 1;
+    return 0;
+}
+
+static Uint32 text_next_codepoint(const char** string, const char* end) {
+    const Uint8* s = (const Uint8*)*string;
+    Uint32 codepoint;
+    int extra;
+
+    if(s[0] < 0x80) {
+        *string += 1;
+        return s[0];
+    } else if((s[0] & 0xE0) == 0xC0) {
+        codepoint = s[0] & 0x1F;
+        extra = 1;
+    } else if((s[0] & 0xF0) == 0xE0) {
+        codepoint = s[0] & 0x0F;
+        extra = 2;
+    } else if((s[0] & 0xF8) == 0xF0) {
+        codepoint = s[0] & 0x07;
+        extra = 3;
+    } else {
+        *string += 1;
+        return TEXT_REPLACEMENT_CHARACTER;
+    }
+
+    if(end - *string <= extra) {
+        *string = end;
+        return TEXT_REPLACEMENT_CHARACTER;
+    }
+
+    for(int i = 1; i <= extra; i++) {
+        if((s[i] & 0xC0) != 0x80) {
+            *string += i;
+            return TEXT_REPLACEMENT_CHARACTER;
+        }
+        codepoint = (codepoint << 6) | (s[i] & 0x3F);
+    }
+
+    *string += extra + 1;
+    return codepoint;
+}
+
+static SDL_bool font_is_blank(SDL_Surface* surface, Rectangle rect) {
+    for(int y = rect.y; y < rect.y + rect.h; y++) {
+        const Uint32* row = (const Uint32*)((const Uint8*)surface->pixels + y * surface->pitch);
+        for(int x = rect.x; x < rect.x + rect.w; x++) {
+            if((row[x] >> 24) != 0)
+                return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+SDL_bool font_init(Font* font, TextureAtlas* atlas, SDL_Surface* surface, const FontGlyphInfo* glyphs, int glyph_count, int line_height) {
+    font->atlas = atlas;
+    font->glyph_count = 0;
+    font->line_height = line_height;
+    font->fallback = -1;
+
+    font->glyphs = su_malloc(sizeof(FontGlyph) * (glyph_count > 0 ? glyph_count : 1));
+    if(font->glyphs == NULL) {
+        SDL_SetError("Could not create font, not enough memory.");
+        return SDL_FALSE;
+    }
+
+    // The glyphs are read straight from the pixels in the format used by the atlas.
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, ATLAS_PIXEL_FORMAT, 0);
+    if(converted == NULL)
+        goto error;
+
+    for(int i = 0; i < glyph_count; i++) {
+        const FontGlyphInfo* info = glyphs + i;
+        Rectangle rect = info->rect;
+
+        if(rect.x < 0 || rect.y < 0 || rect.w < 0 || rect.h < 0
+            || rect.x + rect.w > converted->w || rect.y + rect.h > converted->h)
+        {
+            SDL_SetError("Could not create font, a glyph is outside of the image.");
+            goto error;
+        }
+
+        AtlasRegionId region = ATLAS_REGION_INVALID;
+
+        // Blank glyphs like spaces only move the pen, so they aren't stored.
+        if(rect.w > 0 && rect.h > 0 && !font_is_blank(converted, rect)) {
+            SDL_Surface* view = SDL_CreateRGBSurfaceWithFormatFrom(
+                (Uint8*)converted->pixels + rect.y * converted->pitch + rect.x * 4,
+                rect.w,
+                rect.h,
+                32,
+                converted->pitch,
+                ATLAS_PIXEL_FORMAT);
+
+            if(view == NULL)
+                goto error;
+
+            region = atlas_add(atlas, view);
+            SDL_FreeSurface(view);
+
+            if(region == ATLAS_REGION_INVALID)
+                goto error;
+        }
+
+        font->glyphs[font->glyph_count++] = (FontGlyph){
+            info->codepoint,
+            region,
+            info->x_offset,
+            info->y_offset,
+            rect.w,
+            rect.h,
+            info->advance
+        };
+    }
+
+    SDL_FreeSurface(converted);
+
+    SDL_qsort(font->glyphs, font->glyph_count, sizeof(FontGlyph), font_glyph_compare);
+
+    for(int i = 0; i < 128; i++)
+        font->ascii[i] = -1;
+
+    for(int i = 0; i < font->glyph_count; i++) {
+        if(font->glyphs[i].codepoint < 128)
+            font->ascii[font->glyphs[i].codepoint] = i;
+    }
+
+    font->fallback = font->ascii['?'];
+    return SDL_TRUE;
+
+    error:
+        SDL_FreeSurface(converted);
+        su_free(font->glyphs);
+        font->glyphs = NULL;
+        font->glyph_count = 0;
+        return SDL_FALSE;
+}
+
+SDL_bool font_init_grid(Font* font, TextureAtlas* atlas, SDL_Surface* surface, Uint32 first_codepoint, int cell_width, int cell_height) {
+    if(cell_width <= 0 || cell_height <= 0) {
+        SDL_SetError("Could not create font, invalid cell size.");
+        return SDL_FALSE;
+    }
+
+    int columns = surface->w / cell_width;
+    int rows = surface->h / cell_height;
+    int count = columns * rows;
+
+    FontGlyphInfo* glyphs = su_malloc(sizeof(FontGlyphInfo) * (count > 0 ? count : 1));
+    if(glyphs == NULL) {
+        SDL_SetError("Could not create font, not enough memory.");
+        return SDL_FALSE;
+    }
+
+    for(int i = 0; i < count; i++) {
+        glyphs[i] = (FontGlyphInfo){
+            first_codepoint + i,
+            { (i % columns) * cell_width, (i / columns) * cell_height, cell_width, cell_height },
+            0,
+            0,
+            cell_width
+        };
+    }
+
+    SDL_bool result = font_init(font, atlas, surface, glyphs, count, cell_height);
+    su_free(glyphs);
+    return result;
+}
+
+Font* font_create(TextureAtlas* atlas, SDL_Surface* surface, const FontGlyphInfo* glyphs, int glyph_count, int line_height) {
+    Font* font = su_malloc(sizeof(*font));
+    if(font == NULL) {
+        SDL_SetError("Could not create font, not enough memory.");
+        return NULL;
+    }
+
+    if(!font_init(font, atlas, surface, glyphs, glyph_count, line_height)) {
+        su_free(font);
+        return NULL;
+    }
+
+    return font;
+}
+
+void font_free_resources(Font* font) {
+    su_free(font->glyphs);
+    font->glyphs = NULL;
+    font->glyph_count = 0;
+}
+
+void font_free(Font* font) {
+    font_free_resources(font);
+    su_free(font);
+}
+
+static int font_find_glyph(Font* font, Uint32 codepoint) {
+    if(codepoint < 128)
+        return font->ascii[codepoint];
+
+    int low = 0;
+    int high = font->glyph_count - 1;
+    while(low <= high) {
+        int mid = low + (high - low) / 2;
+        Uint32 value = font->glyphs[mid].codepoint;
+        if(value == codepoint)
+            return mid;
+        if(value < codepoint)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+
+    return -1;
+}
+
+FontGlyph* font_get_glyph(Font* font, Uint32 codepoint) {
+    int index = font_find_glyph(font, codepoint);
+    if(index == -1)
+        index = font->fallback;
+
+    return index == -1 ? NULL : font->glyphs + index;
+}
+
+void font_set_fallback(Font* font, Uint32 codepoint) {
+    font->fallback = font_find_glyph(font, codepoint);
+}
+
+void font_measure(Font* font, const char* text, int* width, int* height) {
+    const char* end = text + SDL_strlen(text);
+    int line_width = 0;
+    int max_width = 0;
+    int lines = 1;
+
+    while(text < end) {
+        Uint32 codepoint = text_next_codepoint(&text, end);
+        if(codepoint == '\n') {
+            max_width = SDL_max(max_width, line_width);
+            line_width = 0;
+            lines++;
+            continue;
+        }
+
+        FontGlyph* glyph = font_get_glyph(font, codepoint);
+        if(glyph != NULL)
+            line_width += glyph->advance;
+    }
+
+    if(width != NULL)
+        *width = SDL_max(max_width, line_width);
+    if(height != NULL)
+        *height = lines * font->line_height;
+}
+
+SDL_bool text_renderer_init(TextRenderer* text, SDL_Renderer* renderer) {
+    text->renderer = renderer;
+    text->buckets = su_calloc(TEXT_INITIAL_BUCKETS, sizeof(TextRun*));
+    if(text->buckets == NULL) {
+        SDL_SetError("Could not create text renderer, not enough memory.");
+        return SDL_FALSE;
+    }
+
+    text->bucket_count = TEXT_INITIAL_BUCKETS;
+    text->run_count = 0;
+    text->batches = NULL;
+    text->batch_count = 0;
+    text->batch_capacity = 0;
+    text->indices = NULL;
+    text->index_quads = 0;
+    text->frame = 0;
+    return SDL_TRUE;
+}
+
+TextRenderer* text_renderer_create(SDL_Renderer* renderer) {
+    TextRenderer* text = su_malloc(sizeof(*text));
+    if(text == NULL) {
+        SDL_SetError("Could not create text renderer, not enough memory.");
+        return NULL;
+    }
+
+    if(!text_renderer_init(text, renderer)) {
+        su_free(text);
+        return NULL;
+    }
+
+    return text;
+}
+
+void text_renderer_free_resources(TextRenderer* text) {
+    text_renderer_clear_cache(text);
+    su_free(text->buckets);
+
+    for(int i = 0; i < text->batch_count; i++)
+        su_free(text->batches[i].vertices);
+
+    su_free(text->batches);
+    su_free(text->indices);
+
+    text->buckets = NULL;
+    text->bucket_count = 0;
+    text->batches = NULL;
+    text->batch_count = 0;
+    text->batch_capacity = 0;
+    text->indices = NULL;
+    text->index_quads = 0;
+}
+
+void text_renderer_free(TextRenderer* text) {
+    text_renderer_free_resources(text);
+    su_free(text);
+}
+
+void text_renderer_clear_cache(TextRenderer* text) {
+    for(int i = 0; i < text->bucket_count; i++) {
+        TextRun* run = text->buckets[i];
+        while(run != NULL) {
+            TextRun* next = run->next;
+            su_free(run);
+            run = next;
+        }
+        text->buckets[i] = NULL;
+    }
+
+    text->run_count = 0;
+}
+
+static Uint32 text_hash(Font* font, const char* string, size_t length, SDL_Color color) {
+    Uint32 hash = 2166136261u;
+    for(size_t i = 0; i < length; i++) {
+        hash ^= (Uint8)string[i];
+        hash *= 16777619u;
+    }
+
+    hash ^= ((Uint32)color.r << 24) | ((Uint32)color.g << 16) | ((Uint32)color.b << 8) | color.a;
+    hash *= 16777619u;
+    hash ^= (Uint32)(uintptr_t)font;
+    hash *= 16777619u;
+    return hash;
+}
+
+static void text_run_layout(TextRun* run) {
+    Font* font = run->font;
+    TextureAtlas* atlas = font->atlas;
+    float inv_page_size = 1.0f / atlas->page_size;
+    SDL_Color color = run->color;
+
+    const char* string = run->text;
+    const char* end = string + run->length;
+    SDL_Vertex* vertex = run->vertices;
+    int pen_x = 0;
+    int pen_y = 0;
+
+    run->quad_count = 0;
+
+    while(string < end) {
+        Uint32 codepoint = text_next_codepoint(&string, end);
+        if(codepoint == '\n') {
+            pen_x = 0;
+            pen_y += font->line_height;
+            continue;
+        }
+
+        FontGlyph* glyph = font_get_glyph(font, codepoint);
+        if(glyph == NULL)
+            continue;
+
+        if(glyph->region != ATLAS_REGION_INVALID) {
+            AtlasRegion region = atlas_get_region(atlas, glyph->region);
+            float left = (float)(pen_x + glyph->x_offset);
+            float top = (float)(pen_y + glyph->y_offset);
+            float right = left + glyph->width;
+            float bottom = top + glyph->height;
+
+            float u0 = region.rect.x * inv_page_size;
+            float v0 = region.rect.y * inv_page_size;
+            float u1 = (region.rect.x + region.rect.w) * inv_page_size;
+            float v1 = (region.rect.y + region.rect.h) * inv_page_size;
+
+            vertex[0] = (SDL_Vertex){ { left, top }, color, { u0, v0 } };
+            vertex[1] = (SDL_Vertex){ { right, top }, color, { u1, v0 } };
+            vertex[2] = (SDL_Vertex){ { left, bottom }, color, { u0, v1 } };
+            vertex[3] = (SDL_Vertex){ { right, bottom }, color, { u1, v1 } };
+            vertex += 4;
+
+            run->textures[run->quad_count++] = region.texture;
+        }
+
+        pen_x += glyph->advance;
+    }
+
+    run->generation = atlas_get_generation(atlas);
+}
+
+static TextRun* text_run_create(Font* font, const char* string, size_t length, Uint32 hash, SDL_Color color) {
+    // Every codepoint takes at least one byte, so the length is enough quads for any string.
+    // The run, its vertices, its textures and its copy of the string share one allocation.
+    size_t vertices_size = sizeof(SDL_Vertex) * 4 * length;
+    size_t textures_size = sizeof(Texture*) * length;
+
+    TextRun* run = su_malloc(sizeof(TextRun) + vertices_size + textures_size + length + 1);
+    if(run == NULL) {
+        SDL_SetError("Could not draw text, not enough memory.");
+        return NULL;
+    }
+
+    run->font = font;
+    run->vertices = (SDL_Vertex*)(run + 1);
+    run->textures = (Texture**)((Uint8*)run->vertices + vertices_size);
+    run->text = (char*)run->textures + textures_size;
+    run->length = length;
+    run->hash = hash;
+    run->color = color;
+    run->next = NULL;
+    SDL_memcpy(run->text, string, length + 1);
+
+    text_run_layout(run);
+    return run;
+}
+
+static void text_grow_buckets(TextRenderer* text) {
+    int bucket_count = text->bucket_count * 2;
+    TextRun** buckets = su_calloc(bucket_count, sizeof(TextRun*));
+
+    // Running with more runs per bucket is slower but still correct.
+    if(buckets == NULL)
+        return;
+
+    for(int i = 0; i < text->bucket_count; i++) {
+        TextRun* run = text->buckets[i];
+        while(run != NULL) {
+            TextRun* next = run->next;
+            TextRun** bucket = buckets + (run->hash & (bucket_count - 1));
+            run->next = *bucket;
+            *bucket = run;
+            run = next;
+        }
+    }
+
+    su_free(text->buckets);
+    text->buckets = buckets;
+    text->bucket_count = bucket_count;
+}
+
+static TextRun* text_get_run(TextRenderer* text, Font* font, const char* string, SDL_Color color) {
+    size_t length = SDL_strlen(string);
+    Uint32 hash = text_hash(font, string, length, color);
+
+    for(TextRun* run = text->buckets[hash & (text->bucket_count - 1)]; run != NULL; run = run->next) {
+        if(run->hash == hash
+            && run->font == font
+            && run->length == length
+            && run->color.r == color.r
+            && run->color.g == color.g
+            && run->color.b == color.b
+            && run->color.a == color.a
+            && SDL_memcmp(run->text, string, length) == 0)
+        {
+            return run;
+        }
+    }
+
+    TextRun* run = text_run_create(font, string, length, hash, color);
+    if(run == NULL)
+        return NULL;
+
+    if(text->run_count >= text->bucket_count)
+        text_grow_buckets(text);
+
+    TextRun** bucket = text->buckets + (hash & (text->bucket_count - 1));
+    run->next = *bucket;
+    *bucket = run;
+    text->run_count++;
+    return run;
+}
+
+static TextBatch* text_get_batch(TextRenderer* text, Texture* texture, int quads) {
+    TextBatch* batch = NULL;
+    for(int i = 0; i < text->batch_count; i++) {
+        if(text->batches[i].texture == texture) {
+            batch = text->batches + i;
+            break;
+        }
+
+        // Reuse the buffers of batches whose texture wasn't drawn this frame.
+        if(batch == NULL && text->batches[i].texture == NULL)
+            batch = text->batches + i;
+    }
+
+    if(batch == NULL) {
+        if(text->batch_count == text->batch_capacity) {
+            int capacity = text->batch_capacity == 0 ? 4 : text->batch_capacity * 2;
+            TextBatch* batches = su_realloc(text->batches, sizeof(TextBatch) * capacity);
+            if(batches == NULL)
+                return NULL;
+
+            text->batches = batches;
+            text->batch_capacity = capacity;
+        }
+
+        batch = text->batches + text->batch_count++;
+        batch->vertices = NULL;
+        batch->quad_count = 0;
+        batch->quad_capacity = 0;
+    }
+
+    batch->texture = texture;
+
+    if(batch->quad_count + quads > batch->quad_capacity) {
+        int capacity = batch->quad_capacity == 0 ? 64 : batch->quad_capacity;
+        while(capacity < batch->quad_count + quads)
+            capacity *= 2;
+
+        SDL_Vertex* vertices = su_realloc(batch->vertices, sizeof(SDL_Vertex) * 4 * capacity);
+        if(vertices == NULL)
+            return NULL;
+
+        batch->vertices = vertices;
+        batch->quad_capacity = capacity;
+    }
+
+    return batch;
+}
+
+SDL_bool text_draw(TextRenderer* text, Font* font, const char* string, float x, float y, SDL_Color color) {
+    TextRun* run = text_get_run(text, font, string, color);
+    if(run == NULL)
+        return SDL_FALSE;
+
+    // The texture coordinates only have to be recomputed when the atlas was rebuilt.
+    if(run->generation != atlas_get_generation(font->atlas))
+        text_run_layout(run);
+
+    run->last_used = text->frame;
+
+    TextBatch* batch = NULL;
+    const SDL_Vertex* source = run->vertices;
+
+    for(int i = 0; i < run->quad_count; i++) {
+        if(batch == NULL || batch->texture != run->textures[i]) {
+            batch = text_get_batch(text, run->textures[i], run->quad_count - i);
+            if(batch == NULL) {
+                SDL_SetError("Could not draw text, not enough memory.");
+                return SDL_FALSE;
+            }
+        }
+
+        SDL_Vertex* vertex = batch->vertices + batch->quad_count * 4;
+        for(int j = 0; j < 4; j++) {
+            vertex[j] = source[j];
+            vertex[j].position.x += x;
+            vertex[j].position.y += y;
+        }
+
+        source += 4;
+        batch->quad_count++;
+    }
+
+    return SDL_TRUE;
+}
+
+static SDL_bool text_reserve_indices(TextRenderer* text, int quads) {
+    if(quads <= text->index_quads)
+        return SDL_TRUE;
+
+    int capacity = text->index_quads == 0 ? 64 : text->index_quads;
+    while(capacity < quads)
+        capacity *= 2;
+
+    int* indices = su_realloc(text->indices, sizeof(int) * 6 * capacity);
+    if(indices == NULL) {
+        SDL_SetError("Could not draw text, not enough memory.");
+        return SDL_FALSE;
+    }
+
+    for(int i = text->index_quads; i < capacity; i++) {
+        int* index = indices + i * 6;
+        int vertex = i * 4;
+        index[0] = vertex;
+        index[1] = vertex + 1;
+        index[2] = vertex + 2;
+        index[3] = vertex + 2;
+        index[4] = vertex + 1;
+        index[5] = vertex + 3;
+    }
+
+    text->indices = indices;
+    text->index_quads = capacity;
+    return SDL_TRUE;
+}
+
+static void text_evict_runs(TextRenderer* text) {
+    for(int i = 0; i < text->bucket_count; i++) {
+        TextRun** link = text->buckets + i;
+        while(*link != NULL) {
+            TextRun* run = *link;
+            if(text->frame - run->last_used > TEXT_RUN_MAX_AGE) {
+                *link = run->next;
+                su_free(run);
+                text->run_count--;
+            } else {
+                link = &run->next;
+            }
+        }
+    }
+}
+
+SDL_bool text_renderer_flush(TextRenderer* text) {
+    SDL_bool result = SDL_TRUE;
+
+    for(int i = 0; i < text->batch_count; i++) {
+        TextBatch* batch = text->batches + i;
+        if(batch->quad_count == 0) {
+            batch->texture = NULL;
+            continue;
+        }
+
+        if(!text_reserve_indices(text, batch->quad_count)
+            || SDL_RenderGeometry(text->renderer,
+                                  batch->texture,
+                                  batch->vertices,
+                                  batch->quad_count * 4,
+                                  text->indices,
+                                  batch->quad_count * 6) != 0)
+        {
+            result = SDL_FALSE;
+        }
+
+        // Forget the texture so the batch can be reused if the atlas is rebuilt.
+        batch->texture = NULL;
+        batch->quad_count = 0;
+    }
+
+    // Strings that change every frame, like timers, leave a run behind every frame,
+    // so old runs are swept out periodically instead of on every flush.
+    if(++text->frame % TEXT_RUN_MAX_AGE == 0)
+        text_evict_runs(text);
+
+    return result;
+}
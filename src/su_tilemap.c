@@ -0,0 +1,296 @@
+#include <su_tilemap.h>
+
+static void chunk_lru_remove(Tilemap* tilemap, TilemapChunk* chunk) {
+    if(chunk->lru_prev != NULL)
+        chunk->lru_prev->lru_next = chunk->lru_next;
+    else
+        tilemap->lru_head = chunk->lru_next;
+
+    if(chunk->lru_next != NULL)
+        chunk->lru_next->lru_prev = chunk->lru_prev;
+    else
+        tilemap->lru_tail = chunk->lru_prev;
+
+    chunk->lru_prev = NULL;
+    chunk->lru_next = NULL;
+}
+
+static void chunk_lru_push(Tilemap* tilemap, TilemapChunk* chunk) {
+    chunk->lru_prev = NULL;
+    chunk->lru_next = tilemap->lru_head;
+    if(tilemap->lru_head != NULL)
+        tilemap->lru_head->lru_prev = chunk;
+    else
+        tilemap->lru_tail = chunk;
+    tilemap->lru_head = chunk;
+}
+
+static size_t chunk_texture_size(Tilemap* tilemap) {
+    return (size_t)tilemap->chunk_size * tilemap->tile_width *
+           (size_t)tilemap->chunk_size * tilemap->tile_height *
+           SDL_BYTESPERPIXEL(TILEMAP_CHUNK_FORMAT);
+}
+
+static void chunk_evict(Tilemap* tilemap, TilemapChunk* chunk) {
+    chunk_lru_remove(tilemap, chunk);
+    SDL_DestroyTexture(chunk->texture);
+    chunk->texture = NULL;
+    chunk->dirty = SDL_TRUE;
+    tilemap->memory_used -= chunk_texture_size(tilemap);
+}
+
+static void tilemap_enforce_budget(Tilemap* tilemap) {
+    if(tilemap->memory_budget == 0)
+        return;
+
+    // Chunks drawn this frame are at the front of the list, so stop as soon
+    // as one is found at the back.
+    while(tilemap->memory_used > tilemap->memory_budget &&
+          tilemap->lru_tail != NULL &&
+          tilemap->lru_tail->frame != tilemap->frame)
+    {
+        chunk_evict(tilemap, tilemap->lru_tail);
+    }
+}
+
+static SDL_bool chunk_bake(Tilemap* tilemap, TilemapChunk* chunk, SDL_Renderer* renderer) {
+    int chunk_width = tilemap->chunk_size * tilemap->tile_width;
+    int chunk_height = tilemap->chunk_size * tilemap->tile_height;
+
+    if(chunk->texture == NULL) {
+        chunk->texture = SDL_CreateTexture(renderer, TILEMAP_CHUNK_FORMAT, SDL_TEXTUREACCESS_TARGET, chunk_width, chunk_height);
+        if(chunk->texture == NULL)
+            return SDL_FALSE;
+
+        SDL_SetTextureBlendMode(chunk->texture, SDL_BLENDMODE_BLEND);
+        tilemap->memory_used += chunk_texture_size(tilemap);
+        chunk_lru_push(tilemap, chunk);
+    }
+
+    Texture* previous_target = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    float scale_x, scale_y;
+    SDL_RenderGetScale(renderer, &scale_x, &scale_y);
+
+    if(SDL_SetRenderTarget(renderer, chunk->texture) != 0)
+        return SDL_FALSE;
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    TileId* tile = chunk->tiles;
+    for(int layer = 0; layer < tilemap->layer_count; layer++) {
+        for(int y = 0; y < tilemap->chunk_size; y++) {
+            for(int x = 0; x < tilemap->chunk_size; x++, tile++) {
+                if(*tile == TILE_EMPTY)
+                    continue;
+
+                int index = *tile - 1;
+                Rectangle src = {
+                    (index % tilemap->tileset_columns) * tilemap->tile_width,
+                    (index / tilemap->tileset_columns) * tilemap->tile_height,
+                    tilemap->tile_width,
+                    tilemap->tile_height
+                };
+                Rectangle dst = { x * tilemap->tile_width, y * tilemap->tile_height, tilemap->tile_width, tilemap->tile_height };
+                SDL_RenderCopy(renderer, tilemap->tileset, &src, &dst);
+            }
+        }
+    }
+
+    // Changing the render target resets the scale and viewport, so put
+    // them back the way scene_draw leaves them.
+    SDL_SetRenderTarget(renderer, previous_target);
+    SDL_RenderSetScale(renderer, scale_x, scale_y);
+    SDL_RenderSetViewport(renderer, NULL);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+    chunk->dirty = SDL_FALSE;
+    return SDL_TRUE;
+}
+
+SDL_bool tilemap_init(Tilemap* tilemap,
+                      Texture* tileset,
+                      int tile_width,
+                      int tile_height,
+                      int width,
+                      int height,
+                      int layer_count,
+                      int chunk_size)
+{
+    if(tile_width <= 0 || tile_height <= 0 || width <= 0 || height <= 0 || layer_count <= 0 || chunk_size <= 0) {
+        SDL_SetError("Could not initialize tilemap, all sizes must be positive.");
+        return SDL_FALSE;
+    }
+
+    tilemap->tile_width = tile_width;
+    tilemap->tile_height = tile_height;
+    tilemap->width = width;
+    tilemap->height = height;
+    tilemap->layer_count = layer_count;
+    tilemap->chunk_size = chunk_size;
+    tilemap->chunks_x = (width + chunk_size - 1) / chunk_size;
+    tilemap->chunks_y = (height + chunk_size - 1) / chunk_size;
+    tilemap->memory_budget = 0;
+    tilemap->memory_used = 0;
+    tilemap->lru_head = NULL;
+    tilemap->lru_tail = NULL;
+    tilemap->frame = 0;
+    tilemap->tileset = NULL;
+    tilemap->tileset_columns = 1;
+
+    tilemap->chunks = su_calloc((size_t)tilemap->chunks_x * tilemap->chunks_y, sizeof(TilemapChunk));
+    if(tilemap->chunks == NULL) {
+        SDL_SetError("Could not initialize tilemap, not enough memory for chunks.");
+        return SDL_FALSE;
+    }
+
+    tilemap_set_tileset(tilemap, tileset);
+    return SDL_TRUE;
+}
+
+Tilemap* tilemap_create(Texture* tileset,
+                        int tile_width,
+                        int tile_height,
+                        int width,
+                        int height,
+                        int layer_count,
+                        int chunk_size)
+{
+    Tilemap* tilemap = su_malloc(sizeof(*tilemap));
+    if(tilemap == NULL)
+        return NULL;
+
+    if(!tilemap_init(tilemap, tileset, tile_width, tile_height, width, height, layer_count, chunk_size)) {
+        su_free(tilemap);
+        return NULL;
+    }
+
+    return tilemap;
+}
+
+void tilemap_free_resources(Tilemap* tilemap) {
+    int count = tilemap->chunks_x * tilemap->chunks_y;
+    for(int i = 0; i < count; i++) {
+        if(tilemap->chunks[i].texture != NULL)
+            SDL_DestroyTexture(tilemap->chunks[i].texture);
+        su_free(tilemap->chunks[i].tiles);
+    }
+
+    su_free(tilemap->chunks);
+    tilemap->chunks = NULL;
+    tilemap->lru_head = NULL;
+    tilemap->lru_tail = NULL;
+    tilemap->memory_used = 0;
+}
+
+void tilemap_free(Tilemap* tilemap) {
+    tilemap_free_resources(tilemap);
+    su_free(tilemap);
+}
+
+SDL_bool tilemap_set_tile(Tilemap* tilemap, int layer, int x, int y, TileId tile) {
+    if(layer < 0 || layer >= tilemap->layer_count || x < 0 || x >= tilemap->width || y < 0 || y >= tilemap->height) {
+        SDL_SetError("Tile position (%d, %d, %d) is outside of the tilemap.", x, y, layer);
+        return SDL_FALSE;
+    }
+
+    TilemapChunk* chunk = tilemap->chunks + (y / tilemap->chunk_size) * tilemap->chunks_x + x / tilemap->chunk_size;
+    if(chunk->tiles == NULL) {
+        // Setting a tile in an unallocated chunk to empty doesn't change anything.
+        if(tile == TILE_EMPTY)
+            return SDL_TRUE;
+
+        chunk->tiles = su_calloc((size_t)tilemap->layer_count * tilemap->chunk_size * tilemap->chunk_size, sizeof(TileId));
+        if(chunk->tiles == NULL) {
+            SDL_SetError("Could not set tile, not enough memory for chunk.");
+            return SDL_FALSE;
+        }
+    }
+
+    int local_x = x % tilemap->chunk_size;
+    int local_y = y % tilemap->chunk_size;
+    TileId* slot = chunk->tiles + (layer * tilemap->chunk_size + local_y) * tilemap->chunk_size + local_x;
+    if(*slot != tile) {
+        *slot = tile;
+        chunk->dirty = SDL_TRUE;
+    }
+
+    return SDL_TRUE;
+}
+
+void tilemap_set_tileset(Tilemap* tilemap, Texture* tileset) {
+    int width = 0;
+    tilemap->tileset = tileset;
+    if(tileset != NULL && SDL_QueryTexture(tileset, NULL, NULL, &width, NULL) == 0 && width >= tilemap->tile_width)
+        tilemap->tileset_columns = width / tilemap->tile_width;
+    else
+        tilemap->tileset_columns = 1;
+
+    tilemap_invalidate(tilemap);
+}
+
+void tilemap_invalidate(Tilemap* tilemap) {
+    int count = tilemap->chunks_x * tilemap->chunks_y;
+    for(int i = 0; i < count; i++)
+        tilemap->chunks[i].dirty = SDL_TRUE;
+}
+
+void tilemap_set_memory_budget(Tilemap* tilemap, size_t bytes) {
+    tilemap->memory_budget = bytes;
+    tilemap_enforce_budget(tilemap);
+}
+
+static int floor_div(int value, int divisor) {
+    int result = value / divisor;
+    if((value % divisor != 0) && (value < 0))
+        result--;
+    return result;
+}
+
+SDL_bool tilemap_draw(Tilemap* tilemap, Camera* camera) {
+    if(tilemap->tileset == NULL)
+        return SDL_TRUE;
+
+    SDL_Renderer* renderer = camera->renderer;
+    Rectangle view = camera_get_bounds(camera);
+    int chunk_width = tilemap->chunk_size * tilemap->tile_width;
+    int chunk_height = tilemap->chunk_size * tilemap->tile_height;
+
+    int start_x = SDL_max(floor_div(view.x, chunk_width), 0);
+    int start_y = SDL_max(floor_div(view.y, chunk_height), 0);
+    int end_x = SDL_min(floor_div(view.x + view.w - 1, chunk_width), tilemap->chunks_x - 1);
+    int end_y = SDL_min(floor_div(view.y + view.h - 1, chunk_height), tilemap->chunks_y - 1);
+
+    tilemap->frame++;
+    SDL_bool result = SDL_TRUE;
+
+    for(int y = start_y; y <= end_y; y++) {
+        for(int x = start_x; x <= end_x; x++) {
+            TilemapChunk* chunk = tilemap->chunks + y * tilemap->chunks_x + x;
+            if(chunk->tiles == NULL)
+                continue;
+
+            chunk->frame = tilemap->frame;
+
+            if(chunk->texture != NULL) {
+                chunk_lru_remove(tilemap, chunk);
+                chunk_lru_push(tilemap, chunk);
+            }
+
+            if(chunk->dirty || chunk->texture == NULL) {
+                if(!chunk_bake(tilemap, chunk, renderer)) {
+                    result = SDL_FALSE;
+                    continue;
+                }
+            }
+
+            Rectangle dst = { x * chunk_width - view.x, y * chunk_height - view.y, chunk_width, chunk_height };
+            SDL_RenderCopy(renderer, chunk->texture, NULL, &dst);
+        }
+    }
+
+    tilemap_enforce_budget(tilemap);
+    return result;
+}
@@ -0,0 +1,401 @@
+#include <su_tween.h>
+
+#include <stddef.h>
+
+#include "su_simd.h"
+
+#define TWEEN_FLAG_INT 1
+#define TWEEN_FLAG_SECOND_COMPONENT 2
+
+// Every easing except linear and smoothstep is built from an "in" curve:
+// out(t) = 1 - in(1 - t), and in_out mirrors in over each half of the range.
+
+#define EASE_BACK_C1 1.70158f
+#define EASE_BACK_C3 (EASE_BACK_C1 + 1)
+
+static inline float ease_in(int family, float t) {
+    switch(family) {
+        case 0: return t * t;
+        case 1: return t * t * t;
+        case 2: return t * t * t * t;
+        default: return t * t * (EASE_BACK_C3 * t - EASE_BACK_C1);
+    }
+}
+
+float ease(EaseType type, float t) {
+    if(type == EASE_LINEAR)
+        return t;
+    if(type == EASE_SMOOTHSTEP)
+        return t * t * (3 - 2 * t);
+
+    int family = (type - EASE_QUAD_IN) / 3;
+    switch((type - EASE_QUAD_IN) % 3) {
+        case 0: return ease_in(family, t);
+        case 1: return 1 - ease_in(family, 1 - t);
+        default:
+            if(t < 0.5f)
+                return 0.5f * ease_in(family, 2 * t);
+            return 1 - 0.5f * ease_in(family, 2 - 2 * t);
+    }
+}
+
+#ifdef SU_SIMD
+
+static inline simd_float4 ease_in_simd(int family, simd_float4 t) {
+    simd_float4 t2 = simd_mul(t, t);
+    switch(family) {
+        case 0: return t2;
+        case 1: return simd_mul(t2, t);
+        case 2: return simd_mul(t2, t2);
+        default: return simd_mul(t2, simd_sub(simd_mul(simd_set1(EASE_BACK_C3), t), simd_set1(EASE_BACK_C1)));
+    }
+}
+
+static inline simd_float4 ease_simd(EaseType type, simd_float4 t) {
+    simd_float4 one = simd_set1(1);
+    simd_float4 half = simd_set1(0.5f);
+
+    if(type == EASE_LINEAR)
+        return t;
+    if(type == EASE_SMOOTHSTEP)
+        return simd_mul(simd_mul(t, t), simd_sub(simd_set1(3), simd_add(t, t)));
+
+    int family = (type - EASE_QUAD_IN) / 3;
+    switch((type - EASE_QUAD_IN) % 3) {
+        case 0: return ease_in_simd(family, t);
+        case 1: return simd_sub(one, ease_in_simd(family, simd_sub(one, t)));
+        default: {
+            simd_float4 t2 = simd_add(t, t);
+            simd_float4 low = simd_mul(half, ease_in_simd(family, t2));
+            simd_float4 high = simd_sub(one, simd_mul(half, ease_in_simd(family, simd_sub(simd_set1(2), t2))));
+            return simd_select(simd_cmplt(t, half), low, high);
+        }
+    }
+}
+
+#endif
+
+void ease_batch(EaseType type, float* t, int count) {
+    int i = 0;
+#ifdef SU_SIMD
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH)
+        simd_store(t + i, ease_simd(type, simd_load(t + i)));
+#endif
+    for(; i < count; i++)
+        t[i] = ease(type, t[i]);
+}
+
+void tweener_init(Tweener* tweener) {
+    SDL_memset(tweener->buckets, 0, sizeof(tweener->buckets));
+    tweener->completions = NULL;
+    tweener->completion_count = 0;
+    tweener->completion_capacity = 0;
+    tweener->callback_count = 0;
+    tweener->next_id = 1;
+}
+
+Tweener* tweener_create(void) {
+    Tweener* tweener = su_malloc(sizeof(*tweener));
+    if(tweener == NULL)
+        return NULL;
+
+    tweener_init(tweener);
+    return tweener;
+}
+
+void tweener_free_resources(Tweener* tweener) {
+    for(int i = 0; i < EASE_COUNT; i++) {
+        TweenBucket* bucket = tweener->buckets + i;
+        su_free(bucket->elapsed);
+        su_free(bucket->inv_duration);
+        su_free(bucket->start);
+        su_free(bucket->change);
+        su_free(bucket->value);
+        su_free(bucket->target);
+        su_free(bucket->flags);
+        su_free(bucket->id);
+        su_free(bucket->done);
+        su_free(bucket->data);
+    }
+
+    su_free(tweener->completions);
+    tweener_init(tweener);
+}
+
+void tweener_free(Tweener* tweener) {
+    tweener_free_resources(tweener);
+    su_free(tweener);
+}
+
+#define TWEEN_BUCKET_GROW(field) \
+    do { \
+        void* grown = su_realloc(bucket->field, sizeof(*bucket->field) * capacity); \
+        if(grown == NULL) \
+            return SDL_FALSE; \
+        bucket->field = grown; \
+    } while(0)
+
+static SDL_bool tween_bucket_reserve(TweenBucket* bucket, int extra) {
+    if(bucket->count + extra <= bucket->capacity)
+        return SDL_TRUE;
+
+    int capacity = bucket->capacity == 0 ? 16 : bucket->capacity * 2;
+    while(capacity < bucket->count + extra)
+        capacity *= 2;
+
+    // The arrays that were grown before a failure keep working at the old capacity.
+    TWEEN_BUCKET_GROW(elapsed);
+    TWEEN_BUCKET_GROW(inv_duration);
+    TWEEN_BUCKET_GROW(start);
+    TWEEN_BUCKET_GROW(change);
+    TWEEN_BUCKET_GROW(value);
+    TWEEN_BUCKET_GROW(target);
+    TWEEN_BUCKET_GROW(flags);
+    TWEEN_BUCKET_GROW(id);
+    TWEEN_BUCKET_GROW(done);
+    TWEEN_BUCKET_GROW(data);
+
+    bucket->capacity = capacity;
+    return SDL_TRUE;
+}
+
+#undef TWEEN_BUCKET_GROW
+
+static void tween_bucket_push(TweenBucket* bucket,
+                              void* target,
+                              Uint8 flags,
+                              float start,
+                              float to,
+                              float duration,
+                              TweenId id,
+                              TweenDoneFn done,
+                              void* data)
+{
+    int index = bucket->count++;
+
+    // A zero length tween still needs a finite scale, so it finishes on the next update.
+    bucket->elapsed[index] = 0;
+    bucket->inv_duration[index] = duration > 1e-6f ? 1 / duration : 1e6f;
+    bucket->start[index] = start;
+    bucket->change[index] = to - start;
+    bucket->value[index] = start;
+    bucket->target[index] = target;
+    bucket->flags[index] = flags;
+    bucket->id[index] = id;
+    bucket->done[index] = done;
+    bucket->data[index] = data;
+}
+
+static void tween_bucket_remove(TweenBucket* bucket, int index) {
+    int last = --bucket->count;
+    if(index == last)
+        return;
+
+    bucket->elapsed[index] = bucket->elapsed[last];
+    bucket->inv_duration[index] = bucket->inv_duration[last];
+    bucket->start[index] = bucket->start[last];
+    bucket->change[index] = bucket->change[last];
+    bucket->value[index] = bucket->value[last];
+    bucket->target[index] = bucket->target[last];
+    bucket->flags[index] = bucket->flags[last];
+    bucket->id[index] = bucket->id[last];
+    bucket->done[index] = bucket->done[last];
+    bucket->data[index] = bucket->data[last];
+}
+
+static TweenId tween_add(Tweener* tweener,
+                         void* target,
+                         SDL_bool is_int,
+                         int components,
+                         const float* start,
+                         const float* to,
+                         float duration,
+                         EaseType ease,
+                         TweenDoneFn done,
+                         void* data)
+{
+    if(ease < 0 || ease >= EASE_COUNT) {
+        SDL_SetError("Could not add tween, invalid easing function.");
+        return TWEEN_ID_INVALID;
+    }
+
+    TweenBucket* bucket = tweener->buckets + ease;
+    if(!tween_bucket_reserve(bucket, components)) {
+        SDL_SetError("Could not add tween, not enough memory.");
+        return TWEEN_ID_INVALID;
+    }
+
+    // Reserve room for the callback now so tweener_update never has to allocate.
+    if(done != NULL && tweener->callback_count == tweener->completion_capacity) {
+        int capacity = tweener->completion_capacity == 0 ? 16 : tweener->completion_capacity * 2;
+        TweenCompletion* completions = su_realloc(tweener->completions, sizeof(TweenCompletion) * capacity);
+        if(completions == NULL) {
+            SDL_SetError("Could not add tween, not enough memory.");
+            return TWEEN_ID_INVALID;
+        }
+        tweener->completions = completions;
+        tweener->completion_capacity = capacity;
+    }
+
+    TweenId id = tweener->next_id++;
+    if(tweener->next_id == TWEEN_ID_INVALID)
+        tweener->next_id = 1;
+
+    size_t stride = is_int ? sizeof(int) : sizeof(float);
+    for(int i = 0; i < components; i++) {
+        Uint8 flags = (is_int ? TWEEN_FLAG_INT : 0) | (i > 0 ? TWEEN_FLAG_SECOND_COMPONENT : 0);
+
+        // Only the first component reports completion.
+        tween_bucket_push(bucket, (Uint8*)target + stride * i, flags, start[i], to[i], duration, id,
+                          i == 0 ? done : NULL, data);
+    }
+
+    if(done != NULL)
+        tweener->callback_count++;
+
+    return id;
+}
+
+TweenId tween_float(Tweener* tweener, float* target, float to, float duration, EaseType ease, TweenDoneFn done, void* data) {
+    return tween_add(tweener, target, SDL_FALSE, 1, target, &to, duration, ease, done, data);
+}
+
+TweenId tween_int(Tweener* tweener, int* target, int to, float duration, EaseType ease, TweenDoneFn done, void* data) {
+    float start = (float)*target;
+    float end = (float)to;
+    return tween_add(tweener, target, SDL_TRUE, 1, &start, &end, duration, ease, done, data);
+}
+
+TweenId tween_vector2(Tweener* tweener, Vector2* target, Vector2 to, float duration, EaseType ease, TweenDoneFn done, void* data) {
+    float start[2] = { target->x, target->y };
+    float end[2] = { to.x, to.y };
+    return tween_add(tweener, target, SDL_FALSE, 2, start, end, duration, ease, done, data);
+}
+
+TweenId tween_point(Tweener* tweener, Point* target, Point to, float duration, EaseType ease, TweenDoneFn done, void* data) {
+    float start[2] = { (float)target->x, (float)target->y };
+    float end[2] = { (float)to.x, (float)to.y };
+    return tween_add(tweener, target, SDL_TRUE, 2, start, end, duration, ease, done, data);
+}
+
+static inline void* tween_owner(TweenBucket* bucket, int index) {
+    Uint8* target = bucket->target[index];
+    Uint8 flags = bucket->flags[index];
+
+    if(flags & TWEEN_FLAG_SECOND_COMPONENT)
+        target -= (flags & TWEEN_FLAG_INT) ? offsetof(Point, y) : offsetof(Vector2, y);
+
+    return target;
+}
+
+static int tweener_remove_matching(Tweener* tweener, TweenId id, void* target) {
+    int removed = 0;
+
+    for(int i = 0; i < EASE_COUNT; i++) {
+        TweenBucket* bucket = tweener->buckets + i;
+        int j = 0;
+        while(j < bucket->count) {
+            if(id != TWEEN_ID_INVALID ? bucket->id[j] == id : tween_owner(bucket, j) == target) {
+                if(bucket->done[j] != NULL)
+                    tweener->callback_count--;
+                if(!(bucket->flags[j] & TWEEN_FLAG_SECOND_COMPONENT))
+                    removed++;
+                tween_bucket_remove(bucket, j);
+            } else {
+                j++;
+            }
+        }
+    }
+
+    return removed;
+}
+
+SDL_bool tweener_cancel(Tweener* tweener, TweenId id) {
+    if(id == TWEEN_ID_INVALID)
+        return SDL_FALSE;
+
+    return tweener_remove_matching(tweener, id, NULL) > 0;
+}
+
+int tweener_cancel_target(Tweener* tweener, void* target) {
+    return tweener_remove_matching(tweener, TWEEN_ID_INVALID, target);
+}
+
+static void tween_bucket_update(Tweener* tweener, TweenBucket* bucket, EaseType type, float delta) {
+    float* elapsed = bucket->elapsed;
+    float* inv_duration = bucket->inv_duration;
+    float* start = bucket->start;
+    float* change = bucket->change;
+    float* value = bucket->value;
+    int count = bucket->count;
+
+    int i = 0;
+#ifdef SU_SIMD
+    simd_float4 step = simd_set1(delta);
+    simd_float4 one = simd_set1(1);
+    for(; i + SU_SIMD_WIDTH <= count; i += SU_SIMD_WIDTH) {
+        simd_float4 e = simd_add(simd_load(elapsed + i), step);
+        simd_store(elapsed + i, e);
+        simd_float4 t = simd_min(simd_mul(e, simd_load(inv_duration + i)), one);
+        simd_float4 eased = ease_simd(type, t);
+        simd_store(value + i, simd_add(simd_load(start + i), simd_mul(simd_load(change + i), eased)));
+    }
+#endif
+    for(; i < count; i++) {
+        elapsed[i] += delta;
+        float t = elapsed[i] * inv_duration[i];
+        if(t > 1)
+            t = 1;
+        value[i] = start[i] + change[i] * ease(type, t);
+    }
+
+    // Write the values out and swap finished tweens with the end of the arrays.
+    i = 0;
+    while(i < bucket->count) {
+        SDL_bool finished = elapsed[i] * inv_duration[i] >= 1;
+        float result = finished ? start[i] + change[i] : value[i];
+
+        if(bucket->flags[i] & TWEEN_FLAG_INT)
+            *(int*)bucket->target[i] = round_to_int(result);
+        else
+            *(float*)bucket->target[i] = result;
+
+        if(!finished) {
+            i++;
+            continue;
+        }
+
+        if(bucket->done[i] != NULL) {
+            TweenCompletion* completion = tweener->completions + tweener->completion_count++;
+            completion->done = bucket->done[i];
+            completion->id = bucket->id[i];
+            completion->data = bucket->data[i];
+            tweener->callback_count--;
+        }
+
+        tween_bucket_remove(bucket, i);
+    }
+}
+
+void tweener_update(Tweener* tweener, float delta) {
+    for(int i = 0; i < EASE_COUNT; i++) {
+        if(tweener->buckets[i].count > 0)
+            tween_bucket_update(tweener, tweener->buckets + i, (EaseType)i, delta);
+    }
+
+    // Callbacks run once every tween has been written, so they can freely add
+    // and cancel tweens. Tweens they add start on the next update.
+    int count = tweener->completion_count;
+    tweener->completion_count = 0;
+    for(int i = 0; i < count; i++) {
+        TweenCompletion completion = tweener->completions[i];
+        completion.done(tweener, completion.id, completion.data);
+    }
+}
+
+int tweener_get_count(Tweener* tweener) {
+    int count = 0;
+    for(int i = 0; i < EASE_COUNT; i++)
+        count += tweener->buckets[i].count;
+    return count;
+}
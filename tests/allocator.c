@@ -0,0 +1,80 @@
+/*
+    Checks the frame arena and the tracking allocator of su_allocator.h,
+    including a tracker shared by several threads.
+*/
+
+#include "test.h"
+
+#include <su_allocator.h>
+
+#define THREAD_COUNT 4
+#define THREAD_ALLOCATIONS 20000
+
+static void test_frame_arena(void) {
+    FrameArena arena;
+    TEST_CHECK(frame_arena_init(&arena, NULL, 1024));
+
+    void* first = frame_arena_alloc(&arena, 100);
+    void* second = frame_arena_alloc(&arena, 100);
+    TEST_CHECK(first != NULL && second != NULL);
+    TEST_CHECK((size_t)first % ALLOCATOR_ALIGNMENT == 0 && (size_t)second % ALLOCATOR_ALIGNMENT == 0);
+    TEST_CHECK(frame_arena_alloc(&arena, 1024) == NULL);
+    TEST_CHECK(arena.stats.failures == 1);
+
+    // Growing the last allocation happens in place.
+    TEST_CHECK(arena.allocator.realloc(&arena, second, 200) == second);
+
+    frame_arena_reset(&arena);
+    TEST_CHECK(arena.stats.bytes_in_use == 0);
+    TEST_CHECK(frame_arena_alloc(&arena, 100) == first);
+
+    frame_arena_free_resources(&arena);
+}
+
+static int allocate_from_thread(void* data) {
+    Allocator* allocator = data;
+    void* blocks[16] = { NULL };
+
+    for(int i = 0; i < THREAD_ALLOCATIONS; i++) {
+        int slot = i % 16;
+        allocator->free(allocator->data, blocks[slot]);
+        blocks[slot] = allocator->malloc(allocator->data, 16 + i % 64);
+        if(i % 3 == 0)
+            blocks[slot] = allocator->realloc(allocator->data, blocks[slot], 128);
+    }
+
+    for(int i = 0; i < 16; i++)
+        allocator->free(allocator->data, blocks[i]);
+
+    return 0;
+}
+
+static void test_tracking_allocator(void) {
+    TrackingAllocator tracker;
+    Allocator* allocator = tracking_allocator_init(&tracker, su_default_allocator());
+
+    SDL_Thread* threads[THREAD_COUNT];
+    for(int i = 0; i < THREAD_COUNT; i++)
+        threads[i] = SDL_CreateThread(allocate_from_thread, "allocator", allocator);
+
+    for(int i = 0; i < THREAD_COUNT; i++)
+        SDL_WaitThread(threads[i], NULL);
+
+    AllocatorStats stats = tracking_allocator_get_stats(&tracker);
+    Uint64 reallocations = (THREAD_ALLOCATIONS + 2) / 3;
+    TEST_CHECK(stats.allocations == (Uint64)THREAD_COUNT * (THREAD_ALLOCATIONS + reallocations));
+    TEST_CHECK(stats.frees == (Uint64)THREAD_COUNT * THREAD_ALLOCATIONS);
+    TEST_CHECK(stats.failures == 0);
+    TEST_CHECK(stats.bytes_in_use == 0);
+    TEST_CHECK(stats.high_water > 0);
+
+    tracking_allocator_reset_stats(&tracker);
+    stats = tracking_allocator_get_stats(&tracker);
+    TEST_CHECK(stats.allocations == 0 && stats.high_water == 0);
+}
+
+int main(int argc, char** argv) {
+    test_frame_arena();
+    test_tracking_allocator();
+    return test_result("allocator");
+}
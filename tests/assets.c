@@ -0,0 +1,238 @@
+/*
+    Checks the asset cache with a decoder that makes images in memory,
+    using a software renderer so no window or video driver is needed.
+*/
+
+#include "test.h"
+
+#include <su_assets.h>
+
+#define IMAGE_SIZE 16
+#define IMAGE_BYTES (IMAGE_SIZE * IMAGE_SIZE * 4)
+
+typedef struct TestDecoder {
+    SDL_atomic_t decodes;
+    SDL_bool fail_missing;
+} TestDecoder;
+
+// Makes a blank image for every path, except the ones starting with "missing" while fail_missing is set.
+static SDL_Surface* test_decode(const char* path, void* data) {
+    TestDecoder* decoder = data;
+    SDL_AtomicAdd(&decoder->decodes, 1);
+
+    if(decoder->fail_missing && SDL_strncmp(path, "missing", 7) == 0) {
+        SDL_SetError("%s not found", path);
+        return NULL;
+    }
+
+    return SDL_CreateRGBSurfaceWithFormat(0, IMAGE_SIZE, IMAGE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+}
+
+static SDL_bool test_cache_init(AssetCache* cache, TestDecoder* decoder, SDL_Renderer* renderer, int workers) {
+    SDL_AtomicSet(&decoder->decodes, 0);
+    decoder->fail_missing = SDL_FALSE;
+
+    if(!asset_cache_init(cache, renderer, workers)) {
+        TEST_FAIL("asset_cache_init failed: %s", SDL_GetError());
+        return SDL_FALSE;
+    }
+
+    asset_cache_set_decoder(cache, test_decode, decoder);
+    return SDL_TRUE;
+}
+
+static void test_cache_hit(SDL_Renderer* renderer) {
+    AssetCache cache;
+    TestDecoder decoder;
+    if(!test_cache_init(&cache, &decoder, renderer, 0))
+        return;
+
+    Asset* first = asset_cache_load(&cache, "player.bmp");
+    Asset* second = asset_cache_load(&cache, "player.bmp");
+    TEST_CHECK(first != NULL && first == second);
+    TEST_CHECK(asset_get_state(first) == ASSET_LOADING);
+    TEST_CHECK(first->references == 2);
+
+    asset_cache_update(&cache);
+    TEST_CHECK(asset_get_state(first) == ASSET_READY);
+    TEST_CHECK(asset_get_texture(first) != NULL);
+    TEST_CHECK(first->width == IMAGE_SIZE && first->height == IMAGE_SIZE);
+
+    // Loading a ready asset doesn't decode it again.
+    TEST_CHECK(asset_cache_load(&cache, "player.bmp") == first);
+    TEST_CHECK(SDL_AtomicGet(&decoder.decodes) == 1);
+    TEST_CHECK(cache.asset_count == 1);
+
+    asset_cache_free_resources(&cache);
+}
+
+static void test_vram_eviction(SDL_Renderer* renderer) {
+    AssetCache cache;
+    TestDecoder decoder;
+    if(!test_cache_init(&cache, &decoder, renderer, 0))
+        return;
+
+    // Room for two textures and no decoded copies.
+    asset_cache_set_budget(&cache, IMAGE_BYTES * 2, 0);
+
+    Asset* a = asset_cache_load(&cache, "a.bmp");
+    Asset* b = asset_cache_load(&cache, "b.bmp");
+    Asset* c = asset_cache_load(&cache, "c.bmp");
+    asset_cache_update(&cache);
+
+    // Referenced textures are never evicted, even over budget.
+    TEST_CHECK(cache.vram_used == IMAGE_BYTES * 3);
+    TEST_CHECK(cache.ram_used == 0);
+    TEST_CHECK(asset_get_texture(a) != NULL && asset_get_texture(b) != NULL && asset_get_texture(c) != NULL);
+
+    asset_cache_release(&cache, a);
+    asset_cache_release(&cache, b);
+    asset_cache_release(&cache, c);
+    asset_cache_update(&cache);
+
+    // a is the least recently used, and without a decoded copy it's dropped entirely.
+    TEST_CHECK(cache.vram_used == IMAGE_BYTES * 2);
+    TEST_CHECK(cache.asset_count == 2);
+
+    Asset* reloaded = asset_cache_load(&cache, "a.bmp");
+    TEST_CHECK(asset_get_state(reloaded) == ASSET_LOADING);
+    asset_cache_update(&cache);
+    TEST_CHECK(asset_get_state(reloaded) == ASSET_READY);
+    TEST_CHECK(SDL_AtomicGet(&decoder.decodes) == 4);
+
+    // b is now the least recently used.
+    TEST_CHECK(cache.vram_used == IMAGE_BYTES * 2);
+    TEST_CHECK(cache.asset_count == 2);
+
+    asset_cache_free_resources(&cache);
+}
+
+static void test_ram_eviction(SDL_Renderer* renderer) {
+    AssetCache cache;
+    TestDecoder decoder;
+    if(!test_cache_init(&cache, &decoder, renderer, 0))
+        return;
+
+    // Every texture fits, but only one decoded copy does.
+    asset_cache_set_budget(&cache, SIZE_MAX, IMAGE_BYTES);
+
+    Asset* a = asset_cache_load(&cache, "a.bmp");
+    Asset* b = asset_cache_load(&cache, "b.bmp");
+    asset_cache_update(&cache);
+
+    TEST_CHECK(cache.ram_used == IMAGE_BYTES);
+    TEST_CHECK(a->surface == NULL && b->surface != NULL);
+    TEST_CHECK(asset_get_texture(a) != NULL && asset_get_texture(b) != NULL);
+
+    asset_cache_free_resources(&cache);
+}
+
+static void test_restore_from_ram(SDL_Renderer* renderer) {
+    AssetCache cache;
+    TestDecoder decoder;
+    if(!test_cache_init(&cache, &decoder, renderer, 0))
+        return;
+
+    // Room for one texture, and every decoded copy.
+    asset_cache_set_budget(&cache, IMAGE_BYTES, SIZE_MAX);
+
+    Asset* a = asset_cache_load(&cache, "a.bmp");
+    Asset* b = asset_cache_load(&cache, "b.bmp");
+    asset_cache_update(&cache);
+
+    asset_cache_release(&cache, a);
+    asset_cache_update(&cache);
+
+    // The texture of a is evicted, but its decoded copy is kept.
+    TEST_CHECK(asset_get_texture(a) == NULL);
+    TEST_CHECK(a->surface != NULL);
+    TEST_CHECK(cache.vram_used == IMAGE_BYTES);
+    TEST_CHECK(cache.asset_count == 2);
+
+    // Loading it again restores the texture right away, without decoding.
+    TEST_CHECK(asset_cache_load(&cache, "a.bmp") == a);
+    TEST_CHECK(asset_get_state(a) == ASSET_READY);
+    TEST_CHECK(asset_get_texture(a) != NULL);
+    TEST_CHECK(SDL_AtomicGet(&decoder.decodes) == 2);
+
+    asset_cache_release(&cache, a);
+    asset_cache_release(&cache, b);
+    asset_cache_free_resources(&cache);
+}
+
+static void test_failed_retry(SDL_Renderer* renderer) {
+    AssetCache cache;
+    TestDecoder decoder;
+    if(!test_cache_init(&cache, &decoder, renderer, 0))
+        return;
+
+    decoder.fail_missing = SDL_TRUE;
+
+    Asset* asset = asset_cache_load(&cache, "missing.bmp");
+    asset_cache_update(&cache);
+    TEST_CHECK(asset_get_state(asset) == ASSET_FAILED);
+    TEST_CHECK(asset_get_texture(asset) == NULL);
+
+    // While it's referenced, loading it again gives the same failed asset.
+    TEST_CHECK(asset_cache_load(&cache, "missing.bmp") == asset);
+    TEST_CHECK(SDL_AtomicGet(&decoder.decodes) == 1);
+
+    asset_cache_release(&cache, asset);
+    asset_cache_release(&cache, asset);
+    TEST_CHECK(cache.asset_count == 0);
+
+    // Once released, the next load tries again.
+    decoder.fail_missing = SDL_FALSE;
+    asset = asset_cache_load(&cache, "missing.bmp");
+    asset_cache_update(&cache);
+    TEST_CHECK(asset_get_state(asset) == ASSET_READY);
+    TEST_CHECK(SDL_AtomicGet(&decoder.decodes) == 2);
+
+    asset_cache_free_resources(&cache);
+}
+
+static void test_workers(SDL_Renderer* renderer) {
+    AssetCache cache;
+    TestDecoder decoder;
+    if(!test_cache_init(&cache, &decoder, renderer, 4))
+        return;
+
+    Asset* assets[100];
+    char path[32];
+    for(int i = 0; i < 100; i++) {
+        SDL_snprintf(path, sizeof(path), "image%d.bmp", i);
+        assets[i] = asset_cache_load(&cache, path);
+    }
+
+    // The bucket array grows past 64 assets.
+    TEST_CHECK(cache.asset_count == 100);
+
+    asset_cache_finish(&cache);
+    TEST_CHECK(cache.loading == 0);
+    TEST_CHECK(SDL_AtomicGet(&decoder.decodes) == 100);
+
+    for(int i = 0; i < 100; i++)
+        TEST_CHECK(asset_get_state(assets[i]) == ASSET_READY);
+
+    asset_cache_free_resources(&cache);
+}
+
+int main(int argc, char** argv) {
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target != NULL ? SDL_CreateSoftwareRenderer(target) : NULL;
+    if(renderer == NULL) {
+        fprintf(stderr, "assets: could not create a software renderer: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    test_cache_hit(renderer);
+    test_vram_eviction(renderer);
+    test_ram_eviction(renderer);
+    test_restore_from_ram(renderer);
+    test_failed_retry(renderer);
+    test_workers(renderer);
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    return test_result("assets");
+}
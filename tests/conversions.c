@@ -0,0 +1,109 @@
+/*
+    Checks floor_to_int, ceil_to_int, round_to_int and trunc_to_int, and their
+    batch versions, against libm for every float in their documented valid
+    range, [-2147483648, 2147483520].
+
+    usage: test_conversions [stride]
+
+    A stride above 1 only checks every nth float, for quicker runs.
+*/
+
+#include "test.h"
+
+#include <stdlib.h>
+
+#include <su_math.h>
+
+#define CHUNK 4096
+
+// The bits of the largest float whose floor fits in an int, 2147483520.
+#define MAX_POSITIVE_BITS 0x4EFFFFFFu
+
+// The bits of -2147483648.
+#define MAX_NEGATIVE_BITS 0xCF000000u
+
+static float values[CHUNK];
+static int floors[CHUNK];
+static int ceils[CHUNK];
+static int rounds[CHUNK];
+static int truncs[CHUNK];
+
+static float float_from_bits(Uint32 bits) {
+    float value;
+    SDL_memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static SDL_bool check_chunk(int count) {
+    floor_to_int_batch(values, floors, count);
+    ceil_to_int_batch(values, ceils, count);
+    round_to_int_batch(values, rounds, count);
+    trunc_to_int_batch(values, truncs, count);
+
+    for(int i = 0; i < count; i++) {
+        float value = values[i];
+        int floor_expected = (int)floorf(value);
+        int ceil_expected = (int)ceilf(value);
+        int round_expected = (int)roundf(value);
+        int trunc_expected = (int)truncf(value);
+
+        if(floor_to_int(value) != floor_expected || floors[i] != floor_expected) {
+            TEST_FAIL("floor of %.9g is %d (batch %d), expected %d", value, floor_to_int(value), floors[i], floor_expected);
+            return SDL_FALSE;
+        }
+
+        if(ceil_to_int(value) != ceil_expected || ceils[i] != ceil_expected) {
+            TEST_FAIL("ceil of %.9g is %d (batch %d), expected %d", value, ceil_to_int(value), ceils[i], ceil_expected);
+            return SDL_FALSE;
+        }
+
+        if(round_to_int(value) != round_expected || rounds[i] != round_expected) {
+            TEST_FAIL("round of %.9g is %d (batch %d), expected %d", value, round_to_int(value), rounds[i], round_expected);
+            return SDL_FALSE;
+        }
+
+        if(trunc_to_int(value) != trunc_expected || truncs[i] != trunc_expected) {
+            TEST_FAIL("trunc of %.9g is %d (batch %d), expected %d", value, trunc_to_int(value), truncs[i], trunc_expected);
+            return SDL_FALSE;
+        }
+    }
+
+    return SDL_TRUE;
+}
+
+// Checks every float whose bits are in [first, last], going up by stride.
+static void check_range(Uint32 first, Uint32 last, Uint32 stride) {
+    int count = 0;
+
+    for(Uint64 bits = first; bits <= last; bits += stride) {
+        values[count++] = float_from_bits((Uint32)bits);
+        if(count == CHUNK) {
+            if(!check_chunk(count))
+                return;
+            count = 0;
+        }
+    }
+
+    check_chunk(count);
+}
+
+int main(int argc, char** argv) {
+    Uint32 stride = argc > 1 ? (Uint32)strtoul(argv[1], NULL, 10) : 1;
+    if(stride == 0)
+        stride = 1;
+
+    // Positive floats from 0 up, then negative floats from -0 down.
+    check_range(0, MAX_POSITIVE_BITS, stride);
+    check_range(0x80000000u, MAX_NEGATIVE_BITS, stride);
+
+    // Both ends of the range, in case the stride skipped them.
+    values[0] = float_from_bits(MAX_POSITIVE_BITS);
+    values[1] = float_from_bits(MAX_NEGATIVE_BITS);
+    values[2] = 0.5f;
+    values[3] = -0.5f;
+    values[4] = 0.49999997f;
+    values[5] = -2.5f;
+    check_chunk(6);
+
+    return test_result("conversions");
+}
@@ -0,0 +1,154 @@
+/*
+    Checks the Q16.16 fixed-point math of su_math.h.
+
+    Fixed-point math only uses integer operations, so a simulation built on it
+    has to give bit-identical results on every compiler and CPU. The simulation
+    here is hashed and compared with a hash recorded when it was written; a
+    mismatch means a change made fixed-point results differ between builds.
+*/
+
+#include "test.h"
+
+#include <su_math.h>
+
+#define BODY_COUNT 256
+#define STEP_COUNT 1000
+
+// The hash of the simulation state after STEP_COUNT steps.
+#define SIMULATION_HASH 0x6a7e1603u
+
+static void test_arithmetic(void) {
+    TEST_CHECK(fixed_from_int(3) == 3 * FIXED_ONE);
+    TEST_CHECK(fixed_from_int(40000) == FIXED_MAX);
+    TEST_CHECK(fixed_from_int(-40000) == FIXED_MIN);
+    TEST_CHECK(fixed_to_int(-FIXED_HALF) == -1);
+    TEST_CHECK(fixed_to_int(FIXED_ONE + FIXED_HALF) == 1);
+
+    TEST_CHECK(fixed_add(FIXED_MAX, FIXED_ONE) == FIXED_MAX);
+    TEST_CHECK(fixed_subtract(FIXED_MIN, FIXED_ONE) == FIXED_MIN);
+    TEST_CHECK(fixed_multiply(fixed_from_int(3), FIXED_HALF) == FIXED_ONE + FIXED_HALF);
+    TEST_CHECK(fixed_multiply(fixed_from_int(30000), fixed_from_int(30000)) == FIXED_MAX);
+    TEST_CHECK(fixed_multiply(fixed_from_int(-30000), fixed_from_int(30000)) == FIXED_MIN);
+    TEST_CHECK(fixed_divide(FIXED_ONE, fixed_from_int(4)) == FIXED_ONE / 4);
+    TEST_CHECK(fixed_divide(fixed_from_int(-7), fixed_from_int(2)) == -(fixed_from_int(7) / 2));
+    TEST_CHECK(fixed_divide(FIXED_ONE, 0) == FIXED_MAX);
+    TEST_CHECK(fixed_divide(-FIXED_ONE, 0) == FIXED_MIN);
+    TEST_CHECK(fixed_negate(FIXED_MIN) == FIXED_MAX);
+    TEST_CHECK(fixed_abs(FIXED_MIN) == FIXED_MAX);
+    TEST_CHECK(fixed_lerp(0, fixed_from_int(10), FIXED_HALF) == fixed_from_int(5));
+
+    FixedVector2 vector = fixed_vector2_from_point((Point){ 3, -4 });
+    TEST_CHECK(fixed_vector2_length(vector) == fixed_from_int(5));
+
+    Point point = fixed_vector2_to_point((FixedVector2){ -FIXED_HALF, FIXED_ONE + FIXED_HALF });
+    TEST_CHECK(point.x == -1 && point.y == 1);
+}
+
+static void test_accuracy(void) {
+    for(Sint64 raw = 0; raw <= FIXED_MAX; raw += 4099) {
+        double expected = sqrt((double)raw / FIXED_ONE);
+        double actual = fixed_to_float(fixed_sqrt((Fixed)raw));
+        if(fabs(actual - expected) > 1.0 / FIXED_ONE) {
+            TEST_FAIL("fixed_sqrt(%.9g) is %.9g, expected %.9g", (double)raw / FIXED_ONE, actual, expected);
+            break;
+        }
+    }
+    TEST_CHECK(fixed_sqrt(-FIXED_ONE) == 0);
+
+    // The angle itself is rounded to 1/65536 of a radian, which adds to the documented error.
+    double trig_tolerance = 1.0 / 20000 + 1.0 / FIXED_ONE;
+    for(Fixed radians = -4 * FIXED_PI; radians <= 4 * FIXED_PI; radians += 97) {
+        double angle = (double)radians / FIXED_ONE;
+        double sin_error = fabs(fixed_to_float(fixed_sin(radians)) - sin(angle));
+        double cos_error = fabs(fixed_to_float(fixed_cos(radians)) - cos(angle));
+        if(sin_error > trig_tolerance || cos_error > trig_tolerance) {
+            TEST_FAIL("fixed_sin/fixed_cos(%.9g) are off by %.9g and %.9g", angle, sin_error, cos_error);
+            break;
+        }
+    }
+
+    for(int i = 0; i < 4096; i++) {
+        double angle = i * (2 * 3.14159265358979 / 4096) - 3.14159265358979;
+        double length = 1 + (i % 37) * 13.5;
+        Fixed x = (Fixed)lround(cos(angle) * length * FIXED_ONE);
+        Fixed y = (Fixed)lround(sin(angle) * length * FIXED_ONE);
+        double expected = atan2((double)y, (double)x);
+        double actual = fixed_to_float(fixed_atan2(y, x));
+        if(fabs(actual - expected) > 1.0 / 5000) {
+            TEST_FAIL("fixed_atan2(%d, %d) is %.9g, expected %.9g", y, x, actual, expected);
+            break;
+        }
+    }
+    TEST_CHECK(fixed_atan2(0, 0) == 0);
+}
+
+static Uint32 hash_fixed(Uint32 hash, Fixed value) {
+    Uint32 bits = (Uint32)value;
+    for(int i = 0; i < 4; i++) {
+        hash ^= (bits >> (i * 8)) & 0xFF;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Moves bodies around a box, turning and bouncing off its walls, using only fixed-point math.
+static Uint32 run_simulation(void) {
+    FixedVector2 positions[BODY_COUNT];
+    FixedVector2 velocities[BODY_COUNT];
+    Fixed bound = fixed_from_int(1000);
+    Fixed delta = fixed_divide(FIXED_ONE, fixed_from_int(60));
+    Fixed turn = fixed_divide(FIXED_PI, fixed_from_int(180));
+
+    for(int i = 0; i < BODY_COUNT; i++) {
+        positions[i] = fixed_vector2_from_point((Point){ (i * 37) % 1000, (i * 91) % 1000 });
+        velocities[i] = fixed_vector2_scale(
+            fixed_vector2_rotate((FixedVector2){ FIXED_ONE, 0 }, fixed_multiply(turn, fixed_from_int(i * 7))),
+            fixed_from_int(50 + i % 100));
+    }
+
+    for(int step = 0; step < STEP_COUNT; step++) {
+        for(int i = 0; i < BODY_COUNT; i++) {
+            FixedVector2 velocity = fixed_vector2_rotate(velocities[i], i % 2 == 0 ? turn : -turn);
+            Fixed speed = fixed_vector2_length(velocity);
+            velocity = fixed_vector2_scale(fixed_vector2_normalize(velocity), speed);
+
+            FixedVector2 position = fixed_vector2_add(positions[i], fixed_vector2_scale(velocity, delta));
+            if(position.x < 0 || position.x > bound)
+                velocity.x = fixed_negate(velocity.x);
+            if(position.y < 0 || position.y > bound)
+                velocity.y = fixed_negate(velocity.y);
+
+            Fixed heading = fixed_atan2(velocity.y, velocity.x);
+            position.x = fixed_add(position.x, fixed_multiply(fixed_cos(heading), FIXED_HALF));
+            position.y = fixed_add(position.y, fixed_multiply(fixed_sin(heading), FIXED_HALF));
+
+            positions[i] = position;
+            velocities[i] = velocity;
+        }
+    }
+
+    Uint32 hash = 2166136261u;
+    for(int i = 0; i < BODY_COUNT; i++) {
+        hash = hash_fixed(hash, positions[i].x);
+        hash = hash_fixed(hash, positions[i].y);
+        hash = hash_fixed(hash, velocities[i].x);
+        hash = hash_fixed(hash, velocities[i].y);
+    }
+
+    return hash;
+}
+
+static void test_determinism(void) {
+    Uint32 hash = run_simulation();
+    if(hash != SIMULATION_HASH)
+        TEST_FAIL("the simulation hash is 0x%08x, expected 0x%08x", (unsigned)hash, (unsigned)SIMULATION_HASH);
+
+    TEST_CHECK(run_simulation() == hash);
+}
+
+int main(int argc, char** argv) {
+    test_arithmetic();
+    test_accuracy();
+    test_determinism();
+    return test_result("fixed");
+}
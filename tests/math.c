@@ -0,0 +1,158 @@
+/*
+    Checks the Vector2 functions and the SoA batch kernels of su_math.h against
+    double precision references. The arrays are a size that isn't a multiple of
+    the SIMD width, so both the vector loop and the scalar tail are covered.
+*/
+
+#include "test.h"
+
+#include <su_math.h>
+#include <su_random.h>
+
+#define COUNT 1027
+#define TOLERANCE 1e-5
+
+static float ax[COUNT], ay[COUNT], bx[COUNT], by[COUNT], result[COUNT];
+static float x[COUNT], y[COUNT];
+
+static void fill(Random* random, float* values, float min, float max) {
+    for(int i = 0; i < COUNT; i++)
+        values[i] = random_range_float(random, min, max);
+}
+
+static void reset(void) {
+    SDL_memcpy(x, ax, sizeof(x));
+    SDL_memcpy(y, ay, sizeof(y));
+}
+
+#define CHECK_ARRAY(actual, expected, tolerance, kernel) \
+    for(int i = 0; i < COUNT; i++) { \
+        double e = (expected); \
+        if(!test_near((actual)[i], e, (tolerance))) { \
+            TEST_FAIL("%s: index %d is %.9g, expected %.9g", kernel, i, (double)(actual)[i], e); \
+            break; \
+        } \
+    }
+
+static void test_vector2(void) {
+    Vector2 a = { 3, 4 };
+    Vector2 b = { -1, 2 };
+
+    Vector2 sum = vector2_add(a, b);
+    TEST_CHECK(sum.x == 2 && sum.y == 6);
+
+    Vector2 difference = vector2_subtract(a, b);
+    TEST_CHECK(difference.x == 4 && difference.y == 2);
+
+    TEST_CHECK(vector2_dot(a, b) == 5);
+    TEST_CHECK(vector2_cross(a, b) == 10);
+    TEST_CHECK(vector2_length(a) == 5);
+    TEST_CHECK(vector2_distance_squared(a, b) == 20);
+
+    Vector2 normal = vector2_normalize(a);
+    TEST_CHECK(test_near(normal.x, 0.6, TOLERANCE) && test_near(normal.y, 0.8, TOLERANCE));
+
+    Vector2 zero = vector2_normalize((Vector2){ 0, 0 });
+    TEST_CHECK(zero.x == 0 && zero.y == 0);
+
+    Vector2 half = vector2_lerp(a, b, 0.5f);
+    TEST_CHECK(half.x == 1 && half.y == 3);
+
+    Vector2 rotated = vector2_rotate((Vector2){ 1, 0 }, 1.57079633f);
+    TEST_CHECK(test_near(rotated.x, 0, TOLERANCE) && test_near(rotated.y, 1, TOLERANCE));
+
+    Point point = vector2_to_point((Vector2){ 2.75f, -2.75f });
+    TEST_CHECK(point.x == 2 && point.y == -2);
+}
+
+static void test_batch(void) {
+    Random random;
+    random_seed(&random, 31);
+
+    fill(&random, ax, -1000, 1000);
+    fill(&random, ay, -1000, 1000);
+    fill(&random, bx, -10, 10);
+    fill(&random, by, -10, 10);
+
+    // Zero vectors inside the vector loop and in the tail.
+    ax[5] = ay[5] = 0;
+    ax[COUNT - 1] = ay[COUNT - 1] = 0;
+
+    reset();
+    vector2_batch_add(x, y, bx, by, COUNT);
+    CHECK_ARRAY(x, (double)ax[i] + bx[i], TOLERANCE, "vector2_batch_add x");
+    CHECK_ARRAY(y, (double)ay[i] + by[i], TOLERANCE, "vector2_batch_add y");
+
+    reset();
+    vector2_batch_add_scaled(x, y, bx, by, 0.25f, COUNT);
+    CHECK_ARRAY(x, ax[i] + bx[i] * 0.25, TOLERANCE, "vector2_batch_add_scaled x");
+    CHECK_ARRAY(y, ay[i] + by[i] * 0.25, TOLERANCE, "vector2_batch_add_scaled y");
+
+    reset();
+    vector2_batch_scale(x, y, -3.5f, COUNT);
+    CHECK_ARRAY(x, ax[i] * -3.5, TOLERANCE, "vector2_batch_scale x");
+    CHECK_ARRAY(y, ay[i] * -3.5, TOLERANCE, "vector2_batch_scale y");
+
+    vector2_batch_dot(ax, ay, bx, by, result, COUNT);
+    CHECK_ARRAY(result, (double)ax[i] * bx[i] + (double)ay[i] * by[i], 1e-3, "vector2_batch_dot");
+
+    vector2_batch_length(ax, ay, result, COUNT);
+    CHECK_ARRAY(result, sqrt((double)ax[i] * ax[i] + (double)ay[i] * ay[i]), TOLERANCE, "vector2_batch_length");
+
+    reset();
+    vector2_batch_normalize(x, y, COUNT);
+    for(int i = 0; i < COUNT; i++) {
+        double length = sqrt((double)ax[i] * ax[i] + (double)ay[i] * ay[i]);
+        double ex = length == 0 ? 0 : ax[i] / length;
+        double ey = length == 0 ? 0 : ay[i] / length;
+        if(!test_near(x[i], ex, TOLERANCE) || !test_near(y[i], ey, TOLERANCE)) {
+            TEST_FAIL("vector2_batch_normalize: index %d is (%.9g, %.9g), expected (%.9g, %.9g)", i, x[i], y[i], ex, ey);
+            break;
+        }
+    }
+
+    reset();
+    vector2_batch_clamp_length(x, y, 500, COUNT);
+    for(int i = 0; i < COUNT; i++) {
+        double length = sqrt((double)ax[i] * ax[i] + (double)ay[i] * ay[i]);
+        double scale = length > 500 ? 500 / length : 1;
+        if(!test_near(x[i], ax[i] * scale, TOLERANCE) || !test_near(y[i], ay[i] * scale, TOLERANCE)) {
+            TEST_FAIL("vector2_batch_clamp_length: index %d is (%.9g, %.9g), expected (%.9g, %.9g)", i, x[i], y[i], ax[i] * scale, ay[i] * scale);
+            break;
+        }
+    }
+
+    reset();
+    vector2_batch_lerp(x, y, bx, by, 0.75f, COUNT);
+    CHECK_ARRAY(x, ax[i] + (bx[i] - (double)ax[i]) * 0.75, TOLERANCE, "vector2_batch_lerp x");
+    CHECK_ARRAY(y, ay[i] + (by[i] - (double)ay[i]) * 0.75, TOLERANCE, "vector2_batch_lerp y");
+
+    reset();
+    float radians = 1.2345f;
+    vector2_batch_rotate(x, y, radians, COUNT);
+    for(int i = 0; i < COUNT; i++) {
+        double c = cos(radians);
+        double s = sin(radians);
+        double ex = ax[i] * c - ay[i] * s;
+        double ey = ax[i] * s + ay[i] * c;
+
+        // The error of a rotation grows with the length of the vector, not the size of each component.
+        double tolerance = 1e-5 * SDL_max(1.0, sqrt((double)ax[i] * ax[i] + (double)ay[i] * ay[i]));
+        if(fabs(x[i] - ex) > tolerance || fabs(y[i] - ey) > tolerance) {
+            TEST_FAIL("vector2_batch_rotate: index %d is (%.9g, %.9g), expected (%.9g, %.9g)", i, x[i], y[i], ex, ey);
+            break;
+        }
+    }
+
+    // Every kernel has to leave the elements past count alone.
+    reset();
+    x[10] = 12345;
+    vector2_batch_scale(x, y, 2, 10);
+    TEST_CHECK(x[10] == 12345);
+}
+
+int main(int argc, char** argv) {
+    test_vector2();
+    test_batch();
+    return test_result("math");
+}
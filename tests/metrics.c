@@ -0,0 +1,74 @@
+/*
+    Checks the metrics registry, including counters and histograms updated
+    from several threads at once.
+*/
+
+#include "test.h"
+
+#include <su_metrics.h>
+
+#define THREAD_COUNT 4
+#define THREAD_UPDATES 50000
+
+static MetricId counter;
+static MetricId histogram;
+
+static int update_from_thread(void* data) {
+    for(int i = 0; i < THREAD_UPDATES; i++) {
+        metrics_add(counter, 1);
+        metrics_record(histogram, (double)(i % 4));
+    }
+
+    return 0;
+}
+
+static void test_histogram(void) {
+    MetricId id = metrics_register_histogram("test.histogram", 1);
+    TEST_CHECK(id != METRIC_INVALID);
+    TEST_CHECK(metrics_register("test.histogram", METRIC_HISTOGRAM) == id);
+    TEST_CHECK(metrics_register("test.histogram", METRIC_COUNTER) == METRIC_INVALID);
+
+    for(int i = 0; i < 100; i++)
+        metrics_record(id, i < 90 ? 0.5 : 3);
+
+    const Metric* metric = metrics_get(id);
+    TEST_CHECK(metric->count == 100);
+    TEST_CHECK(metric->min == 0.5 && metric->max == 3);
+    TEST_CHECK(metric->buckets[0] == 90 && metric->buckets[2] == 10);
+    TEST_CHECK(metrics_percentile(id, 0.5) == 1);
+    TEST_CHECK(metrics_percentile(id, 0.99) == 3);
+}
+
+static void test_threads(void) {
+    counter = metrics_register("test.thread_counter", METRIC_COUNTER);
+    histogram = metrics_register_histogram("test.thread_histogram", 1);
+    TEST_CHECK(counter != METRIC_INVALID && histogram != METRIC_INVALID);
+
+    SDL_Thread* threads[THREAD_COUNT];
+    for(int i = 0; i < THREAD_COUNT; i++)
+        threads[i] = SDL_CreateThread(update_from_thread, "metrics", NULL);
+
+    for(int i = 0; i < THREAD_COUNT; i++)
+        SDL_WaitThread(threads[i], NULL);
+
+    Uint64 expected = (Uint64)THREAD_COUNT * THREAD_UPDATES;
+    const Metric* metric = metrics_get(histogram);
+    TEST_CHECK(metrics_get(counter)->count == expected);
+    TEST_CHECK(metric->count == expected);
+    TEST_CHECK(metric->value == (double)expected * 1.5);
+
+    Uint64 bucketed = 0;
+    for(int i = 0; i < METRIC_HISTOGRAM_BUCKETS; i++)
+        bucketed += metric->buckets[i];
+    TEST_CHECK(bucketed == expected);
+
+    metrics_reset();
+    TEST_CHECK(metrics_get(counter)->count == 0 && metrics_get(histogram)->count == 0);
+}
+
+int main(int argc, char** argv) {
+    test_histogram();
+    test_threads();
+    metrics_quit();
+    return test_result("metrics");
+}
@@ -0,0 +1,77 @@
+/*
+    Checks the ranges and the generator usage of the random fill functions.
+*/
+
+#include "test.h"
+
+#include <su_random.h>
+
+#define COUNT 4096
+
+static void test_fill_int(void) {
+    static int values[COUNT];
+    Random random;
+    Random reference;
+    random_seed(&random, 35);
+    random_seed(&reference, 35);
+
+    // A power of two span never rejects, so every output gives two values.
+    random_fill_int(&random, values, COUNT, -8, 7);
+    for(int i = 0; i < COUNT / 2; i++)
+        random_next(&reference);
+    TEST_CHECK(random_next(&random) == random_next(&reference));
+
+    int seen[16] = { 0 };
+    for(int i = 0; i < COUNT; i++) {
+        if(values[i] < -8 || values[i] > 7) {
+            TEST_FAIL("random_fill_int gave %d, outside of [-8, 7]", values[i]);
+            return;
+        }
+        seen[values[i] + 8]++;
+    }
+
+    for(int i = 0; i < 16; i++)
+        TEST_CHECK(seen[i] > COUNT / 32);
+
+    random_fill_int(&random, values, COUNT, 5, 5);
+    for(int i = 0; i < COUNT; i++)
+        TEST_CHECK(values[i] == 5);
+}
+
+static void test_fill_float(void) {
+    static float values[COUNT];
+    Random random;
+    random_seed(&random, 35);
+
+    // The range is a single float wide, so about half of the scaled values round up to max.
+    float min = 1.0f;
+    float max = 1.00000012f;
+    random_fill_float(&random, values, COUNT, min, max);
+    for(int i = 0; i < COUNT; i++) {
+        if(values[i] != min) {
+            TEST_FAIL("random_fill_float gave %.9g, outside of [%.9g, %.9g)", values[i], min, max);
+            break;
+        }
+    }
+
+    for(int i = 0; i < COUNT; i++)
+        TEST_CHECK(random_range_float(&random, min, max) == min);
+
+    random_fill_float(&random, values, COUNT, -10, 10);
+    for(int i = 0; i < COUNT; i++) {
+        if(values[i] < -10 || values[i] >= 10) {
+            TEST_FAIL("random_fill_float gave %.9g, outside of [-10, 10)", values[i]);
+            break;
+        }
+    }
+
+    random_fill_float(&random, values, COUNT, -1, 0);
+    for(int i = 0; i < COUNT; i++)
+        TEST_CHECK(values[i] >= -1 && values[i] < 0);
+}
+
+int main(int argc, char** argv) {
+    test_fill_int();
+    test_fill_float();
+    return test_result("random");
+}
@@ -0,0 +1,116 @@
+/*
+    Checks that scene pools keep track of the scenes they hand out and
+    what they reset when a scene goes back to them, and that headless scenes
+    reset their frame arena.
+*/
+
+#include "test.h"
+
+#include <su_scene.h>
+
+static int created = 0;
+
+static Scene* create_scene(void* data) {
+    Scene* scene = scene_create((EcsWorld){0}, NULL, NULL, NULL, NULL, SDL_FALSE, SDL_FALSE);
+    if(scene != NULL) {
+        scene->free_world = SDL_FALSE;
+        created++;
+    }
+    return scene;
+}
+
+static void test_reuse(void) {
+    ScenePool* pool = scene_pool_create(create_scene, NULL, NULL);
+    created = 0;
+
+    Scene* scene = scene_pool_acquire(pool);
+    TEST_CHECK(scene != NULL && scene->pool == pool);
+    TEST_CHECK(pool->acquired_count == 1);
+
+    scene_push(scene);
+    scene_pop(true);
+    TEST_CHECK(scene_pool_get_count(pool) == 1);
+    TEST_CHECK(pool->acquired_count == 0);
+
+    TEST_CHECK(scene_pool_acquire(pool) == scene);
+    TEST_CHECK(created == 1);
+
+    scene_free(scene);
+    TEST_CHECK(pool->acquired_count == 0);
+
+    scene_pool_free(pool);
+}
+
+static void test_free_detaches_acquired(void) {
+    ScenePool* pool = scene_pool_create(create_scene, NULL, NULL);
+
+    // Neither scene is on the stack when the pool is freed.
+    Scene* pushed_later = scene_pool_acquire(pool);
+    Scene* freed_later = scene_pool_acquire(pool);
+    scene_pool_free(pool);
+
+    TEST_CHECK(pushed_later->pool == NULL);
+    TEST_CHECK(freed_later->pool == NULL);
+
+    scene_push(pushed_later);
+    TEST_CHECK(scene_pop(false) == pushed_later);
+    scene_push(pushed_later);
+    scene_pop(true);
+
+    scene_free(freed_later);
+}
+
+static void test_seed_kept(void) {
+    ScenePool* pool = scene_pool_create(create_scene, NULL, NULL);
+
+    Scene* scene = scene_pool_acquire(pool);
+    scene_seed_random(scene, 48);
+    Uint64 first = random_next(scene_get_random(scene));
+    random_next(scene_get_random(scene));
+
+    scene_pool_release(pool, scene);
+    scene = scene_pool_acquire(pool);
+    TEST_CHECK(random_next(scene_get_random(scene)) == first);
+
+    scene_pool_release(pool, scene);
+    scene_pool_free(pool);
+}
+
+static void test_headless_frame_arena(void) {
+    FrameArena arena;
+    TEST_CHECK(frame_arena_init(&arena, NULL, 256));
+
+    Scene* scene = create_scene(NULL);
+    scene_set_frame_arena(scene, &arena);
+
+    // Every update leaves room for another frame, whichever way the scene is stepped.
+    for(int i = 0; i < 8; i++) {
+        TEST_CHECK(frame_arena_alloc(&arena, 192) != NULL);
+        scene_update(scene, 1 / 60.0f);
+        TEST_CHECK(arena.offset == 0);
+
+        TEST_CHECK(frame_arena_alloc(&arena, 192) != NULL);
+        scene_update_fixed(scene, 1 / 60.0f, 16);
+        TEST_CHECK(arena.offset == 0);
+    }
+
+    SceneBatch batch;
+    scene_batch_init(&batch, NULL);
+    TEST_CHECK(scene_batch_add(&batch, scene));
+
+    TEST_CHECK(frame_arena_alloc(&arena, 192) != NULL);
+    scene_batch_run(&batch, 1 / 60.0f, 16, 4);
+    TEST_CHECK(arena.offset == 0);
+
+    scene_batch_free_resources(&batch);
+    scene_free(scene);
+    frame_arena_free_resources(&arena);
+}
+
+int main(int argc, char** argv) {
+    test_reuse();
+    test_free_detaches_acquired();
+    test_seed_kept();
+    test_headless_frame_arena();
+    return test_result("scene");
+}
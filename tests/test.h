@@ -0,0 +1,61 @@
+#ifndef SDL_UTILS_TEST_H
+#define SDL_UTILS_TEST_H
+
+/*
+    Helpers shared by the tests run with meson test.
+
+    Every failed check is printed to stderr and counted. A test passes
+    when it returns test_result without any failed checks.
+*/
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include <math.h>
+#include <stdio.h>
+
+static int test_failures = 0;
+
+/**
+    Fails the test with a message if a condition is false.
+*/
+#define TEST_CHECK(condition) \
+    do { \
+        if(!(condition)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            test_failures++; \
+        } \
+    } while(0)
+
+/**
+    Fails the test with a formatted message.
+*/
+#define TEST_FAIL(...) \
+    do { \
+        fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        test_failures++; \
+    } while(0)
+
+/**
+    Determines if a value is within a tolerance of the expected value,
+    either absolutely or relative to the size of the expected value.
+*/
+static inline SDL_bool test_near(double actual, double expected, double tolerance) {
+    double difference = fabs(actual - expected);
+    return difference <= tolerance || difference <= tolerance * fabs(expected);
+}
+
+/**
+    Gets the exit code of a test and prints a summary of the failed checks.
+*/
+static inline int test_result(const char* name) {
+    if(test_failures == 0)
+        return 0;
+
+    fprintf(stderr, "%s: %d checks failed\n", name, test_failures);
+    return 1;
+}
+
+#endif
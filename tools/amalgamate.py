@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""
+Combines the public headers and the sources of SDL_utils into a single header.
+
+Including the output declares the whole library. Defining SDL_UTILS_IMPLEMENTATION
+in exactly one translation unit before including it also compiles the library
+into that translation unit, which lets the compiler inline calls into the library
+(such as the scene, collision and tilemap functions) from the code around them.
+
+usage: amalgamate.py <output> <inputs...>
+"""
+
+import os
+import re
+import sys
+
+INCLUDE = re.compile(r'^\s*#\s*include\s*[<"](su_[a-z0-9_]+\.h)[>"]\s*$')
+
+
+def read(path):
+    with open(path, 'r', encoding='utf-8') as f:
+        return f.read().splitlines()
+
+
+def main():
+    output = sys.argv[1]
+    inputs = sys.argv[2:]
+
+    headers = {}
+    sources = []
+    for path in inputs:
+        name = os.path.basename(path)
+        if name.endswith('.h'):
+            headers[name] = path
+        elif name.endswith('.c'):
+            sources.append(path)
+
+    emitted = set()
+    lines = []
+
+    # Headers are written in dependency order, with the includes between
+    # library headers removed since they're already part of the output.
+    def emit(name, stack=()):
+        if name in emitted:
+            return
+        if name not in headers:
+            raise SystemExit('amalgamate: unknown header ' + name)
+        if name in stack:
+            raise SystemExit('amalgamate: include cycle through ' + name)
+
+        body = read(headers[name])
+        for line in body:
+            match = INCLUDE.match(line)
+            if match:
+                emit(match.group(1), stack + (name,))
+
+        emitted.add(name)
+        lines.append('/* ' + name + ' */')
+        for line in body:
+            if not INCLUDE.match(line):
+                lines.append(line)
+        lines.append('')
+
+    public = sorted(name for name, path in headers.items() if os.path.basename(os.path.dirname(path)) == 'include')
+    private = sorted(name for name in headers if name not in public)
+
+    for name in public:
+        emit(name)
+
+    lines.append('#endif')
+    lines.append('')
+
+    # The implementation sits outside the include guard so it can be
+    # requested after the header was already included for its declarations.
+    lines.append('#if defined(SDL_UTILS_IMPLEMENTATION) && !defined(SDL_UTILS_IMPLEMENTATION_INCLUDED)')
+    lines.append('#define SDL_UTILS_IMPLEMENTATION_INCLUDED')
+    lines.append('')
+
+    for name in private:
+        emit(name)
+
+    for path in sources:
+        lines.append('/* ' + os.path.basename(path) + ' */')
+        for line in read(path):
+            match = INCLUDE.match(line)
+            if match:
+                emit(match.group(1))
+                continue
+            lines.append(line)
+        lines.append('')
+
+    lines.append('#endif')
+
+    with open(output, 'w', encoding='utf-8', newline='\n') as f:
+        f.write('/* Generated by tools/amalgamate.py. Do not edit. */\n')
+        f.write('#ifndef SDL_UTILS_AMALGAMATION_H\n')
+        f.write('#define SDL_UTILS_AMALGAMATION_H\n\n')
+        f.write('\n'.join(lines))
+        f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,90 @@
+/*
+    Packs files into a single pack file that can be read with pack_open.
+
+    usage: su_pack [-c] [-a alignment] <output> <files...>
+
+    -c            Compress the files with LZ4.
+    -a alignment  Align the data of each file to a power of two. Defaults to 16.
+
+    Files are named by the path given on the command line, with backslashes
+    replaced by forward slashes.
+*/
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <su_pack.h>
+
+static void usage(void) {
+    fprintf(stderr, "usage: su_pack [-c] [-a alignment] <output> <files...>\n");
+}
+
+int main(int argc, char** argv) {
+    SDL_bool compress = SDL_FALSE;
+    Uint32 alignment = PACK_DEFAULT_ALIGNMENT;
+    int arg = 1;
+
+    for(; arg < argc && argv[arg][0] == '-'; arg++) {
+        if(SDL_strcmp(argv[arg], "-c") == 0) {
+            compress = SDL_TRUE;
+        } else if(SDL_strcmp(argv[arg], "-a") == 0 && arg + 1 < argc) {
+            alignment = (Uint32)strtoul(argv[++arg], NULL, 10);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    if(argc - arg < 2) {
+        usage();
+        return 1;
+    }
+
+    const char* output = argv[arg++];
+
+    PackWriter writer;
+    pack_writer_init(&writer);
+
+    for(; arg < argc; arg++) {
+        char* name = SDL_strdup(argv[arg]);
+        if(name == NULL) {
+            fprintf(stderr, "su_pack: not enough memory\n");
+            pack_writer_free_resources(&writer);
+            return 1;
+        }
+
+        for(char* c = name; *c != '\0'; c++) {
+            if(*c == '\\')
+                *c = '/';
+        }
+
+        SDL_bool added = pack_writer_add_file(&writer, name, argv[arg], compress);
+        SDL_free(name);
+
+        if(!added) {
+            fprintf(stderr, "su_pack: %s\n", SDL_GetError());
+            pack_writer_free_resources(&writer);
+            return 1;
+        }
+    }
+
+    SDL_RWops* rw = SDL_RWFromFile(output, "wb");
+    if(rw == NULL) {
+        fprintf(stderr, "su_pack: %s\n", SDL_GetError());
+        pack_writer_free_resources(&writer);
+        return 1;
+    }
+
+    SDL_bool saved = pack_writer_save(&writer, rw, alignment);
+    if(!saved)
+        fprintf(stderr, "su_pack: %s\n", SDL_GetError());
+
+    if(SDL_RWclose(rw) != 0)
+        saved = SDL_FALSE;
+
+    pack_writer_free_resources(&writer);
+    return saved ? 0 : 1;
+}